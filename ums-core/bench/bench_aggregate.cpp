@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+extern "C" {
+#include "ums/aggregate.h"
+#include "ums/ums_core.h"
+}
+
+static float g_values[UMS_MAX_CHANNELS];
+static char g_name[] = "bench";
+
+static inline uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void mock_transmit(void *data_ptr, uint16_t length) {
+    benchmark::DoNotOptimize(data_ptr);
+    benchmark::DoNotOptimize(length);
+}
+
+// Accumulate cost of a single channel per tick, per datatype domain
+template <typename T, ums_datatype_t Type>
+static void BM_AggregatorAccumulate(benchmark::State &state) {
+    T value{};
+    ums_aggregator_t agg;
+    ums_aggregator_init(&agg, &value, Type, UMS_AGGREGATE_MAX);
+
+    const uint64_t start = read_cycles();
+    for (auto _ : state) {
+        ums_aggregator_accumulate(&agg);
+        value = static_cast<T>(value + 1);
+        benchmark::ClobberMemory();
+    }
+    state.counters["cycles/tick"] = benchmark::Counter(
+        static_cast<double>(read_cycles() - start), benchmark::Counter::kAvgIterations);
+}
+
+// ums_update() with count channels decimated by 10, plain vs. aggregated
+static void BM_UpdateDecimated(benchmark::State &state) {
+    const auto count = static_cast<uint8_t>(state.range(0));
+    const bool aggregated = state.range(1) != 0;
+    ums_destroy();
+    ums_setup(mock_transmit);
+    for (uint8_t i = 0; i < count; i++) {
+        if (aggregated) {
+            ums_trace_aggregated(&g_values[i], g_name, UMS_FLOAT32, 10, UMS_AGGREGATE_MAX);
+        } else {
+            ums_trace_divided(&g_values[i], g_name, UMS_FLOAT32, 10);
+        }
+    }
+
+    const uint64_t start = read_cycles();
+    for (auto _ : state) {
+        ums_update();
+        ums_transfer_complete_callback();
+    }
+    state.counters["cycles/tick"] = benchmark::Counter(
+        static_cast<double>(read_cycles() - start), benchmark::Counter::kAvgIterations);
+    ums_destroy();
+}
+
+BENCHMARK_TEMPLATE(BM_AggregatorAccumulate, uint16_t, UMS_UINT16);
+BENCHMARK_TEMPLATE(BM_AggregatorAccumulate, int32_t, UMS_INT32);
+BENCHMARK_TEMPLATE(BM_AggregatorAccumulate, float, UMS_FLOAT32);
+BENCHMARK(BM_UpdateDecimated)->ArgsProduct({{1, 4, UMS_MAX_CHANNELS}, {0, 1}});
@@ -0,0 +1,48 @@
+#include <benchmark/benchmark.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+static float g_cobs_vars[UMS_MAX_CHANNELS];
+static char g_name[] = "bench";
+
+static inline uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void mock_transmit(void *data_ptr, uint16_t length) {
+    benchmark::DoNotOptimize(data_ptr);
+    benchmark::DoNotOptimize(length);
+}
+
+// state.range(0) = traced channels, state.range(1) = ums_framing_t
+static void BM_UpdateFraming(benchmark::State &state) {
+    const auto count = static_cast<uint8_t>(state.range(0));
+    ums_destroy();
+    ums_setup(mock_transmit);
+    ums_set_framing(static_cast<ums_framing_t>(state.range(1)));
+    for (uint8_t i = 0; i < count; i++) {
+        g_cobs_vars[i] = (i % 2 == 0) ? 0.0f : 1.5f;    // zero bytes to stuff
+        ums_trace(&g_cobs_vars[i], g_name, UMS_FLOAT32);
+    }
+
+    const uint64_t start = read_cycles();
+    for (auto _ : state) {
+        ums_update();
+        ums_transfer_complete_callback();
+    }
+    state.counters["cycles/sample"] = benchmark::Counter(
+        static_cast<double>(read_cycles() - start), benchmark::Counter::kAvgIterations);
+    ums_destroy();
+}
+
+BENCHMARK(BM_UpdateFraming)->ArgsProduct({{1, 4, UMS_MAX_CHANNELS}, {UMS_FRAMING_NONE, UMS_FRAMING_COBS}});
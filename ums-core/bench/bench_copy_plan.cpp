@@ -0,0 +1,143 @@
+#include <benchmark/benchmark.h>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+extern "C" {
+#include "ums/copy_plan.h"
+#include "ums/triple_buffer.h"
+#include "ums/ums_core.h"
+}
+
+// Traced variables with padding in between, so the plan cannot merge them
+struct ScatteredVar {
+    float value;
+    uint32_t pad;
+};
+
+static ScatteredVar g_scattered[UMS_MAX_CHANNELS];
+static float g_adjacent[UMS_MAX_CHANNELS];
+static char g_name[] = "bench";
+
+// Cycle counter for the "cycles/sample" column, 0 where no cheap counter is available
+static inline uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Reference: the per-channel switch + variable-length memcpy loop the plan replaces
+static void legacy_copy(const data_channel_t *channels, uint8_t count, uint8_t *dst) {
+    uint16_t offset = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t var_size = ums_datatype_size(channels[i].var_type);
+        memcpy(&dst[offset], channels[i].var_ptr, var_size);
+        offset += var_size;
+    }
+}
+
+static void mock_transmit(void *data_ptr, uint16_t length) {
+    benchmark::DoNotOptimize(data_ptr);
+    benchmark::DoNotOptimize(length);
+}
+
+static void BM_LegacyLoop(benchmark::State &state) {
+    const auto count = static_cast<uint8_t>(state.range(0));
+    data_channel_t channels[UMS_MAX_CHANNELS];
+    for (uint8_t i = 0; i < count; i++) {
+        channels[i] = {&g_scattered[i].value, UMS_FLOAT32, g_name, 0, 1, sizeof(float), nullptr};
+    }
+    benchmark::DoNotOptimize(channels);
+    sample_packet_t packet{};
+
+    const uint64_t start = read_cycles();
+    for (auto _ : state) {
+        legacy_copy(channels, count, packet.data);
+        benchmark::ClobberMemory();
+    }
+    state.counters["cycles/sample"] = benchmark::Counter(
+        static_cast<double>(read_cycles() - start), benchmark::Counter::kAvgIterations);
+}
+
+static void BM_CopyPlan(benchmark::State &state) {
+    const auto count = static_cast<uint8_t>(state.range(0));
+    ums_copy_plan_t plan;
+    ums_copy_plan_reset(&plan);
+    for (uint8_t i = 0; i < count; i++) {
+        ums_copy_plan_append(&plan, &g_scattered[i].value, sizeof(float));
+    }
+    sample_packet_t packet{};
+
+    const uint64_t start = read_cycles();
+    for (auto _ : state) {
+        ums_copy_plan_execute(&plan, packet.data);
+        benchmark::ClobberMemory();
+    }
+    state.counters["cycles/sample"] = benchmark::Counter(
+        static_cast<double>(read_cycles() - start), benchmark::Counter::kAvgIterations);
+}
+
+static void BM_CopyPlanAdjacent(benchmark::State &state) {
+    const auto count = static_cast<uint8_t>(state.range(0));
+    ums_copy_plan_t plan;
+    ums_copy_plan_reset(&plan);
+    for (uint8_t i = 0; i < count; i++) {
+        ums_copy_plan_append(&plan, &g_adjacent[i], sizeof(float));
+    }
+    sample_packet_t packet{};
+
+    const uint64_t start = read_cycles();
+    for (auto _ : state) {
+        ums_copy_plan_execute(&plan, packet.data);
+        benchmark::ClobberMemory();
+    }
+    state.counters["cycles/sample"] = benchmark::Counter(
+        static_cast<double>(read_cycles() - start), benchmark::Counter::kAvgIterations);
+    state.counters["ops"] = plan.op_count;
+}
+
+static void BM_Update(benchmark::State &state) {
+    const auto count = static_cast<uint8_t>(state.range(0));
+    ums_destroy();
+    ums_setup(mock_transmit);
+    for (uint8_t i = 0; i < count; i++) {
+        ums_trace(&g_scattered[i].value, g_name, UMS_FLOAT32);
+    }
+
+    const uint64_t start = read_cycles();
+    for (auto _ : state) {
+        ums_update();
+        ums_transfer_complete_callback();
+    }
+    state.counters["cycles/sample"] = benchmark::Counter(
+        static_cast<double>(read_cycles() - start), benchmark::Counter::kAvgIterations);
+    ums_destroy();
+}
+
+// ISR half only: the transmit function is never called, see ums_flush()
+static void BM_Capture(benchmark::State &state) {
+    const auto count = static_cast<uint8_t>(state.range(0));
+    ums_destroy();
+    ums_setup(mock_transmit);
+    for (uint8_t i = 0; i < count; i++) {
+        ums_trace(&g_scattered[i].value, g_name, UMS_FLOAT32);
+    }
+
+    const uint64_t start = read_cycles();
+    for (auto _ : state) {
+        ums_capture();
+    }
+    state.counters["cycles/sample"] = benchmark::Counter(
+        static_cast<double>(read_cycles() - start), benchmark::Counter::kAvgIterations);
+    ums_destroy();
+}
+
+BENCHMARK(BM_LegacyLoop)->Arg(1)->Arg(4)->Arg(UMS_MAX_CHANNELS);
+BENCHMARK(BM_CopyPlan)->Arg(1)->Arg(4)->Arg(UMS_MAX_CHANNELS);
+BENCHMARK(BM_CopyPlanAdjacent)->Arg(1)->Arg(4)->Arg(UMS_MAX_CHANNELS);
+BENCHMARK(BM_Update)->Arg(1)->Arg(4)->Arg(UMS_MAX_CHANNELS);
+BENCHMARK(BM_Capture)->Arg(1)->Arg(4)->Arg(UMS_MAX_CHANNELS);
@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+static float g_crc_vars[UMS_MAX_CHANNELS];
+static char g_name[] = "bench";
+
+static inline uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void mock_transmit(void *data_ptr, uint16_t length) {
+    benchmark::DoNotOptimize(data_ptr);
+    benchmark::DoNotOptimize(length);
+}
+
+// state.range(0) = traced channels, state.range(1) = ums_crc_t
+static void BM_UpdateCrc(benchmark::State &state) {
+    const auto count = static_cast<uint8_t>(state.range(0));
+    ums_destroy();
+    ums_setup(mock_transmit);
+    ums_set_crc(static_cast<ums_crc_t>(state.range(1)));
+    for (uint8_t i = 0; i < count; i++) {
+        g_crc_vars[i] = static_cast<float>(i) * 0.5f;
+        ums_trace(&g_crc_vars[i], g_name, UMS_FLOAT32);
+    }
+
+    const uint64_t start = read_cycles();
+    for (auto _ : state) {
+        ums_update();
+        ums_transfer_complete_callback();
+    }
+    state.counters["cycles/sample"] = benchmark::Counter(
+        static_cast<double>(read_cycles() - start), benchmark::Counter::kAvgIterations);
+    ums_destroy();
+}
+
+BENCHMARK(BM_UpdateCrc)->ArgsProduct({{1, 4, UMS_MAX_CHANNELS}, {UMS_CRC_NONE, UMS_CRC_16, UMS_CRC_32}});
+
+// state.range(0) = frame size in bytes, state.range(1) = ums_crc_t
+static void BM_Crc(benchmark::State &state) {
+    std::vector<uint8_t> frame(static_cast<size_t>(state.range(0)), 0x5A);
+    const auto crc = static_cast<ums_crc_t>(state.range(1));
+
+    const uint64_t start = read_cycles();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ums_crc_compute(crc, frame.data(), static_cast<uint16_t>(frame.size())));
+    }
+    state.counters["cycles/byte"] = benchmark::Counter(
+        static_cast<double>(read_cycles() - start) / static_cast<double>(frame.size()),
+        benchmark::Counter::kAvgIterations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(BM_Crc)->ArgsProduct({{16, 68, UMS_MAX_WIRE_FRAME_SIZE}, {UMS_CRC_16, UMS_CRC_32}});
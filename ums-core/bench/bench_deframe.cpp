@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "ums/host/cobs.h"
+
+// A capture of frame_size byte frames, one in four bytes zero, COBS framed like the device sends them
+static std::vector<uint8_t> make_capture(size_t frame_size, size_t total) {
+    std::vector<uint8_t> capture;
+    std::vector<uint8_t> frame(frame_size + UMS_COBS_OVERHEAD);
+    uint32_t seed = 1;
+    while (capture.size() < total) {
+        for (size_t i = 1; i <= frame_size; i++) {
+            seed = seed * 1103515245u + 12345u;
+            frame[i] = (seed >> 30) == 0 ? 0 : static_cast<uint8_t>(seed >> 16);
+        }
+        const uint16_t length = ums_cobs_stuff(frame.data(), static_cast<uint16_t>(frame_size));
+        capture.insert(capture.end(), frame.begin(), frame.begin() + length);
+    }
+    return capture;
+}
+
+// state.range(0) = frame size in bytes
+static void BM_Deframe(benchmark::State &state) {
+    const std::vector<uint8_t> capture = make_capture(static_cast<size_t>(state.range(0)), 4u << 20);
+    ums::host::Deframer deframer;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(deframer.feed(capture.data(), capture.size()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(capture.size()));
+}
+
+BENCHMARK(BM_Deframe)->Arg(12)->Arg(68)->Arg(UMS_MAX_WIRE_FRAME_SIZE - UMS_COBS_OVERHEAD);
+
+static void BM_FindDelimiter(benchmark::State &state) {
+    std::vector<uint8_t> data(static_cast<size_t>(state.range(0)), 0x5A);
+    data.back() = 0;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ums::host::find_delimiter(data.data(), data.size()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(BM_FindDelimiter)->Arg(64)->Arg(4096);
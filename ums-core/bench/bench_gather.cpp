@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+// Traced variables with padding in between, so neither the plan nor the gather list can merge them
+struct ScatteredVar {
+    float value;
+    uint32_t pad;
+};
+
+static ScatteredVar g_scattered[UMS_MAX_CHANNELS];
+static float g_adjacent[UMS_MAX_CHANNELS];
+static char g_name[] = "bench";
+
+static inline uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void mock_transmit(void *data_ptr, uint16_t length) {
+    benchmark::DoNotOptimize(data_ptr);
+    benchmark::DoNotOptimize(length);
+}
+
+static void mock_gather_transmit(const ums_iovec_t *iov, uint8_t iov_count, uint16_t length) {
+    benchmark::DoNotOptimize(iov);
+    benchmark::DoNotOptimize(iov_count);
+    benchmark::DoNotOptimize(length);
+}
+
+// state.range(0) = traced channels, state.range(1) = 0 contiguous transmit, 1 gather transmit,
+// state.range(2) = 0 scattered variables, 1 one adjacent block
+static void BM_UpdateTransmit(benchmark::State &state) {
+    const auto count = static_cast<uint8_t>(state.range(0));
+    ums_destroy();
+    ums_setup(mock_transmit);
+    if (state.range(1)) {
+        ums_gather_setup(mock_gather_transmit);
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        ums_trace(state.range(2) ? &g_adjacent[i] : &g_scattered[i].value, g_name, UMS_FLOAT32);
+    }
+
+    const uint64_t start = read_cycles();
+    for (auto _ : state) {
+        ums_update();
+        ums_transfer_complete_callback();
+    }
+    state.counters["cycles/sample"] = benchmark::Counter(
+        static_cast<double>(read_cycles() - start), benchmark::Counter::kAvgIterations);
+    ums_destroy();
+}
+
+BENCHMARK(BM_UpdateTransmit)->ArgsProduct({{1, 4, UMS_MAX_CHANNELS}, {0, 1}, {0, 1}});
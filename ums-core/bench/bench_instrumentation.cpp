@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+static float g_instrumented_vars[UMS_MAX_CHANNELS];
+static char g_name[] = "bench";
+
+static inline uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void mock_transmit(void *data_ptr, uint16_t length) {
+    benchmark::DoNotOptimize(data_ptr);
+    benchmark::DoNotOptimize(length);
+}
+
+// state.range(0) = traced channels, state.range(1) = instrumentation enabled.
+// With instrumentation the self-measured means are reported next to the external count.
+static void BM_UpdateInstrumented(benchmark::State &state) {
+    const auto count = static_cast<uint8_t>(state.range(0));
+    ums_destroy();
+    ums_setup(mock_transmit);
+    for (uint8_t i = 0; i < count; i++) {
+        g_instrumented_vars[i] = static_cast<float>(i) * 0.5f;
+        ums_trace(&g_instrumented_vars[i], g_name, UMS_FLOAT32);
+    }
+    ums_set_instrumentation(state.range(1) != 0);
+
+    const uint64_t start = read_cycles();
+    for (auto _ : state) {
+        ums_update();
+        ums_transfer_complete_callback();
+    }
+    state.counters["cycles/sample"] = benchmark::Counter(
+        static_cast<double>(read_cycles() - start), benchmark::Counter::kAvgIterations);
+
+    ums_instrumentation_t instrumentation;
+    if (state.range(1) != 0 && ums_get_instrumentation(&instrumentation) == UMS_SUCCESS) {
+        state.counters["update"] = ums_cycle_stats_mean(&instrumentation.update);
+        state.counters["create_sample"] = ums_cycle_stats_mean(&instrumentation.create_sample);
+        state.counters["update_max"] = instrumentation.update.max;
+    }
+    ums_destroy();
+}
+
+BENCHMARK(BM_UpdateInstrumented)->ArgsProduct({{1, 4, UMS_MAX_CHANNELS}, {0, 1}});
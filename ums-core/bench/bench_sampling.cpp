@@ -0,0 +1,154 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+// Sample engine end to end: ums_update() with a transport that completes synchronously (blocking UART/USB
+// driver), so every iteration is one sample packed, handed over and released. Regression baseline for the
+// hot path, run with --benchmark_out=<file> --benchmark_out_format=json to keep a record.
+
+// Traced variables 16 bytes apart, so the copy plan cannot merge them and every channel costs one op
+struct SamplingVar {
+    alignas(8) uint8_t bytes[8];
+    uint64_t pad;
+};
+
+static SamplingVar g_sampling_vars[UMS_MAX_CHANNELS];
+static char g_name[] = "bench";
+
+// Datatype mix of a typical control loop: flags, ADC counts, encoder positions, floats and a timestamp
+static const ums_datatype_t k_mixed_types[] = {
+    UMS_FLOAT32, UMS_INT16, UMS_UINT32, UMS_BOOL, UMS_FLOAT64, UMS_UINT8, UMS_INT32, UMS_UINT64,
+};
+
+/**
+ * Critical section cost model, selected per benchmark.
+ * 0 = empty hook (bare metal single core, same as the weak default).
+ * 1 = counting hook, the cost of a PRIMASK save/restore pair.
+ * 2 = spinlock, the cost of a host or multi-core port.
+ */
+static int g_critical_mode = 0;
+static uint64_t g_critical_count = 0;
+static std::atomic_flag g_critical_lock = ATOMIC_FLAG_INIT;
+
+// Overrides the weak defaults of ums-core for the whole benchmark binary
+extern "C" void ums_platform_enter_critical(void) {
+    if (g_critical_mode == 2) {
+        while (g_critical_lock.test_and_set(std::memory_order_acquire)) {
+        }
+    }
+    if (g_critical_mode != 0) {
+        g_critical_count++;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+}
+
+extern "C" void ums_platform_exit_critical(void) {
+    if (g_critical_mode != 0) {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+    if (g_critical_mode == 2) {
+        g_critical_lock.clear(std::memory_order_release);
+    }
+}
+
+static inline uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void mock_sync_transmit(void *data_ptr, uint16_t length) {
+    benchmark::DoNotOptimize(data_ptr);
+    benchmark::DoNotOptimize(length);
+    ums_transfer_complete_callback();
+}
+
+static void mock_sync_gather(const ums_iovec_t *iov, uint8_t iov_count, uint16_t length) {
+    benchmark::DoNotOptimize(iov);
+    benchmark::DoNotOptimize(iov_count);
+    benchmark::DoNotOptimize(length);
+    ums_transfer_complete_callback();
+}
+
+static void setup_channels(uint8_t count, bool mixed) {
+    ums_destroy();
+    ums_setup(mock_sync_transmit);
+    for (uint8_t i = 0; i < count; i++) {
+        const size_t type_count = sizeof(k_mixed_types) / sizeof(k_mixed_types[0]);
+        const ums_datatype_t type = mixed ? k_mixed_types[i % type_count] : UMS_FLOAT32;
+        ums_trace(g_sampling_vars[i].bytes, g_name, type);
+    }
+}
+
+// Runs ums_update() once per iteration and reports ns/sample, samples/s and cycles/sample
+static void run_updates(benchmark::State &state) {
+    const uint64_t start_cycles = read_cycles();
+    const auto start = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+        ums_update();
+        benchmark::ClobberMemory();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const uint64_t cycles = read_cycles() - start_cycles;
+
+    state.counters["ns/sample"] = benchmark::Counter(
+        static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+        benchmark::Counter::kAvgIterations);
+    state.counters["samples/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+    state.counters["cycles/sample"] = benchmark::Counter(
+        static_cast<double>(cycles), benchmark::Counter::kAvgIterations);
+}
+
+// state.range(0) = traced channels, all UMS_FLOAT32
+static void BM_SampleChannels(benchmark::State &state) {
+    setup_channels(static_cast<uint8_t>(state.range(0)), false);
+    run_updates(state);
+    ums_destroy();
+}
+
+// state.range(0) = traced channels, cycling through k_mixed_types
+static void BM_SampleMixedTypes(benchmark::State &state) {
+    setup_channels(static_cast<uint8_t>(state.range(0)), true);
+    run_updates(state);
+    ums_destroy();
+}
+
+// state.range(0) = traced channels, state.range(1) = critical section cost model,
+// state.range(2) = delivery: 0 triple buffer (lock-free), 1 batch of 4 frames, 2 gather
+static void BM_SampleCritical(benchmark::State &state) {
+    static uint8_t batch_buffer[4 * UMS_MAX_WIRE_FRAME_SIZE];
+    ums_destroy();
+    ums_setup(mock_sync_transmit);
+    if (state.range(2) == 1) {
+        ums_batch_setup(batch_buffer, sizeof(batch_buffer), 4, 0);
+    } else if (state.range(2) == 2) {
+        ums_gather_setup(mock_sync_gather);
+    }
+    for (uint8_t i = 0; i < static_cast<uint8_t>(state.range(0)); i++) {
+        ums_trace(g_sampling_vars[i].bytes, g_name, UMS_FLOAT32);
+    }
+
+    g_critical_mode = static_cast<int>(state.range(1));
+    g_critical_count = 0;
+    run_updates(state);
+    state.counters["critical/sample"] = benchmark::Counter(
+        static_cast<double>(g_critical_count), benchmark::Counter::kAvgIterations);
+    g_critical_mode = 0;
+    ums_destroy();
+}
+
+BENCHMARK(BM_SampleChannels)->DenseRange(1, UMS_MAX_CHANNELS);
+BENCHMARK(BM_SampleMixedTypes)->DenseRange(1, UMS_MAX_CHANNELS);
+BENCHMARK(BM_SampleCritical)->ArgsProduct({{1, UMS_MAX_CHANNELS}, {0, 1, 2}, {0, 1, 2}});
@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+extern "C" {
+#include "ums/trigger.h"
+}
+
+static inline uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Per-sample cost of a compiled trigger with 1..UMS_TRIGGER_MAX_CONDITIONS conditions over mixed datatypes
+static void BM_TriggerEvaluate(benchmark::State &state) {
+    static float current = 0.0f;
+    static int16_t speed = 0;
+    static uint8_t fault = 0;
+    data_channel_t channels[] = {
+        {&current, UMS_FLOAT32, nullptr, 0, 1, sizeof(float), nullptr},
+        {&speed, UMS_INT16, nullptr, 0, 1, sizeof(int16_t), nullptr},
+        {&fault, UMS_UINT8, nullptr, 0, 1, sizeof(uint8_t), nullptr},
+    };
+    const ums_trigger_kind_t kinds[] = {UMS_TRIGGER_ABOVE, UMS_TRIGGER_RISING, UMS_TRIGGER_OUTSIDE};
+
+    const auto count = static_cast<uint8_t>(state.range(0));
+    ums_trigger_condition_t conditions[UMS_TRIGGER_MAX_CONDITIONS];
+    for (uint8_t i = 0; i < count; i++) {
+        conditions[i] = {static_cast<uint8_t>(i % 3), static_cast<uint8_t>(kinds[i % 3]),
+                         static_cast<uint8_t>(i % 2 ? UMS_TRIGGER_OR : UMS_TRIGGER_AND), 1.0, 5.0};
+    }
+    ums_trigger_t trigger;
+    ums_trigger_compile(&trigger, conditions, count, channels, 3, 0);
+
+    const uint64_t start = read_cycles();
+    for (auto _ : state) {
+        current += 0.25f;
+        speed = static_cast<int16_t>(speed + 1);
+        benchmark::DoNotOptimize(ums_trigger_gate(&trigger));
+    }
+    state.counters["cycles/sample"] = benchmark::Counter(
+        static_cast<double>(read_cycles() - start), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_TriggerEvaluate)->Arg(1)->Arg(3)->Arg(UMS_TRIGGER_MAX_CONDITIONS);
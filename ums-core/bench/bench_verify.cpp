@@ -0,0 +1,32 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "ums/host/crc.h"
+
+// state.range(0) = bytes per call: one frame, or a whole capture checked in one go
+static void BM_HostCrc32(benchmark::State &state) {
+    std::vector<uint8_t> data(static_cast<size_t>(state.range(0)));
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<uint8_t>(i * 31u);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ums::host::crc32(data.data(), data.size()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(BM_HostCrc32)->Arg(68)->Arg(180)->Arg(1 << 20);
+
+static void BM_HostCrc16(benchmark::State &state) {
+    std::vector<uint8_t> data(static_cast<size_t>(state.range(0)), 0x5A);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ums::host::crc16(data.data(), data.size()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(BM_HostCrc16)->Arg(68)->Arg(1 << 20);
@@ -0,0 +1,137 @@
+#include "ums/host/cobs.h"
+
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+extern "C" {
+#include "ums/handshake.h"
+}
+
+namespace ums::host {
+
+namespace {
+
+// Longest stuffed frame a device sends, the handshake. Anything longer is not COBS framed.
+constexpr size_t kMaxStuffedFrame = UMS_HANDSHAKE_MAX_SIZE + UMS_COBS_MAX_OVERHEAD(UMS_HANDSHAKE_MAX_SIZE);
+
+inline size_t lowest_set_bit(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return static_cast<size_t>(__builtin_ctz(mask));
+#endif
+}
+
+} // namespace
+
+size_t find_delimiter(const uint8_t *data, size_t length) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i zero32 = _mm256_setzero_si256();
+    for (; i + 32 <= length; i += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, zero32)));
+        if (mask != 0) {
+            return i + lowest_set_bit(mask);
+        }
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128i zero16 = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, zero16)));
+        if (mask != 0) {
+            return i + lowest_set_bit(mask);
+        }
+    }
+#endif
+    for (; i < length; i++) {
+        if (data[i] == UMS_COBS_DELIMITER) {
+            return i;
+        }
+    }
+    return length;
+}
+
+bool cobs_decode(const uint8_t *data, size_t length, std::vector<uint8_t> &out) {
+    // Decoding never grows a frame, so the output is written through a raw pointer and trimmed afterwards.
+    const size_t start = out.size();
+    out.resize(start + length);
+    uint8_t *dst = out.data() + start;
+    size_t written = 0;
+    size_t i = 0;
+    while (i < length) {
+        const uint8_t code = data[i];
+        if (code == UMS_COBS_DELIMITER || i + code > length) {
+            out.resize(start);
+            return false;
+        }
+        std::memcpy(dst + written, data + i + 1, code - 1U);
+        written += code - 1U;
+        i += code;
+        // A full run has no zero behind it, neither has the last run
+        if (code != UMS_COBS_MAX_RUN + 1U && i < length) {
+            dst[written++] = 0;
+        }
+    }
+    out.resize(start + written);
+    return true;
+}
+
+void Deframer::finish(const uint8_t *data, size_t length) {
+    if (length == 0) {
+        return;     // back-to-back delimiters
+    }
+    if (length <= kMaxStuffedFrame && cobs_decode(data, length, decoded_)) {
+        stats_.frames++;
+        stats_.bytes += length + 1U;
+        ends_.push_back(decoded_.size());
+    } else {
+        stats_.errors++;
+    }
+}
+
+size_t Deframer::feed(const uint8_t *data, size_t length) {
+    decoded_.clear();
+    ends_.clear();
+
+    size_t offset = 0;
+    while (offset < length) {
+        const size_t end = offset + find_delimiter(data + offset, length - offset);
+        if (end == length) {
+            partial_.insert(partial_.end(), data + offset, data + length);
+            if (partial_.size() > kMaxStuffedFrame) {
+                // No delimiter for longer than any frame, resync on the next one.
+                partial_.clear();
+                stats_.errors++;
+            }
+            break;
+        }
+        if (partial_.empty()) {
+            finish(data + offset, end - offset);
+        } else {
+            partial_.insert(partial_.end(), data + offset, data + end);
+            finish(partial_.data(), partial_.size());
+            partial_.clear();
+        }
+        offset = end + 1;
+    }
+    return ends_.size();
+}
+
+const uint8_t *Deframer::frame(size_t i, size_t &length) const {
+    const size_t begin = (i == 0) ? 0 : ends_[i - 1];
+    length = ends_[i] - begin;
+    return decoded_.data() + begin;
+}
+
+} // namespace ums::host
@@ -0,0 +1,148 @@
+#include "ums/host/crc.h"
+
+#include <array>
+#include <cstring>
+
+#if defined(__PCLMUL__)
+#include <immintrin.h>
+#endif
+
+namespace ums::host {
+
+namespace {
+
+constexpr size_t kSlices = 8;
+
+template <typename T>
+using CrcTables = std::array<std::array<T, 256>, kSlices>;
+
+// Same construction as the device tables (src/ums_crc_tables.h), twice as many slices since the host has the cache
+template <typename T>
+constexpr CrcTables<T> make_tables(T poly) {
+    CrcTables<T> tables{};
+    for (uint32_t n = 0; n < 256; n++) {
+        T crc = static_cast<T>(n);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = static_cast<T>((crc & 1u) ? (crc >> 1) ^ poly : crc >> 1);
+        }
+        tables[0][n] = crc;
+    }
+    for (size_t k = 1; k < kSlices; k++) {
+        for (uint32_t n = 0; n < 256; n++) {
+            const T prev = tables[k - 1][n];
+            tables[k][n] = static_cast<T>((prev >> 8) ^ tables[0][prev & 0xFFu]);
+        }
+    }
+    return tables;
+}
+
+constexpr CrcTables<uint32_t> kCrc32Tables = make_tables<uint32_t>(0xEDB88320u);
+constexpr CrcTables<uint16_t> kCrc16Tables = make_tables<uint16_t>(0xA001u);
+
+// Continues the register crc over data, without init value or final xor
+template <typename T>
+T crc_update(const CrcTables<T> &tables, T crc, const uint8_t *data, size_t length) {
+    for (; length >= 8; data += 8, length -= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        word ^= crc;
+        crc = static_cast<T>(tables[7][word & 0xFFu] ^ tables[6][(word >> 8) & 0xFFu]
+                             ^ tables[5][(word >> 16) & 0xFFu] ^ tables[4][(word >> 24) & 0xFFu]
+                             ^ tables[3][(word >> 32) & 0xFFu] ^ tables[2][(word >> 40) & 0xFFu]
+                             ^ tables[1][(word >> 48) & 0xFFu] ^ tables[0][word >> 56]);
+    }
+    for (; length > 0; data++, length--) {
+        crc = static_cast<T>(tables[0][(crc ^ *data) & 0xFFu] ^ (crc >> 8));
+    }
+    return crc;
+}
+
+#if defined(__PCLMUL__)
+// Folding constants x^(k) mod P(x) of the reflected CRC-32 polynomial, see Intel's "Fast CRC Computation for
+// Generic Polynomials Using PCLMULQDQ Instruction": fold by 4 x 128 bits, by 128 bits, 64 bits, then Barrett.
+alignas(16) constexpr uint64_t kFold4[2] = {0x0154442BD4u, 0x01C6E41596u};
+alignas(16) constexpr uint64_t kFold1[2] = {0x01751997D0u, 0x00CCAA009Eu};
+alignas(16) constexpr uint64_t kFold64[2] = {0x0163CD6124u, 0u};
+alignas(16) constexpr uint64_t kBarrett[2] = {0x01DB710641u, 0x01F7011641u};
+
+// length >= 64 and a multiple of 16
+uint32_t crc32_fold(const uint8_t *data, size_t length, uint32_t crc) {
+    const auto load = [](const uint8_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); };
+    const auto fold = [](__m128i x, __m128i k, __m128i next) {
+        return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11)),
+                             next);
+    };
+
+    __m128i x1 = _mm_xor_si128(load(data), _mm_cvtsi32_si128(static_cast<int>(crc)));
+    __m128i x2 = load(data + 16);
+    __m128i x3 = load(data + 32);
+    __m128i x4 = load(data + 48);
+    data += 64;
+    length -= 64;
+
+    __m128i k = _mm_load_si128(reinterpret_cast<const __m128i *>(kFold4));
+    for (; length >= 64; data += 64, length -= 64) {
+        x1 = fold(x1, k, load(data));
+        x2 = fold(x2, k, load(data + 16));
+        x3 = fold(x3, k, load(data + 32));
+        x4 = fold(x4, k, load(data + 48));
+    }
+
+    k = _mm_load_si128(reinterpret_cast<const __m128i *>(kFold1));
+    x1 = fold(x1, k, x2);
+    x1 = fold(x1, k, x3);
+    x1 = fold(x1, k, x4);
+    for (; length >= 16; data += 16, length -= 16) {
+        x1 = fold(x1, k, load(data));
+    }
+
+    // 128 -> 64 bits
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), _mm_clmulepi64_si128(x1, k, 0x10));
+    k = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(kFold64));
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x00), _mm_srli_si128(x1, 4));
+
+    // Barrett reduction to 32 bits
+    k = _mm_load_si128(reinterpret_cast<const __m128i *>(kBarrett));
+    __m128i x2r = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x10);
+    x2r = _mm_clmulepi64_si128(_mm_and_si128(x2r, mask32), k, 0x00);
+    x1 = _mm_xor_si128(x1, x2r);
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(x1, 4)));
+}
+#endif
+
+} // namespace
+
+uint32_t crc32(const uint8_t *data, size_t length) {
+    uint32_t crc = 0xFFFFFFFFu;
+#if defined(__PCLMUL__)
+    if (length >= 64) {
+        const size_t folded = length & ~static_cast<size_t>(15);
+        crc = crc32_fold(data, folded, crc);
+        data += folded;
+        length -= folded;
+    }
+#endif
+    return ~crc_update(kCrc32Tables, crc, data, length);
+}
+
+uint16_t crc16(const uint8_t *data, size_t length) {
+    return crc_update<uint16_t>(kCrc16Tables, 0xFFFFu, data, length);
+}
+
+bool check_crc(ums_crc_t crc, const uint8_t *frame, size_t length) {
+    const size_t size = ums_crc_size(crc);
+    if (size == 0) {
+        return true;
+    }
+    if (length < size) {
+        return false;
+    }
+    const size_t covered = length - size;
+    const uint32_t expected = (crc == UMS_CRC_16) ? crc16(frame, covered) : crc32(frame, covered);
+    uint32_t trailer = 0;
+    std::memcpy(&trailer, frame + covered, size);
+    return trailer == expected;
+}
+
+} // namespace ums::host
@@ -0,0 +1,490 @@
+#include "ums/host/frame_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+#include "ums/host/crc.h"
+
+namespace ums::host {
+
+FrameDecoder::FrameDecoder(std::vector<ums_datatype_t> layout, ums_encoding_t encoding)
+    : layout_(std::move(layout)), encoding_(encoding) {
+    for (ums_datatype_t type : layout_) {
+        offsets_.push_back(payload_size_);
+        payload_size_ += ums_datatype_size(type);
+    }
+    reference_.assign(payload_size_, 0);
+    known_.assign(layout_.size(), false);
+    groups_.assign(layout_.size(), 0);
+    group_sizes_[0] = payload_size_;
+}
+
+bool FrameDecoder::set_groups(std::vector<uint8_t> groups) {
+    if (groups.size() != layout_.size()) {
+        return false;
+    }
+    size_t sizes[UMS_MAX_GROUPS] = {};
+    bool multi_rate = false;
+    for (size_t i = 0; i < groups.size(); i++) {
+        if (groups[i] >= UMS_MAX_GROUPS) {
+            return false;
+        }
+        sizes[groups[i]] += ums_datatype_size(layout_[i]);
+        multi_rate = multi_rate || groups[i] != 0;
+    }
+    groups_ = std::move(groups);
+    std::copy(std::begin(sizes), std::end(sizes), group_sizes_);
+    multi_rate_ = multi_rate;
+    return true;
+}
+
+namespace {
+
+enum class Match { none, partial, full };
+
+// partial = data ends inside a prefix of pattern, more bytes needed to tell
+Match match(const uint8_t *data, size_t length, const uint8_t *pattern, size_t size) {
+    const size_t n = std::min(length, size);
+    if (std::memcmp(data, pattern, n) != 0) {
+        return Match::none;
+    }
+    return n == size ? Match::full : Match::partial;
+}
+
+} // namespace
+
+void FrameDecoder::set_sync(uint32_t layout_hash, size_t handshake_length) {
+    sync_ = true;
+    ums_sync_marker_build(layout_hash, sync_marker_);
+    handshake_header_[0] = UMS_HANDSHAKE_MAGIC_0;
+    handshake_header_[1] = UMS_HANDSHAKE_MAGIC_1;
+    handshake_header_[2] = UMS_HANDSHAKE_VERSION;
+    std::memcpy(&handshake_header_[3], &layout_hash, sizeof(layout_hash));
+    handshake_length_ = handshake_length;
+}
+
+bool FrameDecoder::set_sequence(size_t size) {
+    if (size > UMS_MAX_SEQUENCE_SIZE) {
+        return false;
+    }
+    sequence_size_ = size;
+    have_sequence_ = false;
+    return true;
+}
+
+bool FrameDecoder::set_crc(ums_crc_t crc) {
+    if (crc != UMS_CRC_NONE && crc != UMS_CRC_16 && crc != UMS_CRC_32) {
+        return false;
+    }
+    crc_ = crc;
+    return true;
+}
+
+void FrameDecoder::track_sequence(uint16_t sequence) {
+    const uint16_t mask = (sequence_size_ == 1) ? 0x00FFu : 0xFFFFu;
+    const auto gap = static_cast<uint16_t>((sequence - next_sequence_) & mask);
+    if (have_sequence_ && gap != 0) {
+        stats_.lost += gap;
+        stats_.gaps++;
+        stats_.max_gap = std::max<uint64_t>(stats_.max_gap, gap);
+    }
+    have_sequence_ = true;
+    next_sequence_ = static_cast<uint16_t>((sequence + 1u) & mask);
+}
+
+size_t FrameDecoder::find_sync(const uint8_t *data, size_t length) const {
+    const uint8_t *end = data + length;
+    return static_cast<size_t>(std::search(data, end, std::begin(sync_marker_), std::end(sync_marker_)) - data);
+}
+
+// ok = consumed marker and handshake bytes (possibly 0), incomplete = data ends inside one of them.
+// frame_start is where the frame begins, at its own marker: the CRC trailer covers it.
+DecodeResult FrameDecoder::skip_sync(const uint8_t *data, size_t length, size_t &markers, size_t &frame_start) {
+    size_t offset = 0;
+    for (;;) {
+        const Match handshake = (handshake_length_ == 0)
+            ? Match::none
+            : match(data + offset, length - offset, handshake_header_, sizeof(handshake_header_));
+        const Match marker = match(data + offset, length - offset, sync_marker_, sizeof(sync_marker_));
+        if (handshake == Match::full) {
+            if (length - offset < handshake_length_) {
+                return {DecodeStatus::incomplete, 0};
+            }
+            offset += handshake_length_;
+            frame_start = offset;
+        } else if (marker == Match::full) {
+            frame_start = offset;
+            offset += sizeof(sync_marker_);
+            markers++;
+        } else if (handshake == Match::partial || marker == Match::partial) {
+            return {DecodeStatus::incomplete, 0};
+        } else {
+            return {DecodeStatus::ok, offset};
+        }
+    }
+}
+
+// Checks the trailer behind a decoded frame of covered bytes, available bytes follow its body.
+// false = the trailer is incomplete, the reference is restored for the retry.
+bool FrameDecoder::check_trailer(const uint8_t *frame, size_t covered, size_t available, DecodeResult &result) {
+    const size_t size = ums_crc_size(crc_);
+    if (available < size) {
+        reference_.swap(saved_reference_);
+        known_.swap(saved_known_);
+        return false;
+    }
+    if (!check_crc(crc_, frame, covered + size)) {
+        // The device encodes the next delta against this frame, so wait for a keyframe.
+        have_reference_ = false;
+        known_.assign(known_.size(), false);
+        stats_.crc_errors++;
+        result = {DecodeStatus::corrupt, result.consumed + size};
+        return true;
+    }
+    result.consumed += size;
+    return true;
+}
+
+DecodeResult FrameDecoder::decode(const uint8_t *data, size_t length, Sample &sample) {
+    const uint8_t *frame = data;
+    size_t skipped = 0;
+    size_t markers = 0;
+    size_t frame_start = 0;
+    if (sync_) {
+        const DecodeResult sync = skip_sync(data, length, markers, frame_start);
+        if (sync.status != DecodeStatus::ok) {
+            return sync;
+        }
+        skipped = sync.consumed;
+        data += skipped;
+        length -= skipped;
+    }
+    uint16_t sequence = 0;
+    if (sequence_size_ != 0) {
+        if (length < sequence_size_) {
+            return {DecodeStatus::incomplete, 0};
+        }
+        std::memcpy(&sequence, data, sequence_size_);
+        skipped += sequence_size_;
+        data += sequence_size_;
+        length -= sequence_size_;
+    }
+
+    // The body decoders update the reference, a frame cut off inside its trailer is decoded again later.
+    const bool had_reference = have_reference_;
+    const uint32_t prev_timestamp = prev_timestamp_;
+    const uint64_t keyframes = stats_.keyframes;
+    if (crc_ != UMS_CRC_NONE) {
+        saved_reference_ = reference_;
+        saved_known_ = known_;
+    }
+
+    DecodeResult result;
+    if (multi_rate_) {
+        result = decode_grouped(data, length, sample);
+    } else if (encoding_ == UMS_ENCODING_DELTA) {
+        result = decode_delta(data, length, sample);
+    } else if (encoding_ == UMS_ENCODING_CHANGED) {
+        result = decode_changed(data, length, sample);
+    } else {
+        result = decode_raw(data, length, sample);
+    }
+    if (crc_ != UMS_CRC_NONE
+        && (result.status == DecodeStatus::ok || result.status == DecodeStatus::no_keyframe)) {
+        const size_t body = result.consumed;
+        if (!check_trailer(frame + frame_start, skipped - frame_start + body, length - body, result)) {
+            have_reference_ = had_reference;
+            prev_timestamp_ = prev_timestamp;
+            stats_.keyframes = keyframes;
+            return {DecodeStatus::incomplete, 0};
+        }
+        if (result.status == DecodeStatus::corrupt) {
+            stats_.keyframes = keyframes;
+        }
+    }
+    if (result.status == DecodeStatus::ok) {
+        stats_.frames++;
+        stats_.wire_bytes += skipped + result.consumed;
+        stats_.raw_bytes += raw_frame_size();
+        stats_.sync_bytes += skipped - sequence_size_;
+        stats_.sync_markers += markers;
+    } else if (result.status != DecodeStatus::incomplete) {
+        stats_.errors++;
+    }
+    if (result.status == DecodeStatus::corrupt) {
+        result.consumed += skipped;
+    } else if (result.status == DecodeStatus::ok || result.status == DecodeStatus::no_keyframe) {
+        result.consumed += skipped;
+        sample.sequence = sequence;
+        if (sequence_size_ != 0) {
+            track_sequence(sequence);
+        }
+    }
+    return result;
+}
+
+size_t FrameDecoder::decode_stream(const uint8_t *data, size_t length, std::vector<Sample> &samples) {
+    size_t offset = 0;
+    while (offset < length) {
+        Sample sample;
+        const DecodeResult result = decode(data + offset, length - offset, sample);
+        if ((result.status == DecodeStatus::invalid || result.status == DecodeStatus::corrupt) && sync_) {
+            // Lost the frame boundary, the next marker restores it.
+            const size_t next = offset + 1U + find_sync(data + offset + 1U, length - offset - 1U);
+            if (next >= length) {
+                break;
+            }
+            offset = next;
+            continue;
+        }
+        if (result.status == DecodeStatus::incomplete || result.status == DecodeStatus::invalid) {
+            break;
+        }
+        offset += result.consumed;
+        if (result.status == DecodeStatus::ok) {
+            samples.push_back(std::move(sample));
+        }
+    }
+    return offset;
+}
+
+DecodeResult FrameDecoder::decode_raw(const uint8_t *data, size_t length, Sample &sample) {
+    if (length < raw_frame_size()) {
+        return {DecodeStatus::incomplete, 0};
+    }
+    memcpy(&sample.timestamp, data, sizeof(uint32_t));
+    sample.payload.assign(data + sizeof(uint32_t), data + raw_frame_size());
+    return {DecodeStatus::ok, raw_frame_size()};
+}
+
+DecodeResult FrameDecoder::decode_delta(const uint8_t *data, size_t length, Sample &sample) {
+    if (length < 1) {
+        return {DecodeStatus::incomplete, 0};
+    }
+    const uint8_t tag = data[0];
+    if ((tag & ~UMS_FRAME_TAG_KEYFRAME) != 0) {
+        return {DecodeStatus::invalid, 0};
+    }
+
+    if (tag & UMS_FRAME_TAG_KEYFRAME) {
+        const size_t size = 1 + raw_frame_size();
+        if (length < size) {
+            return {DecodeStatus::incomplete, 0};
+        }
+        memcpy(&prev_timestamp_, &data[1], sizeof(uint32_t));
+        memcpy(reference_.data(), &data[1 + sizeof(uint32_t)], payload_size_);
+        have_reference_ = true;
+        stats_.keyframes++;
+
+        sample.timestamp = prev_timestamp_;
+        sample.payload = reference_;
+        return {DecodeStatus::ok, size};
+    }
+
+    size_t offset = 1;
+    uint64_t value = 0;
+    const auto available = [&]() { return static_cast<uint32_t>(length - offset); };
+
+    uint8_t used = ums_varint_decode(&data[offset], available(), &value);
+    if (used == 0) {
+        return {length - offset < UMS_VARINT_MAX_SIZE ? DecodeStatus::incomplete : DecodeStatus::invalid, 0};
+    }
+    offset += used;
+    const uint32_t timestamp = prev_timestamp_ + static_cast<uint32_t>(value);
+
+    std::vector<uint8_t> payload(reference_);
+    for (size_t i = 0; i < layout_.size(); i++) {
+        used = ums_varint_decode(&data[offset], available(), &value);
+        if (used == 0) {
+            return {length - offset < UMS_VARINT_MAX_SIZE ? DecodeStatus::incomplete : DecodeStatus::invalid, 0};
+        }
+        offset += used;
+
+        uint8_t *field = &payload[offsets_[i]];
+        switch (ums_codec_kind(layout_[i])) {
+        case UMS_CODEC_INT8:
+            field[0] = static_cast<uint8_t>(field[0] + static_cast<uint8_t>(ums_zigzag_decode(value)));
+            break;
+        case UMS_CODEC_INT16: {
+            uint16_t v;
+            memcpy(&v, field, sizeof(v));
+            v = static_cast<uint16_t>(v + static_cast<uint16_t>(ums_zigzag_decode(value)));
+            memcpy(field, &v, sizeof(v));
+            break;
+        }
+        case UMS_CODEC_INT32: {
+            uint32_t v;
+            memcpy(&v, field, sizeof(v));
+            v += static_cast<uint32_t>(ums_zigzag_decode(value));
+            memcpy(field, &v, sizeof(v));
+            break;
+        }
+        case UMS_CODEC_INT64: {
+            uint64_t v;
+            memcpy(&v, field, sizeof(v));
+            v += static_cast<uint64_t>(ums_zigzag_decode(value));
+            memcpy(field, &v, sizeof(v));
+            break;
+        }
+        case UMS_CODEC_FLOAT32: {
+            uint32_t v;
+            memcpy(&v, field, sizeof(v));
+            v ^= static_cast<uint32_t>(value);
+            memcpy(field, &v, sizeof(v));
+            break;
+        }
+        default: {
+            uint64_t v;
+            memcpy(&v, field, sizeof(v));
+            v ^= value;
+            memcpy(field, &v, sizeof(v));
+            break;
+        }
+        }
+    }
+
+    // The frame is consumed even without a reference, so a stream can skip ahead to the next keyframe
+    if (!have_reference_) {
+        return {DecodeStatus::no_keyframe, offset};
+    }
+
+    prev_timestamp_ = timestamp;
+    reference_ = payload;
+    sample.timestamp = timestamp;
+    sample.payload = std::move(payload);
+    return {DecodeStatus::ok, offset};
+}
+
+DecodeResult FrameDecoder::decode_changed(const uint8_t *data, size_t length, Sample &sample) {
+    const size_t header = sizeof(uint32_t) + UMS_PRESENCE_BITMAP_SIZE;
+    if (length < header) {
+        return {DecodeStatus::incomplete, 0};
+    }
+    const uint8_t *bitmap = &data[sizeof(uint32_t)];
+    for (size_t i = layout_.size(); i < UMS_PRESENCE_BITMAP_SIZE * 8; i++) {
+        if (bitmap[i >> 3] & (1U << (i & 7U))) {
+            return {DecodeStatus::invalid, 0};
+        }
+    }
+
+    size_t size = header;
+    for (size_t i = 0; i < layout_.size(); i++) {
+        if (bitmap[i >> 3] & (1U << (i & 7U))) {
+            size += ums_datatype_size(layout_[i]);
+        }
+    }
+    if (length < size) {
+        return {DecodeStatus::incomplete, 0};
+    }
+
+    size_t offset = header;
+    bool all_present = true;
+    bool all_known = true;
+    for (size_t i = 0; i < layout_.size(); i++) {
+        const uint8_t width = ums_datatype_size(layout_[i]);
+        if (bitmap[i >> 3] & (1U << (i & 7U))) {
+            memcpy(&reference_[offsets_[i]], &data[offset], width);
+            offset += width;
+            known_[i] = true;
+        } else {
+            all_present = false;
+        }
+        all_known = all_known && known_[i];
+    }
+    if (all_present) {
+        stats_.keyframes++;
+    }
+    if (!all_known) {
+        return {DecodeStatus::no_keyframe, size};
+    }
+
+    memcpy(&sample.timestamp, data, sizeof(uint32_t));
+    sample.payload = reference_;
+    return {DecodeStatus::ok, size};
+}
+
+DecodeResult FrameDecoder::decode_grouped(const uint8_t *data, size_t length, Sample &sample) {
+    const size_t header = 1 + sizeof(uint32_t);
+    if (length < header) {
+        return {DecodeStatus::incomplete, 0};
+    }
+    const uint8_t mask = data[0];
+    size_t size = header;
+    for (uint8_t g = 0; g < UMS_MAX_GROUPS; g++) {
+        if (mask & (1U << g)) {
+            if (group_sizes_[g] == 0) {
+                return {DecodeStatus::invalid, 0};
+            }
+            size += group_sizes_[g];
+        }
+    }
+    if (mask == 0) {
+        return {DecodeStatus::invalid, 0};
+    }
+    if (length < size) {
+        return {DecodeStatus::incomplete, 0};
+    }
+
+    // Group blocks follow in ascending group order, each in registration order
+    size_t offset = header;
+    for (uint8_t g = 0; g < UMS_MAX_GROUPS; g++) {
+        if (!(mask & (1U << g))) {
+            continue;
+        }
+        for (size_t i = 0; i < layout_.size(); i++) {
+            if (groups_[i] == g) {
+                const uint8_t width = ums_datatype_size(layout_[i]);
+                memcpy(&reference_[offsets_[i]], &data[offset], width);
+                offset += width;
+                known_[i] = true;
+            }
+        }
+    }
+    for (bool known : known_) {
+        if (!known) {
+            return {DecodeStatus::no_keyframe, size};
+        }
+    }
+
+    memcpy(&sample.timestamp, &data[1], sizeof(uint32_t));
+    sample.groups = mask;
+    sample.payload = reference_;
+    return {DecodeStatus::ok, size};
+}
+
+double FrameDecoder::value(const Sample &sample, size_t channel) const {
+    const uint8_t *field = &sample.payload[offsets_[channel]];
+    switch (layout_[channel]) {
+    case UMS_UINT8:  { uint8_t v;  memcpy(&v, field, sizeof(v)); return v; }
+    case UMS_UINT16: { uint16_t v; memcpy(&v, field, sizeof(v)); return v; }
+    case UMS_UINT32: { uint32_t v; memcpy(&v, field, sizeof(v)); return v; }
+    case UMS_UINT64: { uint64_t v; memcpy(&v, field, sizeof(v)); return static_cast<double>(v); }
+    case UMS_INT8:   { int8_t v;   memcpy(&v, field, sizeof(v)); return v; }
+    case UMS_INT16:  { int16_t v;  memcpy(&v, field, sizeof(v)); return v; }
+    case UMS_INT32:  { int32_t v;  memcpy(&v, field, sizeof(v)); return v; }
+    case UMS_INT64:  { int64_t v;  memcpy(&v, field, sizeof(v)); return static_cast<double>(v); }
+    case UMS_FLOAT32:{ float v;    memcpy(&v, field, sizeof(v)); return v; }
+    case UMS_FLOAT64:{ double v;   memcpy(&v, field, sizeof(v)); return v; }
+    case UMS_BOOL:   return field[0] != 0 ? 1.0 : 0.0;
+    default:         return 0.0;
+    }
+}
+
+bool parse_datatype(const std::string &name, ums_datatype_t &type) {
+    static const std::pair<const char*, ums_datatype_t> names[] = {
+        {"u8", UMS_UINT8},   {"u16", UMS_UINT16}, {"u32", UMS_UINT32}, {"u64", UMS_UINT64},
+        {"i8", UMS_INT8},    {"i16", UMS_INT16},  {"i32", UMS_INT32},  {"i64", UMS_INT64},
+        {"f32", UMS_FLOAT32}, {"f64", UMS_FLOAT64}, {"bool", UMS_BOOL},
+    };
+    for (const auto &entry : names) {
+        if (name == entry.first) {
+            type = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace ums::host
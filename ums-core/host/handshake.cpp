@@ -0,0 +1,248 @@
+#include "ums/host/handshake.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "ums/host/crc.h"
+
+extern "C" {
+#include "ums/encoding.h"
+}
+
+namespace ums::host {
+
+namespace {
+
+// Bounds-checked reader, a short read marks the packet incomplete
+class Reader {
+public:
+    Reader(const uint8_t *data, size_t length) : data_(data), length_(length) {}
+
+    bool u8(uint8_t &value) {
+        if (offset_ + 1 > length_) {
+            short_ = true;
+            return false;
+        }
+        value = data_[offset_++];
+        return true;
+    }
+
+    bool u16(uint16_t &value) {
+        if (offset_ + sizeof(value) > length_) {
+            short_ = true;
+            return false;
+        }
+        memcpy(&value, &data_[offset_], sizeof(value));
+        offset_ += sizeof(value);
+        return true;
+    }
+
+    bool varint(uint64_t &value) {
+        const uint8_t used = ums_varint_decode(&data_[offset_], static_cast<uint32_t>(length_ - offset_), &value);
+        if (used == 0) {
+            short_ = true;
+            return false;
+        }
+        offset_ += used;
+        return true;
+    }
+
+    bool name(std::string &value) {
+        uint8_t size = 0;
+        if (!u8(size)) {
+            return false;
+        }
+        if (offset_ + size > length_) {
+            short_ = true;
+            return false;
+        }
+        value.assign(reinterpret_cast<const char *>(&data_[offset_]), size);
+        offset_ += size;
+        return true;
+    }
+
+    size_t offset() const { return offset_; }
+    bool is_short() const { return short_; }
+
+private:
+    const uint8_t *data_;
+    size_t length_;
+    size_t offset_ = 0;
+    bool short_ = false;
+};
+
+// Type byte from ums_handshake_type_byte(), the size bits have to match the datatype
+bool unpack_type(uint8_t byte, ums_datatype_t &type) {
+    type = static_cast<ums_datatype_t>(byte & UMS_HANDSHAKE_TYPE_MASK);
+    return type == UMS_STRUCT || (ums_datatype_size(type) != 0 && ums_handshake_type_byte(type) == byte);
+}
+
+struct Field {
+    std::string name;
+    ums_datatype_t type;
+    uint64_t offset;
+};
+
+// Expands a struct into its fields in offset order, filling the gaps with padding bytes
+bool expand_struct(const std::string &name, uint8_t group, uint64_t size, std::vector<Field> fields,
+                   std::vector<HandshakeChannel> &channels) {
+    std::sort(fields.begin(), fields.end(), [](const Field &a, const Field &b) { return a.offset < b.offset; });
+    uint64_t offset = 0;
+    for (const Field &field : fields) {
+        if (field.offset < offset || field.offset + ums_datatype_size(field.type) > size) {
+            return false;  // overlapping (union) or outside the struct
+        }
+        for (; offset < field.offset; offset++) {
+            channels.push_back({"", UMS_UINT8, group, true});
+        }
+        channels.push_back({name + "." + field.name, field.type, group, false});
+        offset += ums_datatype_size(field.type);
+    }
+    for (; offset < size; offset++) {
+        channels.push_back({"", UMS_UINT8, group, true});
+    }
+    return true;
+}
+
+} // namespace
+
+std::vector<ums_datatype_t> Handshake::layout() const {
+    std::vector<ums_datatype_t> types;
+    for (const HandshakeChannel &channel : channels) {
+        types.push_back(channel.type);
+    }
+    return types;
+}
+
+std::vector<uint8_t> Handshake::groups() const {
+    std::vector<uint8_t> result;
+    for (const HandshakeChannel &channel : channels) {
+        result.push_back(channel.group);
+    }
+    return result;
+}
+
+FrameDecoder Handshake::make_decoder() const {
+    FrameDecoder decoder(layout(), encoding);
+    decoder.set_groups(groups());
+    decoder.set_sync(layout_hash, length);
+    decoder.set_sequence(sequence_size);
+    decoder.set_crc(crc);
+    return decoder;
+}
+
+DecodeResult parse_handshake(const uint8_t *data, size_t length, Handshake &handshake) {
+    Reader reader(data, length);
+    const auto fail = [&reader]() -> DecodeResult {
+        return {reader.is_short() ? DecodeStatus::incomplete : DecodeStatus::invalid, 0};
+    };
+
+    uint8_t magic0 = 0, magic1 = 0, version = 0;
+    uint16_t hash_low = 0, hash_high = 0;
+    if (!reader.u8(magic0) || !reader.u8(magic1) || !reader.u8(version) || !reader.u16(hash_low)
+        || !reader.u16(hash_high)) {
+        return fail();
+    }
+    if (magic0 != UMS_HANDSHAKE_MAGIC_0 || magic1 != UMS_HANDSHAKE_MAGIC_1 || version != UMS_HANDSHAKE_VERSION) {
+        return {DecodeStatus::invalid, 0};
+    }
+
+    Handshake result;
+    result.layout_hash = static_cast<uint32_t>(hash_low) | (static_cast<uint32_t>(hash_high) << 16);
+
+    uint8_t encoding = 0, sequence_size = 0, crc = 0, group_count = 0;
+    if (!reader.u8(encoding) || !reader.u8(sequence_size) || !reader.u8(crc) || !reader.u8(group_count)) {
+        return fail();
+    }
+    if (encoding > UMS_ENCODING_CHANGED || sequence_size > UMS_MAX_SEQUENCE_SIZE || crc > UMS_CRC_32
+        || group_count == 0 || group_count > UMS_MAX_GROUPS) {
+        return {DecodeStatus::invalid, 0};
+    }
+    result.encoding = static_cast<ums_encoding_t>(encoding);
+    result.sequence_size = sequence_size;
+    result.crc = static_cast<ums_crc_t>(crc);
+    for (uint8_t g = 0; g < group_count; g++) {
+        uint16_t divider = 0;
+        if (!reader.u16(divider)) {
+            return fail();
+        }
+        result.group_dividers.push_back(divider);
+    }
+
+    uint8_t channel_count = 0;
+    if (!reader.u8(channel_count)) {
+        return fail();
+    }
+    for (uint8_t i = 0; i < channel_count; i++) {
+        uint8_t type_byte = 0, group = 0;
+        uint64_t count = 0;
+        std::string name;
+        if (!reader.u8(type_byte) || !reader.u8(group) || !reader.varint(count) || !reader.name(name)) {
+            return fail();
+        }
+        ums_datatype_t type;
+        if (!unpack_type(type_byte, type) || group >= group_count || count == 0) {
+            return {DecodeStatus::invalid, 0};
+        }
+
+        if (type != UMS_STRUCT) {
+            if (count == 1) {
+                result.channels.push_back({name, type, group, false});
+                continue;
+            }
+            for (uint64_t e = 0; e < count; e++) {
+                result.channels.push_back({name + "[" + std::to_string(e) + "]", type, group, false});
+            }
+            continue;
+        }
+
+        uint64_t size = 0;
+        if (!reader.varint(size)) {
+            return fail();
+        }
+        std::vector<Field> fields;
+        for (uint64_t f = 0; f < count; f++) {
+            Field field;
+            uint8_t field_type = 0;
+            if (!reader.u8(field_type) || !reader.varint(field.offset) || !reader.name(field.name)) {
+                return fail();
+            }
+            if (!unpack_type(field_type, field.type) || field.type == UMS_STRUCT) {
+                return {DecodeStatus::invalid, 0};
+            }
+            fields.push_back(std::move(field));
+        }
+        if (!expand_struct(name, group, size, std::move(fields), result.channels)) {
+            return {DecodeStatus::invalid, 0};
+        }
+    }
+
+    size_t end = reader.offset();
+    if (ums_handshake_hash(data + UMS_HANDSHAKE_HEADER_SIZE, static_cast<uint32_t>(end - UMS_HANDSHAKE_HEADER_SIZE))
+        != result.layout_hash) {
+        return {DecodeStatus::invalid, 0};
+    }
+    end += ums_crc_size(result.crc);
+    if (end > length) {
+        return {DecodeStatus::incomplete, 0};
+    }
+    if (!check_crc(result.crc, data, end)) {
+        return {DecodeStatus::invalid, 0};
+    }
+
+    result.length = end;
+    handshake = std::move(result);
+    return {DecodeStatus::ok, end};
+}
+
+size_t find_handshake(const uint8_t *data, size_t length, Handshake &handshake) {
+    for (size_t offset = 0; offset < length; offset++) {
+        if (data[offset] == UMS_HANDSHAKE_MAGIC_0
+            && parse_handshake(data + offset, length - offset, handshake).status == DecodeStatus::ok) {
+            return offset;
+        }
+    }
+    return length;
+}
+
+} // namespace ums::host
@@ -0,0 +1,65 @@
+#ifndef UMS_HOST_COBS_H
+#define UMS_HOST_COBS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include "ums/cobs.h"
+}
+
+namespace ums::host {
+
+/**
+ * Index of the first COBS delimiter (0x00) in data, length if there is none.
+ * Compares 32 bytes per step with AVX2 (UMS_HOST_AVX2) or 16 with SSE2 when the build targets them.
+ */
+size_t find_delimiter(const uint8_t *data, size_t length);
+
+/**
+ * Decodes one COBS frame, delimiter excluded, and appends it to out.
+ * @return false if a code byte points past the end of the frame, out is left unchanged then.
+ */
+bool cobs_decode(const uint8_t *data, size_t length, std::vector<uint8_t> &out);
+
+struct DeframerStats {
+    uint64_t frames = 0;
+    uint64_t errors = 0;    // malformed or oversized frames, e.g. the cut-off first frame of a capture joined mid-stream
+    uint64_t bytes = 0;     // stuffed bytes of all complete frames, delimiters included
+};
+
+/**
+ * Splits a UMS_FRAMING_COBS stream into decoded frames (one per transmit function call: a sample frame, a batch
+ * frame or a handshake). The stream can be fed in chunks of any size, a frame cut at the end of a chunk is
+ * completed by the next feed().
+ */
+class Deframer {
+public:
+    /**
+     * Decodes every frame that data completes.
+     * @return number of frames, accessible with frame() until the next feed().
+     */
+    size_t feed(const uint8_t *data, size_t length);
+
+    /**
+     * Decoded bytes of frame i of the last feed().
+     */
+    const uint8_t *frame(size_t i, size_t &length) const;
+
+    size_t frame_count() const { return ends_.size(); }
+    size_t pending() const { return partial_.size(); }  // bytes of a frame still waiting for its delimiter
+    const DeframerStats &stats() const { return stats_; }
+
+private:
+    void finish(const uint8_t *data, size_t length);
+
+    std::vector<uint8_t> partial_;
+    std::vector<uint8_t> decoded_;
+    std::vector<size_t> ends_;
+    DeframerStats stats_;
+};
+
+} // namespace ums::host
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef UMS_HOST_CRC_H
+#define UMS_HOST_CRC_H
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+#include "ums/crc.h"
+}
+
+namespace ums::host {
+
+/**
+ * CRC-32/ISO-HDLC, same result as ums_crc32(). Folds 64 bytes per step with carry-less multiplication when the
+ * build targets PCLMUL (UMS_HOST_PCLMUL), slice-by-8 tables for short input and otherwise.
+ */
+uint32_t crc32(const uint8_t *data, size_t length);
+
+/**
+ * CRC-16/MODBUS, same result as ums_crc16(), slice-by-8 tables.
+ */
+uint16_t crc16(const uint8_t *data, size_t length);
+
+/**
+ * Checks the trailer of a frame or handshake.
+ * @param length bytes of frame, the ums_crc_size(crc) byte trailer included.
+ * @return true if the trailer matches, always for UMS_CRC_NONE.
+ */
+bool check_crc(ums_crc_t crc, const uint8_t *frame, size_t length);
+
+} // namespace ums::host
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef UMS_HOST_FRAME_DECODER_H
+#define UMS_HOST_FRAME_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "ums/copy_plan.h"
+#include "ums/crc.h"
+#include "ums/encoding.h"
+#include "ums/handshake.h"
+}
+
+namespace ums::host {
+
+/**
+ * One decoded sample.
+ * sequence is the frame sequence number, 0 without sequence numbers (see FrameDecoder::set_sequence()).
+ * payload holds the raw channel bytes in registration order, exactly as a UMS_ENCODING_RAW frame carries them.
+ * groups is the group mask of a multi-rate frame (see ums_trace_divided()), channels of groups not in the mask
+ * hold their last received value. 0 without sample groups.
+ */
+struct Sample {
+    uint32_t timestamp = 0;
+    uint16_t sequence = 0;
+    uint8_t groups = 0;
+    std::vector<uint8_t> payload;
+};
+
+enum class DecodeStatus {
+    ok,
+    incomplete,     // more bytes needed for this frame
+    no_keyframe,    // delta frame before the first keyframe (or changed/group frame before every channel was
+                    // seen), consumed but not decodable
+    invalid,        // malformed frame
+    corrupt,        // CRC trailer mismatch (see FrameDecoder::set_crc()), consumed but not decodable
+};
+
+struct DecodeResult {
+    DecodeStatus status = DecodeStatus::invalid;
+    size_t consumed = 0;
+};
+
+/**
+ * Bandwidth accounting, raw_bytes is what the same samples cost as UMS_ENCODING_RAW frames.
+ * sync_bytes is the part of wire_bytes spent on sync markers and re-sent handshakes (see FrameDecoder::set_sync()).
+ * lost counts the frames missing from the sequence numbers, in gaps separate runs of them, max_gap the longest run.
+ * Runs of 2^(8 * sequence size) frames or more cannot be told apart from shorter ones.
+ * crc_errors counts the corrupt frames among errors.
+ */
+struct DecoderStats {
+    uint64_t frames = 0;
+    uint64_t keyframes = 0;
+    uint64_t errors = 0;
+    uint64_t wire_bytes = 0;
+    uint64_t raw_bytes = 0;
+    uint64_t sync_markers = 0;
+    uint64_t sync_bytes = 0;
+    uint64_t lost = 0;
+    uint64_t gaps = 0;
+    uint64_t max_gap = 0;
+    uint64_t crc_errors = 0;
+
+    double compression_ratio() const {
+        return wire_bytes == 0 ? 0.0 : static_cast<double>(raw_bytes) / static_cast<double>(wire_bytes);
+    }
+
+    double loss_ratio() const {
+        return (frames + lost) == 0 ? 0.0 : static_cast<double>(lost) / static_cast<double>(frames + lost);
+    }
+};
+
+/**
+ * Reference decoder for the frame encodings produced by ums_create_sample().
+ * The layout (datatype per channel, in registration order) has to match the device registry.
+ */
+class FrameDecoder {
+public:
+    FrameDecoder(std::vector<ums_datatype_t> layout, ums_encoding_t encoding);
+
+    /**
+     * Declares the sample group of every channel (registration order), as set up with ums_trace_divided().
+     * Any group other than 0 switches the decoder to multi-rate frames.
+     * @return false if the size does not match the layout or a group is >= UMS_MAX_GROUPS.
+     */
+    bool set_groups(std::vector<uint8_t> groups);
+
+    /**
+     * Recognizes the sync markers of ums_set_resync() and re-sent handshakes of the layout with layout_hash
+     * (handshake_length bytes, 0 = none) in front of a frame and skips them.
+     * decode_stream() then continues at the next marker after an invalid frame instead of stopping.
+     */
+    void set_sync(uint32_t layout_hash, size_t handshake_length);
+
+    /**
+     * Reads the sequence number of ums_set_sequence() (size bytes, 0 = none) in front of every frame and
+     * accounts gaps in stats().
+     * @return false if size is larger than UMS_MAX_SEQUENCE_SIZE.
+     */
+    bool set_sequence(size_t size);
+
+    /**
+     * Checks the CRC trailer of ums_set_crc() behind every frame. A corrupt frame drops the delta reference, the
+     * decoder waits for the next keyframe then.
+     * @return false for an unknown ums_crc_t.
+     */
+    bool set_crc(ums_crc_t crc);
+
+    /**
+     * @return offset of the first sync marker in data, length if there is none. Requires set_sync().
+     */
+    size_t find_sync(const uint8_t *data, size_t length) const;
+
+    /**
+     * Decodes one frame at the start of data.
+     */
+    DecodeResult decode(const uint8_t *data, size_t length, Sample &sample);
+
+    /**
+     * Decodes back-to-back frames (a capture or a batch), appending decoded samples.
+     * Stops at the first incomplete or invalid frame, or with set_sync() at the first incomplete frame.
+     * Continues behind a corrupt frame, with set_sync() at the next marker since its boundary may be off.
+     * @return number of bytes consumed.
+     */
+    size_t decode_stream(const uint8_t *data, size_t length, std::vector<Sample> &samples);
+
+    /**
+     * Converts one channel of a decoded sample to double.
+     */
+    double value(const Sample &sample, size_t channel) const;
+
+    size_t raw_frame_size() const { return sizeof(uint32_t) + payload_size_; }
+    const std::vector<ums_datatype_t> &layout() const { return layout_; }
+    const DecoderStats &stats() const { return stats_; }
+
+private:
+    DecodeResult decode_raw(const uint8_t *data, size_t length, Sample &sample);
+    DecodeResult decode_delta(const uint8_t *data, size_t length, Sample &sample);
+    DecodeResult decode_changed(const uint8_t *data, size_t length, Sample &sample);
+    DecodeResult decode_grouped(const uint8_t *data, size_t length, Sample &sample);
+    DecodeResult skip_sync(const uint8_t *data, size_t length, size_t &markers, size_t &frame_start);
+    bool check_trailer(const uint8_t *frame, size_t covered, size_t available, DecodeResult &result);
+    void track_sequence(uint16_t sequence);
+
+    std::vector<ums_datatype_t> layout_;
+    std::vector<size_t> offsets_;
+    size_t payload_size_ = 0;
+    ums_encoding_t encoding_;
+    std::vector<uint8_t> groups_;
+    size_t group_sizes_[UMS_MAX_GROUPS] = {};
+    bool multi_rate_ = false;
+
+    bool sync_ = false;
+    uint8_t sync_marker_[UMS_SYNC_MARKER_SIZE] = {};
+    uint8_t handshake_header_[UMS_HANDSHAKE_HEADER_SIZE] = {};
+    size_t handshake_length_ = 0;
+
+    size_t sequence_size_ = 0;
+    bool have_sequence_ = false;
+    uint16_t next_sequence_ = 0;
+
+    ums_crc_t crc_ = UMS_CRC_NONE;
+    std::vector<uint8_t> saved_reference_;
+    std::vector<bool> saved_known_;
+
+    bool have_reference_ = false;
+    uint32_t prev_timestamp_ = 0;
+    std::vector<uint8_t> reference_;
+    std::vector<bool> known_;
+
+    DecoderStats stats_;
+};
+
+/**
+ * Parses a datatype name as used by the host tools: u8 u16 u32 u64 i8 i16 i32 i64 f32 f64 bool.
+ * @return false for unknown names.
+ */
+bool parse_datatype(const std::string &name, ums_datatype_t &type);
+
+} // namespace ums::host
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef UMS_HOST_HANDSHAKE_H
+#define UMS_HOST_HANDSHAKE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ums/host/frame_decoder.h"
+
+extern "C" {
+#include "ums/handshake.h"
+}
+
+namespace ums::host {
+
+/**
+ * One decodable channel of the frame, in payload order.
+ * Blocks are expanded into name[i] elements and structs into name.field members, so every entry is a scalar.
+ * padding marks struct bytes not covered by a field (one UMS_UINT8 entry per byte, empty name).
+ */
+struct HandshakeChannel {
+    std::string name;
+    ums_datatype_t type = UMS_UINT8;
+    uint8_t group = 0;
+    bool padding = false;
+};
+
+/**
+ * Layout announced by ums_send_handshake().
+ */
+struct Handshake {
+    uint32_t layout_hash = 0;
+    size_t length = 0;      // packet bytes
+    ums_encoding_t encoding = UMS_ENCODING_RAW;
+    uint8_t sequence_size = 0;  // bytes of the sequence number in front of each frame
+    ums_crc_t crc = UMS_CRC_NONE;   // trailer behind each frame and the handshake
+    std::vector<uint16_t> group_dividers;
+    std::vector<HandshakeChannel> channels;
+
+    /**
+     * Datatype per channel, to construct a FrameDecoder.
+     */
+    std::vector<ums_datatype_t> layout() const;
+
+    /**
+     * Group per channel, for FrameDecoder::set_groups().
+     */
+    std::vector<uint8_t> groups() const;
+
+    /**
+     * A FrameDecoder set up for this layout, encoding, groups, sequence numbers and CRC, skipping sync markers and
+     * re-sent handshakes.
+     */
+    FrameDecoder make_decoder() const;
+};
+
+/**
+ * Parses a handshake packet at the start of data and checks its layout hash and CRC trailer.
+ * ok = consumed bytes, incomplete = more bytes needed, invalid = not a (supported) handshake.
+ */
+DecodeResult parse_handshake(const uint8_t *data, size_t length, Handshake &handshake);
+
+/**
+ * Scans data for the first complete, valid handshake, to attach to a stream that is already running.
+ * @return offset of the handshake, length if there is none.
+ */
+size_t find_handshake(const uint8_t *data, size_t length, Handshake &handshake);
+
+} // namespace ums::host
+
+#endif
@@ -0,0 +1,243 @@
+// ums_decode: decodes a captured UMS sample stream and reports the bandwidth it used.
+//
+// usage: ums_decode --layout f32,u8,i16 [--groups 0,0,1] [--encoding raw|delta|changed] [--csv] capture.bin
+//        ums_decode --handshake [--csv] capture.bin   (decodes from the first ums_send_handshake() packet on,
+//                                                      the capture may start mid-stream)
+//        add --cobs for a capture sent with ums_set_framing(UMS_FRAMING_COBS)
+//        add --sequence 1|2 without --handshake for frames numbered with ums_set_sequence()
+//        add --crc 16|32 without --handshake for frames checked with ums_set_crc()
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ums/host/cobs.h"
+#include "ums/host/frame_decoder.h"
+#include "ums/host/handshake.h"
+
+using ums::host::DecodeStatus;
+using ums::host::FrameDecoder;
+using ums::host::Handshake;
+using ums::host::Sample;
+
+static int usage() {
+    fprintf(stderr, "usage: ums_decode --layout <type,type,...> [--groups <group,group,...>]\n"
+                    "                  [--encoding raw|delta|changed] [--csv] <capture>\n"
+                    "       ums_decode --handshake [--csv] <capture>\n"
+                    "       --cobs: capture is COBS framed\n"
+                    "       --sequence <bytes>: frames carry a sequence number (implied by --handshake)\n"
+                    "       --crc 16|32: frames carry a CRC trailer (implied by --handshake)\n"
+                    "types: u8 u16 u32 u64 i8 i16 i32 i64 f32 f64 bool\n");
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    std::vector<ums_datatype_t> layout;
+    std::vector<uint8_t> groups;
+    ums_encoding_t encoding = UMS_ENCODING_RAW;
+    bool csv = false;
+    bool handshake = false;
+    bool cobs = false;
+    size_t sequence = 0;
+    ums_crc_t crc = UMS_CRC_NONE;
+    const char *path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--layout") == 0 && i + 1 < argc) {
+            std::stringstream list(argv[++i]);
+            std::string name;
+            while (std::getline(list, name, ',')) {
+                ums_datatype_t type;
+                if (!ums::host::parse_datatype(name, type)) {
+                    fprintf(stderr, "unknown type '%s'\n", name.c_str());
+                    return usage();
+                }
+                layout.push_back(type);
+            }
+        } else if (strcmp(argv[i], "--groups") == 0 && i + 1 < argc) {
+            std::stringstream list(argv[++i]);
+            std::string group;
+            while (std::getline(list, group, ',')) {
+                groups.push_back(static_cast<uint8_t>(std::stoul(group)));
+            }
+        } else if (strcmp(argv[i], "--encoding") == 0 && i + 1 < argc) {
+            const std::string name = argv[++i];
+            if (name == "raw") {
+                encoding = UMS_ENCODING_RAW;
+            } else if (name == "delta") {
+                encoding = UMS_ENCODING_DELTA;
+            } else if (name == "changed") {
+                encoding = UMS_ENCODING_CHANGED;
+            } else {
+                return usage();
+            }
+        } else if (strcmp(argv[i], "--handshake") == 0) {
+            handshake = true;
+        } else if (strcmp(argv[i], "--cobs") == 0) {
+            cobs = true;
+        } else if (strcmp(argv[i], "--sequence") == 0 && i + 1 < argc) {
+            sequence = std::stoul(argv[++i]);
+        } else if (strcmp(argv[i], "--crc") == 0 && i + 1 < argc) {
+            const std::string bits = argv[++i];
+            if (bits == "16") {
+                crc = UMS_CRC_16;
+            } else if (bits == "32") {
+                crc = UMS_CRC_32;
+            } else {
+                return usage();
+            }
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            return usage();
+        }
+    }
+    if ((layout.empty() == !handshake) || !path) {
+        return usage();
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+    const std::vector<uint8_t> capture((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // A COBS capture is split into transfers first, a frame that does not decode then costs only itself.
+    ums::host::Deframer deframer;
+    if (cobs) {
+        deframer.feed(capture.data(), capture.size());
+    }
+
+    size_t start = 0;
+    size_t first_frame = 0;
+    Handshake info;
+    if (handshake && cobs) {
+        for (; first_frame < deframer.frame_count(); first_frame++) {
+            size_t length = 0;
+            const uint8_t *frame = deframer.frame(first_frame, length);
+            if (ums::host::parse_handshake(frame, length, info).status == DecodeStatus::ok) {
+                break;
+            }
+        }
+        if (first_frame == deframer.frame_count()) {
+            fprintf(stderr, "no valid handshake in %s\n", path);
+            return 1;
+        }
+        first_frame++;
+        layout = info.layout();
+        encoding = info.encoding;
+    } else if (handshake) {
+        const size_t offset = ums::host::find_handshake(capture.data(), capture.size(), info);
+        if (offset == capture.size()) {
+            fprintf(stderr, "no valid handshake in %s\n", path);
+            return 1;
+        }
+        if (offset != 0) {
+            fprintf(stderr, "attached:    skipped %zu bytes before the handshake\n", offset);
+        }
+        start = offset + info.length;
+        layout = info.layout();
+        encoding = info.encoding;
+    }
+
+    FrameDecoder decoder = handshake ? info.make_decoder() : FrameDecoder(layout, encoding);
+    if (!groups.empty() && !decoder.set_groups(groups)) {
+        fprintf(stderr, "--groups needs one group < %u per channel\n", UMS_MAX_GROUPS);
+        return usage();
+    }
+    if (!handshake && !decoder.set_sequence(sequence)) {
+        fprintf(stderr, "--sequence is at most %u bytes\n", UMS_MAX_SEQUENCE_SIZE);
+        return usage();
+    }
+    if (!handshake) {
+        decoder.set_crc(crc);
+    }
+    std::vector<Sample> samples;
+    size_t consumed = 0;
+    if (cobs) {
+        for (size_t i = first_frame; i < deframer.frame_count(); i++) {
+            size_t length = 0;
+            const uint8_t *frame = deframer.frame(i, length);
+            Handshake again;
+            if (handshake && ums::host::parse_handshake(frame, length, again).status == DecodeStatus::ok) {
+                continue;
+            }
+            Sample sample;
+            const auto result = decoder.decode(frame, length, sample);
+            if (result.status == DecodeStatus::ok && result.consumed == length) {
+                samples.push_back(std::move(sample));
+            }
+        }
+        consumed = capture.size() - deframer.pending();
+        fprintf(stderr, "cobs:        %llu frames, %llu malformed\n",
+                static_cast<unsigned long long>(deframer.stats().frames),
+                static_cast<unsigned long long>(deframer.stats().errors));
+    } else {
+        consumed = start + decoder.decode_stream(capture.data() + start, capture.size() - start, samples);
+    }
+
+    if (csv) {
+        if (handshake) {
+            printf("timestamp");
+            for (const auto &channel : info.channels) {
+                printf(",%s", channel.padding ? "" : channel.name.c_str());
+            }
+            printf("\n");
+        }
+        for (const Sample &sample : samples) {
+            printf("%u", sample.timestamp);
+            for (size_t channel = 0; channel < layout.size(); channel++) {
+                printf(",%.9g", decoder.value(sample, channel));
+            }
+            printf("\n");
+        }
+    }
+
+    const auto &stats = decoder.stats();
+    fprintf(stderr,
+            "frames:      %llu (%llu keyframes, %llu errors)\n"
+            "wire bytes:  %llu\n"
+            "raw bytes:   %llu\n"
+            "ratio:       %.2fx\n"
+            "sync:        %llu bytes (%llu markers)\n"
+            "trailing:    %zu bytes not decoded\n",
+            static_cast<unsigned long long>(stats.frames), static_cast<unsigned long long>(stats.keyframes),
+            static_cast<unsigned long long>(stats.errors), static_cast<unsigned long long>(stats.wire_bytes),
+            static_cast<unsigned long long>(stats.raw_bytes), stats.compression_ratio(),
+            static_cast<unsigned long long>(stats.sync_bytes), static_cast<unsigned long long>(stats.sync_markers),
+            capture.size() - consumed);
+    if ((handshake ? info.crc : crc) != UMS_CRC_NONE) {
+        fprintf(stderr, "crc:         %llu corrupt frames\n", static_cast<unsigned long long>(stats.crc_errors));
+    }
+    if (handshake ? info.sequence_size != 0 : sequence != 0) {
+        fprintf(stderr, "sequence:    %llu frames lost in %llu gaps (longest %llu), %.3f%% loss\n",
+                static_cast<unsigned long long>(stats.lost), static_cast<unsigned long long>(stats.gaps),
+                static_cast<unsigned long long>(stats.max_gap), 100.0 * stats.loss_ratio());
+    }
+    // ums_set_rate_limit(): every frame stands for "ums.decimation" ums_update() calls
+    for (size_t channel = 0; handshake && channel < info.channels.size(); channel++) {
+        if (info.channels[channel].name != "ums.decimation" || samples.empty()) {
+            continue;
+        }
+        double updates = 0.0;
+        double min_factor = decoder.value(samples.front(), channel);
+        double max_factor = min_factor;
+        for (const Sample &sample : samples) {
+            const double factor = decoder.value(sample, channel);
+            updates += factor;
+            min_factor = std::min(min_factor, factor);
+            max_factor = std::max(max_factor, factor);
+        }
+        fprintf(stderr, "decimation:  %.0f updates in %zu frames (factor %.0f..%.0f)\n", updates, samples.size(),
+                min_factor, max_factor);
+    }
+    return 0;
+}
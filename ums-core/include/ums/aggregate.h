@@ -0,0 +1,102 @@
+//
+//
+//
+
+#ifndef UMS_AGGREGATE_H
+#define UMS_AGGREGATE_H
+
+#include "stdint.h"
+
+#include "ums/datatype.h"
+#include "ums/error.h"
+
+/**
+ * What a decimated channel transmits in place of a single sample (see ums_trace_aggregated()).
+ * The aggregate covers every ums_update() tick since the previous frame of the channel's group,
+ * and keeps the channel's datatype, so the frame layout does not change.
+ * UMS_AGGREGATE_MEAN of integer types is truncated toward zero.
+ */
+typedef enum ums_aggregate_t {
+    UMS_AGGREGATE_MIN   = 0,
+    UMS_AGGREGATE_MAX   = 1,
+    UMS_AGGREGATE_MEAN  = 2,
+} ums_aggregate_t;
+
+/**
+ * Accumulator domain, derived from ums_datatype_t once at registration.
+ */
+typedef enum ums_aggregate_domain_t {
+    UMS_AGGREGATE_UNSIGNED  = 0,
+    UMS_AGGREGATE_SIGNED    = 1,
+    UMS_AGGREGATE_FLOAT     = 2,
+} ums_aggregate_domain_t;
+
+/**
+ * Maps a datatype to its accumulator domain.
+ * @param [in] type ums_datatype_t value.
+ * @return ums_aggregate_domain_t value, UMS_AGGREGATE_UNSIGNED for unsigned types and UMS_BOOL.
+ */
+static inline uint8_t ums_aggregate_domain(const ums_datatype_t type)
+{
+    switch (type)
+    {
+    case UMS_INT8:
+    case UMS_INT16:
+    case UMS_INT32:
+    case UMS_INT64:   return UMS_AGGREGATE_SIGNED;
+    case UMS_FLOAT32:
+    case UMS_FLOAT64: return UMS_AGGREGATE_FLOAT;
+    default:          return UMS_AGGREGATE_UNSIGNED;
+    }
+}
+
+typedef union ums_aggregate_value_t
+{
+    uint64_t    u;
+    int64_t     i;
+    double      f;
+} ums_aggregate_value_t;
+
+/**
+ * Running min/max/sum of one traced variable.
+ * All three are updated on every tick (branch-free select), mode only picks the one written to result.
+ * result holds the finished aggregate in the channel's datatype and is the copy plan source of the channel.
+ * The sum of 64 bit integers wraps on overflow.
+ */
+typedef struct ums_aggregator_t
+{
+    const void*             src_ptr;
+    uint8_t                 type;
+    uint8_t                 domain;
+    uint8_t                 mode;
+    uint8_t                 group;
+    uint32_t                count;
+    ums_aggregate_value_t   min;
+    ums_aggregate_value_t   max;
+    ums_aggregate_value_t   sum;
+    uint8_t                 result[8];
+} ums_aggregator_t;
+
+/**
+ * Sets up an aggregator for one traced variable.
+ * @param [out] agg aggregator to initialize.
+ * @param [in] src_ptr address of the traced variable.
+ * @param [in] type datatype of the traced variable, UMS_STRING is not supported.
+ * @param [in] mode aggregate to transmit.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_aggregator_init(ums_aggregator_t *agg, const void *src_ptr, ums_datatype_t type, ums_aggregate_t mode);
+
+/**
+ * Adds the current value of the traced variable, called on every ums_update() tick.
+ * @param [in,out] agg aggregator.
+ */
+void ums_aggregator_accumulate(ums_aggregator_t *agg);
+
+/**
+ * Writes the aggregate over the ticks since the last call to result and starts a new window.
+ * @param [in,out] agg aggregator.
+ */
+void ums_aggregator_finish(ums_aggregator_t *agg);
+
+#endif
@@ -0,0 +1,22 @@
+//
+//
+//
+
+#ifndef UMS_ATOMIC_H
+#define UMS_ATOMIC_H
+
+#include "stdint.h"
+
+/**
+ * Word used for state shared between the sampling context and the transfer complete ISR.
+ * C sources access it through C11 <stdatomic.h>. C++ sources (tests, host tools) only see a
+ * plain uint32_t with the same size and alignment and must not modify it directly.
+ */
+#if defined(__cplusplus)
+typedef uint32_t ums_atomic_u32;
+#else
+#include "stdatomic.h"
+typedef _Atomic uint32_t ums_atomic_u32;
+#endif
+
+#endif
@@ -0,0 +1,100 @@
+//
+//
+//
+
+#ifndef UMS_BATCH_H
+#define UMS_BATCH_H
+
+#include "stdint.h"
+
+#include "ums/error.h"
+
+/**
+ * Packs consecutive frames back-to-back into one transmit buffer.
+ * The caller-owned buffer is split into two halves: one is filled by ums_update() while the other is
+ * under transmission. A half is sealed once it holds frames_per_batch frames, the next frame no longer fits,
+ * timeout ticks passed since its first frame (checked on every ums_update(), frame or not), or on ums_flush().
+ * tx_pending marks a sealed half that waits for the link, tx_busy a half under transmission holding
+ * tx_frame_count frames.
+ */
+typedef struct ums_batch_t
+{
+    uint8_t*    buffer;
+    uint16_t    half_size;
+    uint8_t     frames_per_batch;
+    uint32_t    timeout;
+
+    uint8_t     fill_half;
+    uint8_t     frame_count;
+    uint16_t    fill_length;
+    uint32_t    first_timestamp;
+
+    volatile bool tx_pending;
+    volatile bool tx_busy;
+    uint8_t     tx_frame_count;
+} ums_batch_t;
+
+/**
+ * Initializes an empty batch.
+ * @param [out] batch batch to initialize.
+ * @param [in] buffer caller-owned storage for both halves (must remain in scope).
+ * @param [in] buffer_size size of buffer in bytes, each half holds buffer_size / 2.
+ * @param [in] frames_per_batch frames per transfer (K), at least 1.
+ * @param [in] timeout ticks of ums_platform_get_timestamp() after which a partial batch is sent, 0 = never.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_batch_init(ums_batch_t *batch, uint8_t *buffer, uint16_t buffer_size, uint8_t frames_per_batch,
+                         uint32_t timeout);
+
+/**
+ * Returns where the next frame of up to max_frame_size bytes is to be written.
+ * Seals the current half first when such a frame would not fit anymore.
+ * @param [in,out] batch batch to append to.
+ * @param [in] max_frame_size largest possible size of the next frame in bytes.
+ * @return write position, nullptr while the filled half still waits for the link.
+ */
+uint8_t* ums_batch_reserve(ums_batch_t *batch, uint16_t max_frame_size);
+
+/**
+ * Appends the frame written at the position returned by ums_batch_reserve().
+ * Seals the half when it is full, another max_frame_size frame would not fit, or the timeout expired.
+ * @param [in,out] batch batch to append to.
+ * @param [in] frame_size size of the written frame in bytes.
+ * @param [in] max_frame_size largest possible size of the next frame in bytes.
+ * @param [in] timestamp timestamp of the written frame.
+ * @return true when the half got sealed and should be transmitted.
+ */
+bool ums_batch_commit(ums_batch_t *batch, uint16_t frame_size, uint16_t max_frame_size, uint32_t timestamp);
+
+/**
+ * Seals the current half once timeout ticks passed since its first frame, for when no further frame is committed.
+ * @param [in,out] batch batch to check.
+ * @param [in] timestamp current timestamp.
+ * @return true when the half got sealed and should be transmitted.
+ */
+bool ums_batch_expire(ums_batch_t *batch, uint32_t timestamp);
+
+/**
+ * Seals the current half if it holds at least one frame.
+ * @param [in,out] batch batch to seal.
+ */
+void ums_batch_seal(ums_batch_t *batch);
+
+/**
+ * Claims the sealed half for transmission if the link is idle and switches filling to the other half.
+ * Must not be interrupted by ums_batch_complete(), call inside the platform critical section.
+ * @param [in,out] batch batch to claim from.
+ * @param [out] length number of bytes to transmit.
+ * @return start of the data to transmit, nullptr when busy or nothing is sealed.
+ */
+uint8_t* ums_batch_claim(ums_batch_t *batch, uint16_t *length);
+
+/**
+ * Releases the transmitted half and claims the next sealed one, see ums_batch_claim().
+ * @param [in,out] batch batch to release.
+ * @param [out] length number of bytes to transmit.
+ * @return start of the data to transmit, nullptr when nothing is sealed.
+ */
+uint8_t* ums_batch_complete(ums_batch_t *batch, uint16_t *length);
+
+#endif
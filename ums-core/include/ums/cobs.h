@@ -0,0 +1,54 @@
+//
+//
+//
+
+#ifndef UMS_COBS_H
+#define UMS_COBS_H
+
+#include "stdint.h"
+
+#include "ums/triple_buffer.h"
+
+/**
+ * Framing of whatever reaches the transmit function.
+ * UMS_FRAMING_NONE   frames go out as packed, the host relies on their sizes (or sync markers) for boundaries.
+ * UMS_FRAMING_COBS   every frame and handshake is Consistent Overhead Byte Stuffed and followed by a 0x00
+ *                    delimiter, so a lost or corrupted byte costs one frame instead of the alignment.
+ */
+typedef enum ums_framing_t {
+    UMS_FRAMING_NONE    = 0,
+    UMS_FRAMING_COBS    = 1,
+} ums_framing_t;
+
+#define UMS_COBS_DELIMITER      0x00U
+
+/** Longest run a code byte can describe, a code of 0xFF means 254 bytes without a following zero. */
+#define UMS_COBS_MAX_RUN        254U
+
+/** Worst case growth of length bytes: one code byte per started run plus the delimiter. */
+#define UMS_COBS_MAX_OVERHEAD(length) (((length) / UMS_COBS_MAX_RUN) + 2U)
+
+#if (UMS_MAX_WIRE_FRAME_SIZE - UMS_COBS_OVERHEAD) > UMS_COBS_MAX_RUN
+#error "Sample frames have to fit one COBS run to be stuffed in place"
+#endif
+
+/**
+ * Stuffs a frame in place. The frame is packed at frame_ptr + 1, frame_ptr[0] is reserved for the first code byte,
+ * frame_ptr[length + 1] receives the delimiter. Each zero is replaced by the distance to the next one, no byte moves.
+ * @param [in,out] frame_ptr frame buffer, length + UMS_COBS_OVERHEAD bytes.
+ * @param [in] length packed frame length, at most UMS_COBS_MAX_RUN.
+ * @return stuffed length in bytes, delimiter included (length + UMS_COBS_OVERHEAD).
+ */
+uint16_t ums_cobs_stuff(uint8_t *frame_ptr, uint16_t length);
+
+/**
+ * Encodes any length, for packets longer than one run (the handshake).
+ * dst_ptr may alias src_ptr - UMS_COBS_MAX_OVERHEAD(length), the output never overtakes the input.
+ * @param [in] src_ptr bytes to encode.
+ * @param [in] length number of bytes.
+ * @param [out] dst_ptr destination, at least length + UMS_COBS_MAX_OVERHEAD(length) bytes.
+ * @return encoded length in bytes, delimiter included.
+ */
+uint16_t ums_cobs_encode(const uint8_t *src_ptr, uint16_t length, uint8_t *dst_ptr);
+
+#endif
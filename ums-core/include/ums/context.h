@@ -0,0 +1,175 @@
+//
+//
+//
+
+#ifndef UMS_CONTEXT_H
+#define UMS_CONTEXT_H
+
+#include "stdint.h"
+
+#include "ums/aggregate.h"
+#include "ums/batch.h"
+#include "ums/cobs.h"
+#include "ums/copy_plan.h"
+#include "ums/crc.h"
+#include "ums/encoding.h"
+#include "ums/frame_queue.h"
+#include "ums/handshake.h"
+#include "ums/instrumentation.h"
+#include "ums/scope_ring.h"
+#include "ums/trigger.h"
+#include "ums/triple_buffer.h"
+
+/**
+ * Function pointer to user-defined transmit function, e.g. "HAL_UART_TRANSMIT_DMA()"
+ * Requires pointer to the data to be sent: void *data_ptr.
+ * Requires uint16_t length in bytes of what to send.
+ */
+typedef void (*transmit_function)(void *data_ptr, uint16_t length);
+
+/**
+ * One element of a gather list: length bytes starting at base.
+ */
+typedef struct ums_iovec_t
+{
+    const void*     base;
+    uint16_t        length;
+} ums_iovec_t;
+
+/**
+ * Function pointer to a user-defined gather transmit function, e.g. a DMA linked-list transfer or writev().
+ * Requires the gather list iov with iov_count elements, sent back-to-back they form one frame.
+ * Requires uint16_t length in bytes of the whole frame.
+ */
+typedef void (*gather_transmit_function)(const ums_iovec_t *iov, uint8_t iov_count, uint16_t length);
+
+/**
+ * Sample accounting of one stream, see ums_get_link_stats().
+ * captured    samples taken by ums_update()/ums_capture(), gated or not due ticks excluded. Each one consumes a
+ *             sequence number (see ums_set_sequence()), whether it is sent or not.
+ * dropped     captured samples lost on the device: rejected with UMS_BUFFER_FULL, evicted from a UMS_DROP_OLDEST
+ *             queue, replaced in the triple buffer before they were sent, or in scope mode overwritten in the
+ *             ring, discarded by ums_scope_arm() or not recorded while a window is frozen, draining or done.
+ * transmitted sample frames whose transfer completed, handshakes excluded.
+ * Frames neither dropped nor transmitted are still buffered (or recorded by the scope). Sequence gaps on the host
+ * beyond dropped were lost on the wire.
+ */
+typedef struct ums_link_stats_t
+{
+    uint32_t    captured;
+    uint32_t    dropped;
+    uint32_t    transmitted;
+} ums_link_stats_t;
+
+#define UMS_RATE_LIMIT_RECOVERY 64U
+
+/**
+ * Capture decimation of ums_set_rate_limit(), active while bytes_per_second is not 0.
+ * base_factor keeps worst-case frames of frame_size bytes within bytes_per_second at update_rate, factor is the one
+ * applied: raised when a capture is dropped anyway, lowered back to base_factor after UMS_RATE_LIMIT_RECOVERY clean
+ * captures in a row. countdown counts updates towards the next capture, ticks the updates since the last capture,
+ * decimation is the traced "ums.decimation" channel: the updates the current frame stands for.
+ */
+typedef struct ums_rate_limit_t
+{
+    uint32_t    bytes_per_second;
+    uint32_t    update_rate;
+    uint16_t    frame_size;
+    uint16_t    base_factor;
+    uint16_t    factor;
+    uint16_t    countdown;
+    uint16_t    ticks;
+    uint16_t    decimation;
+    uint16_t    clean_captures;
+    bool        traced;
+} ums_rate_limit_t;
+
+/**
+ * Complete state of one sample stream, so several independent streams (e.g. one per UART) can run in one firmware.
+ * Caller-owned, pass it to the ums_ctx_* functions and treat the members as private.
+ * The ums_* functions without ctx operate on a library-owned default context.
+ *
+ * triple_buffer     slot indices, fresh and busy flag share one atomic word (see ums_triple_buffer_t).
+ * delivery          how packed samples reach the transmit function (triple buffer, queue, batch or scope).
+ * framing           ums_framing_t applied to every frame and the handshake, see ums_set_framing().
+ * crc               ums_crc_t trailer of every frame and the handshake, see ums_set_crc().
+ * sequence_size     bytes of the sequence number in front of every frame, the low bits of link_stats.captured.
+ * rate_limit        capture decimation from ums_set_rate_limit().
+ * instrumentation   hot path timing from ums_set_instrumentation(), only measured while enabled.
+ * registry          metadata of every traced channel, channel_count entries in registration order.
+ * actual_frame_size raw frame size, timestamp plus all traced channels.
+ * group_divider     sample groups created by ums_trace_divided(), group 0 always has divider 1.
+ *                   A group is due when its countdown reaches 0, due_groups holds the groups due on the current tick.
+ * aggregators       aggregated channels from ums_trace_aggregated(), accumulated on every ums_update() tick and
+ *                   finished by the frame that carries them.
+ * trigger           trigger from ums_trigger_setup(), op_count 0 = disabled.
+ * gather_list       gather list from ums_gather_setup(): the sync marker, gather_sequence (when enabled), the
+ *                   timestamp, then one element per copy plan op, pointing straight at the traced variables.
+ *                   gather_busy is set while the list is on the wire, gather_sync when the pending list starts at
+ *                   the marker.
+ * handshake         last handshake packet built by ums_send_handshake(), handshake_length bytes. handshake_state
+ *                   tracks it from pending to on the wire, while it is on the wire no sample frame is started.
+ *                   Stored framed, with COBS framing it is built behind the room for the stuffing overhead and
+ *                   encoded forward in place.
+ * sync_marker       marker put in front of every sync_interval-th frame by ums_set_resync(), sync_countdown
+ *                   frames to go. sync_carry is set while the last frame packed carries the marker, a frame
+ *                   replacing it before it was sent takes the marker over.
+ *                   handshake_interval re-queues the handshake every that many timestamp ticks, counted from
+ *                   handshake_timestamp.
+ */
+typedef struct ums_context_t
+{
+    transmit_function   transmit_function_ptr;
+    bool                initialized;
+    uint8_t             delivery;
+    uint8_t             encoding;
+    uint8_t             framing;
+    uint8_t             crc;
+    uint8_t             sequence_size;
+    ums_link_stats_t    link_stats;
+    ums_rate_limit_t    rate_limit;
+    ums_instrumentation_t instrumentation;
+
+    data_channel_t      registry[UMS_MAX_CHANNELS];
+    uint8_t             channel_count;
+    uint16_t            actual_frame_size;
+    ums_copy_plan_t     copy_plan;
+
+    uint16_t            group_divider[UMS_MAX_GROUPS];
+    uint16_t            group_countdown[UMS_MAX_GROUPS];
+    uint8_t             group_count;
+    uint8_t             due_groups;
+
+    ums_aggregator_t    aggregators[UMS_MAX_CHANNELS];
+    uint8_t             aggregator_count;
+    ums_trigger_t       trigger;
+
+    ums_triple_buffer_t triple_buffer;
+    ums_frame_queue_t   frame_queue;
+    ums_batch_t         batch;
+    ums_scope_ring_t    scope;
+    ums_delta_encoder_t delta_encoder;
+
+    gather_transmit_function gather_function_ptr;
+    ums_iovec_t         gather_list[UMS_MAX_CHANNELS + 3U];
+    uint8_t             gather_count;
+    uint32_t            gather_timestamp;
+    uint16_t            gather_sequence;
+    bool                gather_pending;
+    volatile bool       gather_busy;
+    bool                gather_sync;
+
+    uint8_t             handshake[UMS_HANDSHAKE_MAX_SIZE + UMS_COBS_MAX_OVERHEAD(UMS_HANDSHAKE_MAX_SIZE)];
+    uint16_t            handshake_length;
+    uint32_t            layout_hash;
+    volatile uint8_t    handshake_state;
+
+    uint8_t             sync_marker[UMS_SYNC_MARKER_SIZE];
+    uint16_t            sync_interval;
+    uint16_t            sync_countdown;
+    bool                sync_carry;
+    uint32_t            handshake_interval;
+    uint32_t            handshake_timestamp;
+} ums_context_t;
+
+#endif
@@ -0,0 +1,111 @@
+//
+//
+//
+
+#ifndef UMS_COPY_PLAN_H
+#define UMS_COPY_PLAN_H
+
+#include "stdint.h"
+
+#include "ums/error.h"
+#include "ums/triple_buffer.h"
+
+#define UMS_MAX_GROUPS      8U
+
+/**
+ * Width of a single copy operation.
+ * Fixed-width kinds compile down to one load/store pair, UMS_COPY_BLOCK is used
+ * for merged channels whose combined length is not a native width.
+ */
+typedef enum ums_copy_kind_t {
+    UMS_COPY_8BIT   = 0,
+    UMS_COPY_16BIT  = 1,
+    UMS_COPY_32BIT  = 2,
+    UMS_COPY_64BIT  = 3,
+    UMS_COPY_BLOCK  = 4,
+} ums_copy_kind_t;
+
+/**
+ * One precompiled copy from a traced address into the sample payload.
+ * src_ptr points to the first traced byte.
+ * dst_offset is the byte offset inside sample_packet_t.data.
+ * length is the number of bytes copied, kind is derived from it.
+ */
+typedef struct ums_copy_op_t
+{
+    const void*     src_ptr;
+    uint16_t        dst_offset;
+    uint16_t        length;
+    uint8_t         kind;
+} ums_copy_op_t;
+
+/**
+ * Segment of the plan that belongs to one sample group (see ums_trace_divided()).
+ * first_op/op_count select the group's ops, payload_offset/payload_size its bytes in the full payload.
+ */
+typedef struct ums_copy_group_t
+{
+    uint8_t         first_op;
+    uint8_t         op_count;
+    uint16_t        payload_offset;
+    uint16_t        payload_size;
+} ums_copy_group_t;
+
+/**
+ * Copy plan compiled from the channel registry.
+ * Ops are ordered by group, then by registration order, and dst_offset is relative to the full payload
+ * with all groups back-to-back. Without groups everything lives in group 0 (registration order).
+ * Channels of the same group whose source addresses are adjacent in registration order share one op,
+ * so op_count <= number of traced channels.
+ * payload_size is the total number of payload bytes written per sample.
+ */
+typedef struct ums_copy_plan_t
+{
+    ums_copy_op_t       ops[UMS_MAX_CHANNELS];
+    ums_copy_group_t    groups[UMS_MAX_GROUPS];
+    uint8_t             op_count;
+    uint16_t            payload_size;
+} ums_copy_plan_t;
+
+/**
+ * Clears all ops from the plan.
+ * @param [out] plan copy plan to reset.
+ */
+void ums_copy_plan_reset(ums_copy_plan_t *plan);
+
+/**
+ * Appends a traced variable to the plan, merging it into the previous op when
+ * its address directly follows the previous source block.
+ * @param [in,out] plan copy plan to extend.
+ * @param [in] src_ptr address of the traced variable.
+ * @param [in] length size of the traced variable in bytes.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_copy_plan_append(ums_copy_plan_t *plan, const void *src_ptr, uint16_t length);
+
+/**
+ * Like ums_copy_plan_append(), but for a given group. The payload of later groups moves back by length.
+ * @param [in,out] plan copy plan to extend.
+ * @param [in] group group index, < UMS_MAX_GROUPS.
+ * @param [in] src_ptr address of the traced variable.
+ * @param [in] length size of the traced variable in bytes.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_copy_plan_append_group(ums_copy_plan_t *plan, uint8_t group, const void *src_ptr, uint16_t length);
+
+/**
+ * Executes the plan, copying every traced variable into the payload.
+ * @param [in] plan compiled copy plan.
+ * @param [out] dst_ptr start of the sample payload, at least plan->payload_size bytes.
+ */
+void ums_copy_plan_execute(const ums_copy_plan_t *plan, uint8_t *dst_ptr);
+
+/**
+ * Executes the ops of one group only.
+ * @param [in] plan compiled copy plan.
+ * @param [in] group group index, < UMS_MAX_GROUPS.
+ * @param [out] dst_ptr start of the group's block, at least plan->groups[group].payload_size bytes.
+ */
+void ums_copy_plan_execute_group(const ums_copy_plan_t *plan, uint8_t group, uint8_t *dst_ptr);
+
+#endif
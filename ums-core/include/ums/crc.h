@@ -0,0 +1,56 @@
+//
+//
+//
+
+#ifndef UMS_CRC_H
+#define UMS_CRC_H
+
+#include "stdint.h"
+
+/**
+ * Integrity check appended to every frame and handshake, little endian, see ums_set_crc().
+ * UMS_CRC_NONE   no trailer.
+ * UMS_CRC_16     CRC-16/MODBUS: polynomial 0x8005 reflected, init 0xFFFF, no final xor, 2 bytes.
+ * UMS_CRC_32     CRC-32/ISO-HDLC (Ethernet, zlib): polynomial 0x04C11DB7 reflected, init and final xor
+ *                0xFFFFFFFF, 4 bytes.
+ * The trailer covers the frame from its sync marker (if any) to its last payload byte. With COBS framing it is
+ * appended before stuffing, so it is checked on the decoded frame.
+ */
+typedef enum ums_crc_t {
+    UMS_CRC_NONE    = 0,
+    UMS_CRC_16      = 1,
+    UMS_CRC_32      = 2,
+} ums_crc_t;
+
+/**
+ * @param [in] crc trailer kind.
+ * @return trailer size in bytes, 0 for UMS_CRC_NONE.
+ */
+uint8_t ums_crc_size(ums_crc_t crc);
+
+/**
+ * CRC-16/MODBUS in software, slice-by-4: one 32 bit load and four table lookups per word.
+ * @param [in] data bytes to check.
+ * @param [in] length number of bytes.
+ * @return CRC value.
+ */
+uint16_t ums_crc16(const uint8_t *data, uint32_t length);
+
+/**
+ * CRC-32/ISO-HDLC in software, slice-by-4.
+ * @param [in] data bytes to check.
+ * @param [in] length number of bytes.
+ * @return CRC value.
+ */
+uint32_t ums_crc32(const uint8_t *data, uint32_t length);
+
+/**
+ * CRC of a frame: ums_platform_crc() when the platform provides it, ums_crc16()/ums_crc32() otherwise.
+ * @param [in] crc trailer kind, not UMS_CRC_NONE.
+ * @param [in] data bytes to check.
+ * @param [in] length number of bytes.
+ * @return CRC value, in the low 16 bits for UMS_CRC_16.
+ */
+uint32_t ums_crc_compute(ums_crc_t crc, const uint8_t *data, uint16_t length);
+
+#endif
@@ -37,13 +37,14 @@ typedef enum ums_datatype_t {
     /* Miscellaneous */
     UMS_BOOL   = 30,
     UMS_STRING = 31, /**< Only valid in handshake metadata, not in sample payload */
+    UMS_STRUCT = 32, /**< Channel from ums_trace_struct(), payload is the struct as laid out in memory */
 
-    UMS_COUNT  = 32, /**< Sentinel – must stay last */
+    UMS_COUNT  = 33, /**< Sentinel – must stay last */
 } ums_datatype_t;
 
 /**
  * Returns the size in bytes for a given datatype.
- * Returns 0 for UMS_STRING (variable length) and unknown types.
+ * Returns 0 for UMS_STRING, UMS_STRUCT (variable length) and unknown types.
  *
  * @param [in] type  ums_datatype_t value
  * @return           byte width, or 0 when undefined / variable
@@ -68,6 +69,7 @@ static inline uint8_t ums_datatype_size(ums_datatype_t type)
     case UMS_FLOAT64: return 8U;
 
     case UMS_STRING:
+    case UMS_STRUCT:
     case UMS_COUNT:
     default:          return 0U;
     }
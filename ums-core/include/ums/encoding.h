@@ -0,0 +1,213 @@
+//
+//
+//
+
+#ifndef UMS_ENCODING_H
+#define UMS_ENCODING_H
+
+#include "stdint.h"
+
+#include "ums/datatype.h"
+#include "ums/error.h"
+#include "ums/triple_buffer.h"
+
+/**
+ * Payload encoding of sample frames.
+ * UMS_ENCODING_RAW   [uint32 timestamp][var bytes...], fixed size (default).
+ * UMS_ENCODING_DELTA [uint8 tag][...] where a keyframe (tag & UMS_FRAME_TAG_KEYFRAME) carries the raw
+ *                    timestamp and var bytes, and a delta frame carries varint(timestamp delta) followed by
+ *                    one varint per channel: zigzag(delta) for integer types, XOR with the previous bits for floats.
+ * UMS_ENCODING_CHANGED [uint32 timestamp][presence bitmap][var bytes of changed channels...], bit i of the
+ *                    bitmap (byte i / 8, LSB first) is set when channel i is present. A keyframe has every bit set.
+ * Deltas and changes are taken against the previous frame handed to the transmit function.
+ */
+typedef enum ums_encoding_t {
+    UMS_ENCODING_RAW        = 0,
+    UMS_ENCODING_DELTA      = 1,
+    UMS_ENCODING_CHANGED    = 2,
+} ums_encoding_t;
+
+#define UMS_FRAME_TAG_KEYFRAME  0x01U
+
+/** Presence bitmap of UMS_ENCODING_CHANGED frames, one bit per possible channel. */
+#define UMS_PRESENCE_BITMAP_SIZE ((UMS_MAX_CHANNELS + 7U) / 8U)
+
+/** Longest LEB128 varint, a full 64 bit value. */
+#define UMS_VARINT_MAX_SIZE     10U
+
+/**
+ * Per-channel codec, derived from ums_datatype_t once at registration.
+ * Integer deltas only depend on the width: the modular difference is sign-extended from that width,
+ * which round-trips for signed and unsigned types alike.
+ */
+typedef enum ums_codec_kind_t {
+    UMS_CODEC_INT8      = 0,
+    UMS_CODEC_INT16     = 1,
+    UMS_CODEC_INT32     = 2,
+    UMS_CODEC_INT64     = 3,
+    UMS_CODEC_FLOAT32   = 4,
+    UMS_CODEC_FLOAT64   = 5,
+} ums_codec_kind_t;
+
+/**
+ * State of the delta encoder, shared by UMS_ENCODING_DELTA and UMS_ENCODING_CHANGED.
+ * values holds two raw payloads: the snapshot of this sample and the reference (previous frame),
+ * current selects the snapshot, so no copy is needed to roll the reference forward.
+ * keyframe_interval = one keyframe every N frames, 0 = only the first frame and after ums_delta_encoder_force_keyframe().
+ * frames_since_key counts the frames since (and including) the last keyframe.
+ */
+typedef struct ums_delta_encoder_t
+{
+    uint8_t     kinds[UMS_MAX_CHANNELS];
+    uint8_t     channel_count;
+    uint16_t    payload_size;
+    uint16_t    max_frame_size;
+    uint16_t    max_changed_frame_size;
+
+    uint16_t    keyframe_interval;
+    uint16_t    frames_since_key;
+    bool        force_keyframe;
+
+    uint32_t    prev_timestamp;
+    uint8_t     current;
+    uint8_t     values[2][UMS_MAX_PAYLOAD_SIZE];
+} ums_delta_encoder_t;
+
+/**
+ * Maps a datatype to its codec.
+ * @param [in] type ums_datatype_t value, must have a non-zero size.
+ * @return ums_codec_kind_t value.
+ */
+static inline uint8_t ums_codec_kind(const ums_datatype_t type)
+{
+    switch (type)
+    {
+    case UMS_FLOAT32: return UMS_CODEC_FLOAT32;
+    case UMS_FLOAT64: return UMS_CODEC_FLOAT64;
+    default:          break;
+    }
+
+    switch (ums_datatype_size(type))
+    {
+    case 2U:  return UMS_CODEC_INT16;
+    case 4U:  return UMS_CODEC_INT32;
+    case 8U:  return UMS_CODEC_INT64;
+    default:  return UMS_CODEC_INT8;
+    }
+}
+
+static inline uint64_t ums_zigzag_encode(const int64_t value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t ums_zigzag_decode(const uint64_t value)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1U);
+}
+
+/**
+ * Writes value as LEB128 varint, 7 bits per byte, least significant group first.
+ * @param [in] value value to encode.
+ * @param [out] dst_ptr destination, at least UMS_VARINT_MAX_SIZE bytes.
+ * @return number of bytes written.
+ */
+static inline uint8_t ums_varint_encode(uint64_t value, uint8_t *dst_ptr)
+{
+    uint8_t length = 0;
+    while (value >= 0x80U)
+    {
+        dst_ptr[length++] = (uint8_t)(value | 0x80U);
+        value >>= 7;
+    }
+    dst_ptr[length++] = (uint8_t)value;
+    return length;
+}
+
+/**
+ * Reads a LEB128 varint.
+ * @param [in] src_ptr encoded bytes.
+ * @param [in] available number of readable bytes at src_ptr.
+ * @param [out] value decoded value.
+ * @return number of bytes consumed, 0 when the varint is truncated or too long.
+ */
+static inline uint8_t ums_varint_decode(const uint8_t *src_ptr, const uint32_t available, uint64_t *value)
+{
+    uint64_t result = 0;
+    for (uint8_t i = 0; i < UMS_VARINT_MAX_SIZE && i < available; i++)
+    {
+        result |= (uint64_t)(src_ptr[i] & 0x7FU) << (7U * i);
+        if ((src_ptr[i] & 0x80U) == 0)
+        {
+            *value = result;
+            return (uint8_t)(i + 1U);
+        }
+    }
+    return 0;
+}
+
+/**
+ * Removes all channels and forces the next frame to be a keyframe.
+ * @param [out] encoder encoder to reset.
+ */
+void ums_delta_encoder_reset(ums_delta_encoder_t *encoder);
+
+/**
+ * Appends a channel, in registration order.
+ * @param [in,out] encoder encoder to extend.
+ * @param [in] type datatype of the channel.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_delta_encoder_add_channel(ums_delta_encoder_t *encoder, ums_datatype_t type);
+
+/**
+ * Sets the keyframe interval and forces the next frame to be a keyframe.
+ * @param [in,out] encoder encoder to configure.
+ * @param [in] keyframe_interval one keyframe every N frames, 0 = no periodic keyframes.
+ */
+void ums_delta_encoder_configure(ums_delta_encoder_t *encoder, uint16_t keyframe_interval);
+
+/**
+ * Forces the next frame to be a keyframe, e.g. after a frame was lost.
+ * @param [in,out] encoder encoder.
+ */
+void ums_delta_encoder_force_keyframe(ums_delta_encoder_t *encoder);
+
+/**
+ * Returns the raw payload buffer the copy plan has to fill before ums_delta_encode().
+ * @param [in,out] encoder encoder.
+ * @return raw payload of the current sample.
+ */
+uint8_t* ums_delta_encoder_snapshot(ums_delta_encoder_t *encoder);
+
+/**
+ * Largest frame the encoder can produce.
+ * @param [in] encoder encoder.
+ * @param [in] encoding UMS_ENCODING_DELTA or UMS_ENCODING_CHANGED.
+ * @return frame size bound in bytes.
+ */
+static inline uint16_t ums_delta_encoder_max_size(const ums_delta_encoder_t *encoder, const ums_encoding_t encoding)
+{
+    return (encoding == UMS_ENCODING_CHANGED) ? encoder->max_changed_frame_size : encoder->max_frame_size;
+}
+
+/**
+ * Encodes the snapshot against the previous frame and makes it the new reference.
+ * @param [in,out] encoder encoder.
+ * @param [in] timestamp timestamp of the sample.
+ * @param [out] dst_ptr frame destination, at least encoder->max_frame_size bytes.
+ * @return length of the encoded frame in bytes.
+ */
+uint16_t ums_delta_encode(ums_delta_encoder_t *encoder, uint32_t timestamp, uint8_t *dst_ptr);
+
+/**
+ * Writes only the channels of the snapshot that differ from the previous frame, behind a presence bitmap,
+ * and makes the snapshot the new reference. Keyframes carry every channel.
+ * @param [in,out] encoder encoder.
+ * @param [in] timestamp timestamp of the sample.
+ * @param [out] dst_ptr frame destination, at least encoder->max_changed_frame_size bytes.
+ * @return length of the encoded frame in bytes.
+ */
+uint16_t ums_changed_encode(ums_delta_encoder_t *encoder, uint32_t timestamp, uint8_t *dst_ptr);
+
+#endif
@@ -0,0 +1,121 @@
+//
+//
+//
+
+#ifndef UMS_FRAME_QUEUE_H
+#define UMS_FRAME_QUEUE_H
+
+#include "stdint.h"
+
+#include "ums/atomic.h"
+#include "ums/error.h"
+#include "ums/triple_buffer.h"
+
+#define UMS_FRAME_QUEUE_MAX_SLOTS   32U
+#define UMS_FRAME_QUEUE_NO_SLOT     0xFFU
+
+/**
+ * What to do with a new sample when every queue slot is pending or in transmission.
+ * UMS_DROP_NEWEST discards the new sample, ums_update() returns UMS_BUFFER_FULL.
+ * UMS_DROP_OLDEST discards the oldest frame that is not yet being transmitted and reuses its slot.
+ */
+typedef enum ums_overflow_policy_t {
+    UMS_DROP_NEWEST = 0,
+    UMS_DROP_OLDEST = 1,
+} ums_overflow_policy_t;
+
+/**
+ * Counters to size the queue for a given link.
+ * captured = frames written into the queue.
+ * transmitted = frames whose transfer completed.
+ * dropped = frames lost to the overflow policy.
+ * high_water = largest number of frames waiting for transmission at once.
+ */
+typedef struct ums_queue_stats_t
+{
+    uint32_t    captured;
+    uint32_t    transmitted;
+    uint32_t    dropped;
+    uint8_t     high_water;
+} ums_queue_stats_t;
+
+/**
+ * Single-producer/single-consumer queue of sample frames in caller-owned slots.
+ * Slots are passed by index through two rings: pending (producer -> transmitter) and
+ * free (transmitter -> producer), so a slot under DMA is never written and no critical section is needed.
+ * The producer owns write_slot between acquire and publish, the transmitter owns tx_slot while busy is set.
+ * lengths holds the frame length of each published slot.
+ */
+typedef struct ums_frame_queue_t
+{
+    sample_packet_t*    slots;
+    uint8_t             slot_count;
+    uint8_t             policy;
+    uint8_t             write_slot;
+    uint8_t             tx_slot;
+
+    uint16_t            lengths[UMS_FRAME_QUEUE_MAX_SLOTS];
+
+    uint8_t             pending_ring[UMS_FRAME_QUEUE_MAX_SLOTS];
+    ums_atomic_u32      pending_head;
+    ums_atomic_u32      pending_tail;
+
+    uint8_t             free_ring[UMS_FRAME_QUEUE_MAX_SLOTS];
+    ums_atomic_u32      free_head;
+    ums_atomic_u32      free_tail;
+
+    ums_atomic_u32      busy;
+    ums_queue_stats_t   stats;
+} ums_frame_queue_t;
+
+/**
+ * Initializes the queue, all slots start out free.
+ * @param [out] queue queue to initialize.
+ * @param [in] slots caller-owned slot storage (must remain in scope).
+ * @param [in] slot_count number of slots, 2..UMS_FRAME_QUEUE_MAX_SLOTS.
+ * @param [in] policy overflow policy.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_frame_queue_init(ums_frame_queue_t *queue, sample_packet_t *slots, uint8_t slot_count,
+                               ums_overflow_policy_t policy);
+
+/**
+ * Producer: returns the slot to write the next frame into, applying the overflow policy when none is free.
+ * @param [in,out] queue frame queue.
+ * @return slot to fill, nullptr when the sample has to be dropped.
+ */
+sample_packet_t* ums_frame_queue_acquire(ums_frame_queue_t *queue);
+
+/**
+ * Producer: hands the slot returned by ums_frame_queue_acquire() over for transmission.
+ * @param [in,out] queue frame queue.
+ * @param [in] length number of bytes written into the slot.
+ */
+void ums_frame_queue_publish(ums_frame_queue_t *queue, uint16_t length);
+
+/**
+ * Transmitter: claims the oldest pending frame if no transfer is in progress.
+ * @param [in,out] queue frame queue.
+ * @param [out] length number of bytes to transmit.
+ * @return frame to transmit, nullptr when busy or nothing is pending.
+ */
+sample_packet_t* ums_frame_queue_claim(ums_frame_queue_t *queue, uint16_t *length);
+
+/**
+ * Transmitter: marks the link busy without claiming a frame, for an out-of-band transfer (the handshake).
+ * Released by ums_frame_queue_complete().
+ * @param [in,out] queue frame queue.
+ * @return false if a transfer is already in progress.
+ */
+bool ums_frame_queue_reserve(ums_frame_queue_t *queue);
+
+/**
+ * Transmitter: releases the transmitted slot (or the reservation) and claims the next pending frame.
+ * To be called from the transfer complete callback.
+ * @param [in,out] queue frame queue.
+ * @param [out] length number of bytes to transmit.
+ * @return next frame to transmit, nullptr when nothing is pending.
+ */
+sample_packet_t* ums_frame_queue_complete(ums_frame_queue_t *queue, uint16_t *length);
+
+#endif
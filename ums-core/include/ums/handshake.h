@@ -0,0 +1,112 @@
+//
+//
+//
+
+#ifndef UMS_HANDSHAKE_H
+#define UMS_HANDSHAKE_H
+
+#include "stdint.h"
+
+#include "ums/crc.h"
+#include "ums/datatype.h"
+#include "ums/error.h"
+#include "ums/triple_buffer.h"
+
+/**
+ * Handshake packet, describes the sample frames once so they can carry zero metadata (little endian):
+ *
+ * [uint8 'U'][uint8 'H'][uint8 version][uint32 layout hash]
+ * [uint8 encoding][uint8 sequence size][uint8 crc][uint8 group_count][uint16 divider per group]
+ * [uint8 channel_count][channel...][crc trailer]
+ *
+ * channel:  [uint8 type byte][uint8 group][varint count][uint8 name length][name]
+ *           count is 1 for a scalar, the element count of a block, or the field count of a struct.
+ *           A UMS_STRUCT channel continues with [varint struct size] and count fields:
+ *           [uint8 type byte][varint offset][uint8 name length][name]
+ *
+ * sequence size is the width of the sequence number in front of every frame in bytes (0 = none).
+ * crc is the ums_crc_t trailer behind every frame and behind the handshake itself, over all of its bytes.
+ * The type byte packs the datatype (bits 0-5) with log2 of its size (bits 6-7), 0 for UMS_STRUCT.
+ * The layout hash is FNV-1a 32 over everything after it up to the trailer, so a host can tell a known layout from the hash alone.
+ */
+#define UMS_HANDSHAKE_MAGIC_0       0x55U
+#define UMS_HANDSHAKE_MAGIC_1       0x48U
+#define UMS_HANDSHAKE_VERSION       3U
+#define UMS_HANDSHAKE_HEADER_SIZE   7U
+
+/**
+ * Sync marker, written in front of every Nth frame after ums_set_resync() (UMS_SYNC_MARKER_SIZE bytes):
+ *
+ * [uint8 'U'][uint8 'S'][uint32 layout hash]
+ *
+ * The marker comes before the sequence number of the frame.
+ *
+ * A host joining mid-stream scans for it to find a frame boundary, the frame behind a marker is always
+ * a keyframe.
+ */
+#define UMS_SYNC_MAGIC_0            0x55U
+#define UMS_SYNC_MAGIC_1            0x53U
+
+#define UMS_HANDSHAKE_TYPE_MASK     0x3FU
+#define UMS_HANDSHAKE_SIZE_SHIFT    6U
+
+/** Room for the handshake in each context, can be overridden for long names or many fields. */
+#ifndef UMS_HANDSHAKE_MAX_SIZE
+#define UMS_HANDSHAKE_MAX_SIZE      512U
+#endif
+
+/**
+ * Everything the handshake describes, taken from the context when it is built.
+ */
+typedef struct ums_handshake_layout_t
+{
+    const data_channel_t*   channels;
+    uint8_t                 channel_count;
+    uint8_t                 encoding;
+    uint8_t                 sequence_size;
+    uint8_t                 crc;
+    const uint16_t*         group_divider;
+    uint8_t                 group_count;
+} ums_handshake_layout_t;
+
+/**
+ * Packs datatype and size into one byte, see the type byte above.
+ * @param [in] type datatype of a scalar, block element or field.
+ * @return type byte.
+ */
+uint8_t ums_handshake_type_byte(ums_datatype_t type);
+
+/**
+ * FNV-1a 32 bit hash.
+ * @param [in] data bytes to hash.
+ * @param [in] length number of bytes.
+ * @return hash value.
+ */
+uint32_t ums_handshake_hash(const uint8_t *data, uint32_t length);
+
+/**
+ * Serializes the layout into a handshake packet.
+ * @param [in] layout channels, encoding and groups to describe.
+ * @param [out] dst_ptr packet destination.
+ * @param [in] capacity size of dst_ptr in bytes.
+ * @param [out] length packet length in bytes.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_RANGE_ERROR when the packet does not fit or a name is longer
+ *         than 255 bytes.
+ */
+ums_err_t ums_handshake_build(const ums_handshake_layout_t *layout, uint8_t *dst_ptr, uint16_t capacity,
+                              uint16_t *length);
+
+/**
+ * @param [in] packet handshake packet from ums_handshake_build().
+ * @return its layout hash.
+ */
+uint32_t ums_handshake_layout_hash(const uint8_t *packet);
+
+/**
+ * Writes the sync marker of a layout.
+ * @param [in] layout_hash hash of the layout the following frames use.
+ * @param [out] dst_ptr marker destination, UMS_SYNC_MARKER_SIZE bytes.
+ */
+void ums_sync_marker_build(uint32_t layout_hash, uint8_t *dst_ptr);
+
+#endif
@@ -0,0 +1,74 @@
+//
+//
+//
+
+#ifndef UMS_INSTRUMENTATION_H
+#define UMS_INSTRUMENTATION_H
+
+#include "stdbool.h"
+#include "stdint.h"
+
+#define UMS_CYCLE_HISTOGRAM_BUCKETS 32U
+
+/**
+ * Duration statistics of one measured path, in ums_platform_get_cycles() ticks.
+ * count      measurements since the statistics were reset.
+ * last       most recent measurement, the value traced by ums_trace_instrumentation().
+ * min, max   extremes, min is UINT32_MAX while count is 0.
+ * total      sum of all measurements, mean = total / count (see ums_cycle_stats_mean()).
+ * histogram  log2 buckets: bucket 0 counts durations of 0, bucket b counts durations from 2^(b-1) to 2^b - 1,
+ *            the last bucket also counts everything above.
+ */
+typedef struct ums_cycle_stats_t
+{
+    uint32_t    count;
+    uint32_t    last;
+    uint32_t    min;
+    uint32_t    max;
+    uint64_t    total;
+    uint32_t    histogram[UMS_CYCLE_HISTOGRAM_BUCKETS];
+} ums_cycle_stats_t;
+
+/**
+ * Hot path timing of one stream, see ums_set_instrumentation().
+ * update          whole ums_update() calls that took a sample, packing and transmit kick included.
+ * create_sample   packing of one sample into its frame (copy plan, encoding, CRC, framing).
+ * transfer        transmit function call to ums_transfer_complete_callback(), handshakes included.
+ * transfer_start and transfer_timed belong to the transfer on the wire and are private.
+ */
+typedef struct ums_instrumentation_t
+{
+    bool                enabled;
+    ums_cycle_stats_t   update;
+    ums_cycle_stats_t   create_sample;
+    ums_cycle_stats_t   transfer;
+    uint32_t            transfer_start;
+    volatile bool       transfer_timed;
+} ums_instrumentation_t;
+
+/**
+ * Clears the statistics, min starts at UINT32_MAX.
+ * @param [out] stats statistics to clear.
+ */
+void ums_cycle_stats_reset(ums_cycle_stats_t *stats);
+
+/**
+ * Adds one measurement.
+ * @param [in,out] stats statistics to update.
+ * @param [in] cycles measured duration.
+ */
+void ums_cycle_stats_record(ums_cycle_stats_t *stats, uint32_t cycles);
+
+/**
+ * @param [in] stats statistics.
+ * @return mean duration rounded down, 0 without measurements.
+ */
+uint32_t ums_cycle_stats_mean(const ums_cycle_stats_t *stats);
+
+/**
+ * @param [in] cycles duration.
+ * @return histogram bucket of the duration: its bit width, clamped to the last bucket.
+ */
+uint8_t ums_cycle_bucket(uint32_t cycles);
+
+#endif
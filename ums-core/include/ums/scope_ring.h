@@ -0,0 +1,103 @@
+//
+//
+//
+
+#ifndef UMS_SCOPE_RING_H
+#define UMS_SCOPE_RING_H
+
+#include "stdint.h"
+
+#include "ums/error.h"
+
+/**
+ * Life cycle of a deep capture.
+ * ARMED      frames are recorded continuously, the oldest is overwritten (pre-trigger history).
+ * TRIGGERED  post_trigger more frames are recorded, then the ring freezes.
+ * FROZEN     the window is complete and waits to be drained.
+ * DRAINING   the window is handed to the transmit function frame by frame.
+ * DONE       the window was sent, nothing is recorded until the ring is armed again.
+ */
+typedef enum ums_scope_state_t {
+    UMS_SCOPE_IDLE      = 0,
+    UMS_SCOPE_ARMED     = 1,
+    UMS_SCOPE_TRIGGERED = 2,
+    UMS_SCOPE_FROZEN    = 3,
+    UMS_SCOPE_DRAINING  = 4,
+    UMS_SCOPE_DONE      = 5,
+} ums_scope_state_t;
+
+/** Per-slot header holding the frame length. */
+#define UMS_SCOPE_SLOT_HEADER   sizeof(uint16_t)
+
+/**
+ * Ring of frames in caller-owned RAM, recorded at full rate and drained after a trigger.
+ * Each slot is a uint16 frame length followed by up to frame_size bytes, frames are stored exactly as
+ * they would have been transmitted.
+ * head is the next slot to write, filled the number of valid slots (up to slot_count).
+ * The drained window is the filled slots ending at head: pre-trigger history plus post_trigger frames.
+ */
+typedef struct ums_scope_ring_t
+{
+    uint8_t*    buffer;
+    uint32_t    buffer_size;
+    uint16_t    frame_size;
+    uint32_t    slot_count;
+    uint32_t    post_trigger;
+
+    uint32_t    head;
+    uint32_t    filled;
+    uint32_t    remaining;
+    uint32_t    drain_slot;
+    uint32_t    drain_left;
+
+    volatile uint8_t state;
+} ums_scope_ring_t;
+
+/**
+ * Splits buffer into slots of frame_size bytes and arms the ring.
+ * @param [out] ring ring to initialize.
+ * @param [in] buffer caller-owned storage (must remain in scope).
+ * @param [in] buffer_size size of buffer in bytes.
+ * @param [in] frame_size largest frame in bytes.
+ * @param [in] post_trigger frames recorded after the trigger, less than the number of slots.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_scope_ring_init(ums_scope_ring_t *ring, uint8_t *buffer, uint32_t buffer_size, uint16_t frame_size,
+                              uint32_t post_trigger);
+
+/**
+ * Discards the recorded frames and starts recording pre-trigger history.
+ * @param [in,out] ring ring to arm.
+ */
+void ums_scope_ring_arm(ums_scope_ring_t *ring);
+
+/**
+ * Starts the post-trigger countdown. Ignored unless the ring is armed.
+ * @param [in,out] ring ring to trigger.
+ */
+void ums_scope_ring_trigger(ums_scope_ring_t *ring);
+
+/**
+ * Returns where the next frame is to be written.
+ * @param [in,out] ring ring to record into.
+ * @return write position, nullptr unless the ring is armed or triggered.
+ */
+uint8_t* ums_scope_ring_reserve(ums_scope_ring_t *ring);
+
+/**
+ * Records the frame written at the position returned by ums_scope_ring_reserve().
+ * @param [in,out] ring ring to record into.
+ * @param [in] length length of the written frame in bytes.
+ * @return true when this frame completed the window and the ring froze.
+ */
+bool ums_scope_ring_commit(ums_scope_ring_t *ring, uint16_t length);
+
+/**
+ * Returns the next frame of the frozen window, oldest first. Starts draining on a frozen ring.
+ * @param [in,out] ring ring to drain.
+ * @param [out] length length of the frame in bytes.
+ * @return frame, nullptr once the window is drained (the ring is DONE then) or when nothing is frozen.
+ */
+uint8_t* ums_scope_ring_next(ums_scope_ring_t *ring, uint16_t *length);
+
+#endif
@@ -0,0 +1,114 @@
+//
+//
+//
+
+#ifndef UMS_TRIGGER_H
+#define UMS_TRIGGER_H
+
+#include "stdint.h"
+
+#include "ums/aggregate.h"
+#include "ums/error.h"
+#include "ums/triple_buffer.h"
+
+#define UMS_TRIGGER_MAX_CONDITIONS  8U
+
+/**
+ * Condition on one channel.
+ * ABOVE/BELOW    value > low / value < low.
+ * RISING/FALLING value crossed low upwards (previous <= low < value) / downwards (previous >= low > value).
+ * INSIDE/OUTSIDE low <= value <= high / value < low or value > high.
+ */
+typedef enum ums_trigger_kind_t {
+    UMS_TRIGGER_ABOVE   = 0,
+    UMS_TRIGGER_BELOW   = 1,
+    UMS_TRIGGER_RISING  = 2,
+    UMS_TRIGGER_FALLING = 3,
+    UMS_TRIGGER_INSIDE  = 4,
+    UMS_TRIGGER_OUTSIDE = 5,
+} ums_trigger_kind_t;
+
+/**
+ * How a condition joins the result of the conditions before it, evaluated strictly left to right
+ * (no precedence): c0 OR c1 AND c2 == (c0 OR c1) AND c2.
+ */
+typedef enum ums_trigger_combine_t {
+    UMS_TRIGGER_AND     = 0,
+    UMS_TRIGGER_OR      = 1,
+} ums_trigger_combine_t;
+
+/**
+ * One trigger condition as configured by the user.
+ * channel is the registry index (registration order). combine is ignored for the first condition.
+ * low/high must be finite, they are converted to the channel's datatype when the trigger is compiled,
+ * integer channels truncate and clamp.
+ */
+typedef struct ums_trigger_condition_t
+{
+    uint8_t     channel;
+    uint8_t     kind;
+    uint8_t     combine;
+    double      low;
+    double      high;
+} ums_trigger_condition_t;
+
+/**
+ * Compiled condition: source address, accumulator domain and thresholds already in that domain,
+ * so evaluation is one load and one or two compares.
+ */
+typedef struct ums_trigger_op_t
+{
+    const void*             src_ptr;
+    uint8_t                 type;
+    uint8_t                 domain;
+    uint8_t                 kind;
+    uint8_t                 combine;
+    ums_aggregate_value_t   low;
+    ums_aggregate_value_t   high;
+    ums_aggregate_value_t   prev;
+} ums_trigger_op_t;
+
+/**
+ * Compiled trigger with hold-off.
+ * hold_off is the number of samples the gate stays open after the condition stopped holding,
+ * hold_left counts them down.
+ */
+typedef struct ums_trigger_t
+{
+    ums_trigger_op_t    ops[UMS_TRIGGER_MAX_CONDITIONS];
+    uint8_t             op_count;
+    uint16_t            hold_off;
+    uint16_t            hold_left;
+} ums_trigger_t;
+
+/**
+ * Compiles conditions against the channel registry and arms the trigger.
+ * Edge conditions start from the current values, so arming never fires an edge by itself.
+ * @param [out] trigger trigger to compile into.
+ * @param [in] conditions conditions in evaluation order.
+ * @param [in] condition_count number of conditions, 1..UMS_TRIGGER_MAX_CONDITIONS.
+ * @param [in] channels channel registry.
+ * @param [in] channel_count number of registered channels.
+ * @param [in] hold_off samples the gate stays open after the condition stopped holding.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_INVALID_PARAMETER for an unknown kind or combine, a block or
+ *         struct channel, or a NaN or infinite threshold.
+ */
+ums_err_t ums_trigger_compile(ums_trigger_t *trigger, const ums_trigger_condition_t *conditions,
+                              uint8_t condition_count, const data_channel_t *channels, uint8_t channel_count,
+                              uint16_t hold_off);
+
+/**
+ * Evaluates the compiled conditions on the current channel values.
+ * @param [in,out] trigger compiled trigger, edge state is updated.
+ * @return true when the combined condition holds.
+ */
+bool ums_trigger_evaluate(ums_trigger_t *trigger);
+
+/**
+ * Evaluates the trigger and applies the hold-off.
+ * @param [in,out] trigger compiled trigger.
+ * @return true when the sample is to be transmitted.
+ */
+bool ums_trigger_gate(ums_trigger_t *trigger);
+
+#endif
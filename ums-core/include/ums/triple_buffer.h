@@ -7,34 +7,164 @@
 
 #include "stdint.h"
 
+#include "ums/atomic.h"
 #include "ums/datatype.h"
 
 #define UMS_MAX_CHANNELS    16
 #define UMS_MAX_FRAME_SIZE  ((UMS_MAX_CHANNELS * 8U) + sizeof(uint32_t))
+#define UMS_MAX_PAYLOAD_SIZE (UMS_MAX_FRAME_SIZE - sizeof(uint32_t))
+
+/**
+ * Sync marker in front of every Nth frame with ums_set_resync(): 2 magic bytes + layout hash (see ums/handshake.h).
+ */
+#define UMS_SYNC_MARKER_SIZE    6U
+
+/**
+ * Widest frame sequence number, see ums_set_sequence().
+ */
+#define UMS_MAX_SEQUENCE_SIZE   2U
+
+/**
+ * Largest CRC trailer, see ums_set_crc().
+ */
+#define UMS_MAX_CRC_SIZE        4U
+
+/**
+ * COBS framing adds one code byte and the delimiter to a frame (see ums/cobs.h).
+ */
+#define UMS_COBS_OVERHEAD       2U
+
+/**
+ * Largest frame on the wire over all encodings: a delta frame (see ums/encoding.h) is
+ * tag + timestamp varint (5) + a 64 bit varint (10) per channel, plus an optional sync marker, sequence number,
+ * CRC trailer and COBS framing.
+ */
+#define UMS_MAX_WIRE_FRAME_SIZE (UMS_COBS_OVERHEAD + UMS_SYNC_MARKER_SIZE + UMS_MAX_SEQUENCE_SIZE + UMS_MAX_CRC_SIZE \
+                                 + 1U + 5U + (UMS_MAX_CHANNELS * 10U))
+
+/**
+ * One field of a struct channel (see ums_trace_struct()).
+ * name is the sub-channel name in the handshake, offset the byte offset of the field inside the struct,
+ * e.g. offsetof(), type its scalar datatype.
+ */
+typedef struct ums_field_t
+{
+    const char*         name;
+    uint16_t            offset;
+    ums_datatype_t      type;
+} ums_field_t;
 
 /**
  * Metadata from each channel that is traced.
  * var_ptr points to the address of the traced variable.
  * var_type refers to the datatype of the traced variable.
  * var_name_ptr is a char array containing the name of the variable, only to be used in the handshake msg.
+ * group is the sample group the channel belongs to, 0 for channels sampled on every ums_update().
+ * count is the number of var_type elements for a block channel (1 for a scalar), or the number of fields
+ * for a UMS_STRUCT channel, described by fields.
+ * size is the number of payload bytes of the channel.
  */
 typedef struct data_channel_t
 {
-    void*           var_ptr;
-    ums_datatype_t  var_type;
-    char*           var_name_ptr;
+    void*               var_ptr;
+    ums_datatype_t      var_type;
+    char*               var_name_ptr;
+    uint8_t             group;
+    uint16_t            count;
+    uint16_t            size;
+    const ums_field_t*  fields;
 } data_channel_t;
 
 /**
  * Datatype to cover the maximum size needed by the triple buffer.
- * Size = 132 bytes at 4 alignment.
+ * Size = 180 bytes at 4 alignment.
  * timestamp = device specific timestamp of the sample creation time.
  * data = value of its traced variable, is an array. Each index in 1 byte.
+ * With an encoding other than UMS_ENCODING_RAW the encoded frame is written over the whole struct instead.
  */
 typedef struct sample_packet_t
 {
     uint32_t    timestamp;
-    uint8_t     data[UMS_MAX_FRAME_SIZE - sizeof(uint32_t)];
+    uint8_t     data[UMS_MAX_WIRE_FRAME_SIZE - sizeof(uint32_t)];
 } sample_packet_t;
 
-#endif
\ No newline at end of file
+/**
+ * Packed triple buffer state, a single word so both sides update it with one compare-and-swap.
+ * bits 0-1  slot owned by the producer (being packed)
+ * bits 2-3  middle slot, holds the latest published frame when UMS_TRIPLE_FRESH is set
+ * bits 4-5  slot owned by the transmitter, on the wire while UMS_TRIPLE_BUSY is set
+ */
+#define UMS_TRIPLE_WRITE_SHIFT  0U
+#define UMS_TRIPLE_MIDDLE_SHIFT 2U
+#define UMS_TRIPLE_TX_SHIFT     4U
+#define UMS_TRIPLE_SLOT_MASK    0x03U
+#define UMS_TRIPLE_FRESH        0x40U
+#define UMS_TRIPLE_BUSY         0x80U
+
+/**
+ * Triple buffer of sample frames between ums_update() and the transmit function.
+ * lengths[i] is the frame length of slots[i], written by the producer before the slot is published.
+ */
+typedef struct ums_triple_buffer_t
+{
+    sample_packet_t     slots[3];
+    uint16_t            lengths[3];
+    ums_atomic_u32      state;
+} ums_triple_buffer_t;
+
+/**
+ * Resets to write slot 0, middle slot 1, transmit slot 2, nothing fresh, link idle.
+ * @param [out] buffer triple buffer to initialize.
+ */
+void ums_triple_buffer_init(ums_triple_buffer_t *buffer);
+
+/**
+ * @param [in] buffer triple buffer.
+ * @return slot owned by the producer, valid until the next ums_triple_buffer_publish().
+ */
+sample_packet_t* ums_triple_buffer_write_slot(ums_triple_buffer_t *buffer);
+
+/**
+ * Publishes the frame in the write slot by swapping it with the middle slot and marking it fresh.
+ * An unsent frame in the middle slot is replaced (latest value wins).
+ * @param [in,out] buffer triple buffer.
+ * @param [in] length frame length in bytes.
+ * @return true if an unsent frame was replaced.
+ */
+bool ums_triple_buffer_publish(ums_triple_buffer_t *buffer, uint16_t length);
+
+/**
+ * Takes the fresh frame for transmission if the link is idle, by swapping the middle and transmit slots.
+ * @param [in,out] buffer triple buffer.
+ * @param [out] length frame length in bytes.
+ * @return frame to transmit, nullptr when busy or nothing fresh is published.
+ */
+sample_packet_t* ums_triple_buffer_claim(ums_triple_buffer_t *buffer, uint16_t *length);
+
+/**
+ * Marks the link busy without claiming a frame, for an out-of-band transfer (the handshake).
+ * Released by ums_triple_buffer_complete().
+ * @param [in,out] buffer triple buffer.
+ * @return false if a transfer is already in progress.
+ */
+bool ums_triple_buffer_reserve(ums_triple_buffer_t *buffer);
+
+/**
+ * Releases the transmit slot once the transfer completed.
+ * @param [in,out] buffer triple buffer.
+ */
+void ums_triple_buffer_complete(ums_triple_buffer_t *buffer);
+
+/**
+ * @param [in] buffer triple buffer.
+ * @return true while a transfer is in progress.
+ */
+bool ums_triple_buffer_busy(ums_triple_buffer_t *buffer);
+
+/**
+ * @param [in] buffer triple buffer.
+ * @return true while a published frame waits in the middle slot.
+ */
+bool ums_triple_buffer_pending(ums_triple_buffer_t *buffer);
+
+#endif
@@ -5,15 +5,14 @@
 #ifndef UMS_CORE_H
 #define UMS_CORE_H
 
+#include "ums/aggregate.h"
+#include "ums/context.h"
 #include "ums/datatype.h"
+#include "ums/encoding.h"
 #include "ums/error.h"
-
-/**
- * Function pointer to user-defined transmit function, e.g. "HAL_UART_TRANSMIT_DMA()"
- * Requires pointer to the data to be sent: void *data_ptr.
- * Requires uint16_t length in bytes of what to send.
- */
-typedef void (*transmit_function)(void *data_ptr, uint16_t length);
+#include "ums/frame_queue.h"
+#include "ums/scope_ring.h"
+#include "ums/trigger.h"
 
 /**
  * Setup for UMS, requires data transmission function_ptr.
@@ -22,6 +21,257 @@ typedef void (*transmit_function)(void *data_ptr, uint16_t length);
  */
 ums_err_t ums_setup(transmit_function transmit_function_ptr);
 
+/**
+ * Replaces the triple buffer with an N-slot frame queue, so samples taken while a transfer is in progress
+ * are queued instead of rejected. ums_transfer_complete_callback() starts the next pending frame immediately.
+ * Optional, to be called after ums_setup() and before the first ums_update().
+ * @param [in] slots caller-owned slot storage (must remain in scope).
+ * @param [in] slot_count number of slots, 2..UMS_FRAME_QUEUE_MAX_SLOTS.
+ * @param [in] policy which frame to drop when all slots are in use.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_queue_setup(sample_packet_t *slots, uint8_t slot_count, ums_overflow_policy_t policy);
+
+/**
+ * Packs consecutive frames back-to-back and hands them to the transmit function in a single call.
+ * A batch is sent once it holds frames_per_batch frames, when timeout ticks passed since its first frame
+ * (checked on every ums_update(), also when it packs no frame), or on ums_flush(). The buffer is split into a half
+ * being filled and a half under transmission, each half must hold at least UMS_MAX_WIRE_FRAME_SIZE bytes.
+ * Optional, to be called after ums_setup() and before the first ums_update(). Not combinable with ums_queue_setup().
+ * @param [in] buffer caller-owned batch storage (must remain in scope).
+ * @param [in] buffer_size size of buffer in bytes.
+ * @param [in] frames_per_batch maximum number of frames per transfer.
+ * @param [in] timeout ticks of ums_platform_get_timestamp() after which a partial batch is sent, 0 = disabled.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_batch_setup(uint8_t *buffer, uint16_t buffer_size, uint8_t frames_per_batch, uint32_t timeout);
+
+/**
+ * Switches to deep capture: ums_update() records frames into buffer at full rate instead of transmitting them.
+ * The ring keeps the latest frames until ums_scope_trigger(), records post_trigger more frames and then drains
+ * the whole window (pre- and post-trigger frames, oldest first) through the transmit function, one frame per
+ * transfer. Frames are identical to streamed frames. Recording resumes after ums_scope_arm().
+ * Trace all channels before, buffer holds buffer_size / (2 + frame size) frames.
+ * Not combinable with ums_queue_setup(), ums_batch_setup() or an encoding other than UMS_ENCODING_RAW.
+ * @param [in] buffer caller-owned capture storage (must remain in scope).
+ * @param [in] buffer_size size of buffer in bytes.
+ * @param [in] post_trigger frames recorded after the trigger, less than the number of frames buffer holds.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_scope_setup(uint8_t *buffer, uint32_t buffer_size, uint32_t post_trigger);
+
+/**
+ * Triggers the deep capture, ignored unless it is armed. Safe to call from an interrupt.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_scope_trigger(void);
+
+/**
+ * Discards the captured window and starts recording again.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_BUFFER_FULL while the window is still being drained.
+ */
+ums_err_t ums_scope_arm(void);
+
+/**
+ * @return state of the deep capture, UMS_SCOPE_IDLE without ums_scope_setup().
+ */
+ums_scope_state_t ums_scope_get_state(void);
+
+/**
+ * Switches to zero-copy transmission: instead of packing the traced variables into a frame, ums_update() hands
+ * gather_function_ptr a list of {address, length} elements (the timestamp, then the traced variables with
+ * adjacent ones coalesced) that form the same frame when sent back-to-back. For transports that gather, e.g. DMA
+ * linked lists or writev().
+ * The variables are read by the transport while the transfer runs, not at the ums_update() tick, so a variable
+ * written meanwhile can be sent with its newer value. Samples taken while the list is on the wire are dropped,
+ * ums_transfer_complete_callback() frees the link again. Tracing more variables or changing the sequence size
+ * rewrites the list, so while it is on the wire they return UMS_BUFFER_FULL.
+ * Optional, to be called after ums_setup(). Not combinable with ums_queue_setup(), ums_batch_setup(),
+ * ums_scope_setup(), sample groups, an encoding other than UMS_ENCODING_RAW, COBS framing or a CRC trailer.
+ * The contiguous transmit function from ums_setup() stays the default when this is not called.
+ * The list then starts with the sync marker element on frames that carry one (see ums_set_resync()).
+ * @param [in] gather_function_ptr function pointer to user-defined gather transmit function.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_gather_setup(gather_transmit_function gather_function_ptr);
+
+/**
+ * Gates streaming on a trigger condition: ums_update() only packs and transmits a sample while the combined
+ * conditions hold, and for hold_off ticks after they stopped holding. With ums_scope_setup() the trigger
+ * does not gate, it calls ums_scope_trigger() whenever the conditions hold.
+ * Conditions are compiled against the channels traced so far and evaluated on every ums_update() tick.
+ * @param [in] conditions conditions in evaluation order, combined left to right.
+ * @param [in] condition_count number of conditions, 0 disables the trigger.
+ * @param [in] hold_off ticks the gate stays open after the conditions stopped holding.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS. On error the previously armed trigger stays in place.
+ */
+ums_err_t ums_trigger_setup(const ums_trigger_condition_t *conditions, uint8_t condition_count, uint16_t hold_off);
+
+/**
+ * Selects the payload encoding of sample frames, see ums_encoding_t for the wire format.
+ * UMS_ENCODING_DELTA ships per-channel deltas against the previous frame and falls back to a full keyframe
+ * every keyframe_interval frames, so a host can resync. UMS_ENCODING_CHANGED only ships the channels that changed
+ * since the previous frame behind a presence bitmap, its keyframes carry all channels.
+ * Encoded frames vary in length, the transmit function always receives the real frame length.
+ * Not combinable with a UMS_DROP_OLDEST frame queue, with sample groups from ums_trace_divided() or with
+ * ums_trace_block()/ums_trace_struct() channels.
+ * @param [in] encoding payload encoding.
+ * @param [in] keyframe_interval one keyframe every N frames, 0 = only the first frame.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_set_encoding(ums_encoding_t encoding, uint16_t keyframe_interval);
+
+/**
+ * Selects the framing of frames and handshake, see ums_framing_t. With UMS_FRAMING_COBS each frame costs
+ * UMS_COBS_OVERHEAD more bytes and contains no 0x00 except its trailing delimiter, so a host realigns on the next
+ * delimiter after a lost byte. Frames are stuffed in place while packing, not copied again.
+ * Call before ums_send_handshake() and ums_set_resync(), the handshake is framed when it is built.
+ * Not combinable with ums_gather_setup(), and with ums_scope_setup() only when selected before it.
+ * @param [in] framing framing of everything handed to the transmit function.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_set_framing(ums_framing_t framing);
+
+/**
+ * Starts transmission of what ums_capture() left behind: the newest captured frame, the oldest queued frame
+ * or, with batching, the frames collected so far without waiting for a full batch. A frozen scope window starts
+ * draining. No-op while a transfer is in progress, ums_transfer_complete_callback() continues from there.
+ * Meant for the main loop or a low-priority task, this is where the transmit function gets called.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_flush(void);
+
+/**
+ * Sends the handshake: the layout of the sample frames (channel names, types, block and struct sub-channels,
+ * sample groups and encoding) in the compact binary format of ums/handshake.h, so a host can decode the
+ * frames without out-of-band configuration. Call it once after the last ums_trace() to seal the layout, and
+ * again whenever the host asks for it. The packet is built right away from the current registry and goes out as
+ * soon as the link is idle, ahead of any sample frame; its transfer ends with ums_transfer_complete_callback() like
+ * any other. To be called from the same context as ums_update().
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_BUFFER_FULL while the previous handshake is still on the wire,
+ *         UMS_RANGE_ERROR when the layout does not fit UMS_HANDSHAKE_MAX_SIZE.
+ */
+ums_err_t ums_send_handshake(void);
+
+/**
+ * Lets a host attach to a running stream without a reset. Every marker_interval-th frame is prefixed with a
+ * UMS_SYNC_MARKER_SIZE byte sync marker holding the layout hash (see ums/handshake.h) and sent as a keyframe, so
+ * the host finds a frame boundary within marker_interval frames. The handshake is queued again every
+ * handshake_interval timestamp ticks, ums_send_handshake() still sends it on demand.
+ * Costs UMS_SYNC_MARKER_SIZE / (marker_interval * frame size) of the bandwidth for the markers, plus the delta
+ * of a keyframe over a delta frame with a stateful encoding, plus one handshake per handshake_interval.
+ * Call after the last trace: the markers carry the hash of the layout at this call. Not available in scope mode
+ * once ums_scope_setup() sized its ring, call before it.
+ * @param [in] marker_interval one sync marker every N frames, 0 = no markers.
+ * @param [in] handshake_interval timestamp ticks between handshakes, 0 = only on demand.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_BUFFER_FULL while a handshake is on the wire,
+ *         UMS_INVALID_PARAMETER for markers after ums_scope_setup(), UMS_RANGE_ERROR when the layout does not fit
+ *         UMS_HANDSHAKE_MAX_SIZE.
+ */
+ums_err_t ums_set_resync(uint16_t marker_interval, uint32_t handshake_interval);
+
+/**
+ * Prefixes every frame with the low size bytes of a rolling sequence number, one per captured sample, so the host
+ * can count the frames it never received (see ums_link_stats_t). The sequence number follows the sync marker and
+ * is declared in the handshake.
+ * Call before ums_send_handshake() and ums_set_resync(), and in scope mode before ums_scope_setup().
+ * @param [in] size width of the sequence number in bytes: 0 (none), 1 or 2.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_INVALID_PARAMETER for other sizes or after ums_scope_setup(),
+ *         UMS_BUFFER_FULL while a gather transfer is on the wire.
+ */
+ums_err_t ums_set_sequence(uint8_t size);
+
+/**
+ * Appends a CRC trailer to every frame and to the handshake, so a host detects frames corrupted on the wire
+ * (see ums_crc_t). Computed once per packed frame with ums_platform_crc() or slice-by-4 tables, about one table
+ * lookup per byte. The trailer is declared in the handshake.
+ * Call before ums_send_handshake() and ums_set_resync(), and in scope mode before ums_scope_setup(). Not combinable
+ * with ums_gather_setup().
+ * @param [in] crc trailer kind, UMS_CRC_NONE to disable.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_set_crc(ums_crc_t crc);
+
+/**
+ * Copies the sample accounting of the stream: captured, dropped on the device and transmitted, see
+ * ums_link_stats_t. Available in every delivery mode.
+ * @param [out] stats counters.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_get_link_stats(ums_link_stats_t *stats);
+
+/**
+ * Traces the ums_link_stats_t counters as three UMS_UINT32 channels, "ums.captured", "ums.dropped" and
+ * "ums.transmitted", so the link quality is plotted alongside the data. Like ums_trace() the channels are sampled
+ * every tick; a frame carries the counters as they were when it was packed, itself counted as captured.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_trace_link_stats(void);
+
+/**
+ * Link budget of the current layout: how many frames per second fit into a link of bytes_per_second, counting the
+ * worst-case wire size of a frame (delta/changed frames at full size, sync marker, sequence number, CRC trailer and
+ * COBS overhead included).
+ * @param [in] bytes_per_second usable link bandwidth, e.g. baud / 10 for a UART with 8N1.
+ * @param [out] max_frame_rate sustainable frames per second.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_RANGE_ERROR without traced channels.
+ */
+ums_err_t ums_link_budget(uint32_t bytes_per_second, uint32_t *max_frame_rate);
+
+/**
+ * Keeps the stream within a link budget: ums_update() captures only every factor-th call, factor chosen so that
+ * update_rate / factor frames fit into bytes_per_second (see ums_link_budget()), instead of filling the link until
+ * frames are dropped. The factor follows the layout, and is raised by one whenever a capture is dropped regardless,
+ * e.g. because the link is slower than declared, then lowered again after UMS_RATE_LIMIT_RECOVERY clean captures.
+ * Skipped updates still tick divided groups, decimation drops whole frames. Aggregated channels keep accumulating
+ * over skipped updates, so a frame's min/max/mean covers every update it stands for.
+ * The first enabling call traces the UMS_UINT16 channel "ums.decimation", the number of ums_update() calls each frame stands
+ * for, so the host can reconstruct the update time base. Call before ums_send_handshake().
+ * @param [in] bytes_per_second usable link bandwidth, 0 to disable decimation (the channel then reads 1).
+ * @param [in] update_rate ums_update() calls per second.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_INVALID_PARAMETER for update_rate 0, UMS_RANGE_ERROR when the
+ *         channel does not fit.
+ */
+ums_err_t ums_set_rate_limit(uint32_t bytes_per_second, uint32_t update_rate);
+
+/**
+ * @param [out] factor decimation factor currently applied, 1 without rate limit.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_get_decimation(uint16_t *factor);
+
+/**
+ * Enables or disables timing of the hot path with ums_platform_get_cycles(): ums_update(), the packing of each
+ * sample and each transfer from the transmit call to ums_transfer_complete_callback(), see ums_instrumentation_t.
+ * Enabling clears the statistics, so calling it again starts a new measurement. Disabled (the default) it costs one
+ * branch per measured path.
+ * @param [in] enable true to start measuring.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_set_instrumentation(bool enable);
+
+/**
+ * Copies the timing statistics of the stream.
+ * @param [out] instrumentation statistics, see ums_cycle_stats_mean() for the mean.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_get_instrumentation(ums_instrumentation_t *instrumentation);
+
+/**
+ * Traces the last measured durations as three UMS_UINT32 channels, "ums.update_cycles", "ums.create_cycles" and
+ * "ums.transfer_cycles", so the timing is plotted alongside the data. A frame carries the durations measured before
+ * it was packed, its own ums_update() is not included yet.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_trace_instrumentation(void);
+
+/**
+ * Copies the frame queue counters.
+ * @param [out] stats captured/transmitted/dropped counters and pending high-water mark.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_NOT_INITIALIZED when no queue is set up.
+ */
+ums_err_t ums_queue_get_stats(ums_queue_stats_t *stats);
+
 /**
  * Enabling tracing for a variable, to be called for each variable the user wants to trace.
  * @param [in] var_ptr pointer to the variable (must remain in scope).
@@ -31,16 +281,88 @@ ums_err_t ums_setup(transmit_function transmit_function_ptr);
  */
 ums_err_t ums_trace(void *var_ptr, char *var_name_ptr, ums_datatype_t var_type);
 
+/**
+ * Traces a contiguous array, e.g. float[12] phase currents, as one channel: one registry entry and one copy
+ * per sample. On the wire it is the same as count ums_trace() calls on consecutive elements; the handshake names
+ * the elements name[0] .. name[count - 1].
+ * Only available with UMS_ENCODING_RAW.
+ * @param [in] var_ptr pointer to the first element (must remain in scope).
+ * @param [in] var_name_ptr string alias for traced array.
+ * @param [in] var_type datatype of one element.
+ * @param [in] count number of elements.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_trace_block(void *var_ptr, char *var_name_ptr, ums_datatype_t var_type, uint16_t count);
+
+/**
+ * Traces a struct as one channel: struct_size bytes are copied as laid out in memory, padding included.
+ * The field table describes the members that show up as name.field sub-channels in the handshake; bytes not
+ * covered by a field are sent but not decoded. The table must remain in scope like the struct.
+ * Only available with UMS_ENCODING_RAW.
+ * @param [in] struct_ptr pointer to the struct (must remain in scope).
+ * @param [in] var_name_ptr string alias for traced struct.
+ * @param [in] fields field table, offsets relative to struct_ptr.
+ * @param [in] field_count number of entries in fields.
+ * @param [in] struct_size sizeof the struct.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_trace_struct(void *struct_ptr, char *var_name_ptr, const ums_field_t *fields, uint8_t field_count,
+                           uint16_t struct_size);
+
+/**
+ * Traces a variable at a fraction of the ums_update() rate: it is sampled on every divider-th call only.
+ * Channels with the same divider share a sample group (up to UMS_MAX_GROUPS including the ums_trace() group).
+ * Once a second group exists, every frame starts with a 1 byte mask of the groups it carries, followed by the
+ * timestamp and the payload of each carried group in ascending group order. Ticks without a due group emit no frame.
+ * Only available with UMS_ENCODING_RAW.
+ * @param [in] var_ptr pointer to the variable (must remain in scope).
+ * @param [in] var_name_ptr string alias for traced variable.
+ * @param [in] var_type datatype of the traced variable.
+ * @param [in] divider sample every divider-th ums_update(), 1 = same as ums_trace().
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_trace_divided(void *var_ptr, char *var_name_ptr, ums_datatype_t var_type, uint16_t divider);
+
+/**
+ * Like ums_trace_divided(), but instead of the value on the sampled tick the channel carries the min, max or mean
+ * over all ums_update() ticks since its previous frame, so spikes between frames are not lost.
+ * The aggregate keeps var_type, so the frame layout is the same as for ums_trace_divided().
+ * Trace the same variable several times for more than one aggregate.
+ * @param [in] var_ptr pointer to the variable (must remain in scope).
+ * @param [in] var_name_ptr string alias for traced variable.
+ * @param [in] var_type datatype of the traced variable.
+ * @param [in] divider emit the aggregate every divider-th ums_update().
+ * @param [in] aggregate aggregate to transmit.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_trace_aggregated(void *var_ptr, char *var_name_ptr, ums_datatype_t var_type, uint16_t divider,
+                               ums_aggregate_t aggregate);
+
 /**
  * Updates values of traced variables.
  * Creates data packet including timestamp.
  * Writes data packet to transmit buffer for automatic transmission.
- * @return ums_err_t error code. 1= UMS_SUCCESS.
+ * Same as ums_capture() with the transmission started right away, in the caller's context.
+ * While a transfer is in progress the frame waits in the triple buffer and a newer one replaces it,
+ * ums_transfer_complete_callback() sends the latest value. With UMS_ENCODING_DELTA/CHANGED the waiting frame is
+ * kept and the new sample dropped instead.
+ * @return ums_err_t error code. 1= UMS_SUCCESS, UMS_BUFFER_FULL when the sample was dropped.
  */
 ums_err_t ums_update(void);
 
 /**
- * Swap the read and spare indexes for the triple buffer once a transfer was completed.
+ * Capture half of ums_update(): samples the traced variables and publishes the frame, but never calls the
+ * transmit function, so it is cheap and bounded enough for a high-priority ISR. Transmission is started by
+ * ums_flush(). In triple buffer mode a newer capture replaces a frame not yet flushed (latest value wins),
+ * except with UMS_ENCODING_DELTA/CHANGED, where the new sample is dropped to keep the delta chain intact.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_BUFFER_FULL when the sample was dropped.
+ */
+ums_err_t ums_capture(void);
+
+/**
+ * Swap the read and spare indexes for the triple buffer once a transfer was completed and start transmitting
+ * the latest frame published meanwhile, if any, so the link never idles while data is waiting.
+ * With a frame queue or batching set up, releases the transmitted slot and starts the next pending frame or batch.
  * To be called on transfer complete, e.g. HAL_UART_TxCpltCallback()
  */
 void ums_transfer_complete_callback(void);
@@ -51,6 +373,53 @@ void ums_transfer_complete_callback(void);
  */
 ums_err_t ums_destroy(void);
 
+/*
+ * Context variants: same behaviour as the functions above, but on a caller-owned ums_context_t instead of the
+ * library default, e.g. one context per UART. Contexts are independent, each has its own channels, delivery,
+ * encoding and trigger. ums_ctx_setup() must be the first call on a context that was never set up or was destroyed.
+ */
+ums_err_t ums_ctx_setup(ums_context_t *ctx, transmit_function transmit_function_ptr);
+ums_err_t ums_ctx_queue_setup(ums_context_t *ctx, sample_packet_t *slots, uint8_t slot_count,
+                              ums_overflow_policy_t policy);
+ums_err_t ums_ctx_batch_setup(ums_context_t *ctx, uint8_t *buffer, uint16_t buffer_size, uint8_t frames_per_batch,
+                              uint32_t timeout);
+ums_err_t ums_ctx_scope_setup(ums_context_t *ctx, uint8_t *buffer, uint32_t buffer_size, uint32_t post_trigger);
+ums_err_t ums_ctx_scope_trigger(ums_context_t *ctx);
+ums_err_t ums_ctx_scope_arm(ums_context_t *ctx);
+ums_scope_state_t ums_ctx_scope_get_state(ums_context_t *ctx);
+ums_err_t ums_ctx_gather_setup(ums_context_t *ctx, gather_transmit_function gather_function_ptr);
+ums_err_t ums_ctx_trigger_setup(ums_context_t *ctx, const ums_trigger_condition_t *conditions, uint8_t condition_count,
+                                uint16_t hold_off);
+ums_err_t ums_ctx_set_encoding(ums_context_t *ctx, ums_encoding_t encoding, uint16_t keyframe_interval);
+ums_err_t ums_ctx_set_framing(ums_context_t *ctx, ums_framing_t framing);
+ums_err_t ums_ctx_flush(ums_context_t *ctx);
+ums_err_t ums_ctx_send_handshake(ums_context_t *ctx);
+ums_err_t ums_ctx_set_resync(ums_context_t *ctx, uint16_t marker_interval, uint32_t handshake_interval);
+ums_err_t ums_ctx_set_sequence(ums_context_t *ctx, uint8_t size);
+ums_err_t ums_ctx_set_crc(ums_context_t *ctx, ums_crc_t crc);
+ums_err_t ums_ctx_get_link_stats(ums_context_t *ctx, ums_link_stats_t *stats);
+ums_err_t ums_ctx_trace_link_stats(ums_context_t *ctx);
+ums_err_t ums_ctx_link_budget(ums_context_t *ctx, uint32_t bytes_per_second, uint32_t *max_frame_rate);
+ums_err_t ums_ctx_set_rate_limit(ums_context_t *ctx, uint32_t bytes_per_second, uint32_t update_rate);
+ums_err_t ums_ctx_get_decimation(ums_context_t *ctx, uint16_t *factor);
+ums_err_t ums_ctx_set_instrumentation(ums_context_t *ctx, bool enable);
+ums_err_t ums_ctx_get_instrumentation(ums_context_t *ctx, ums_instrumentation_t *instrumentation);
+ums_err_t ums_ctx_trace_instrumentation(ums_context_t *ctx);
+ums_err_t ums_ctx_queue_get_stats(ums_context_t *ctx, ums_queue_stats_t *stats);
+ums_err_t ums_ctx_trace(ums_context_t *ctx, void *var_ptr, char *var_name_ptr, ums_datatype_t var_type);
+ums_err_t ums_ctx_trace_block(ums_context_t *ctx, void *var_ptr, char *var_name_ptr, ums_datatype_t var_type,
+                              uint16_t count);
+ums_err_t ums_ctx_trace_struct(ums_context_t *ctx, void *struct_ptr, char *var_name_ptr, const ums_field_t *fields,
+                               uint8_t field_count, uint16_t struct_size);
+ums_err_t ums_ctx_trace_divided(ums_context_t *ctx, void *var_ptr, char *var_name_ptr, ums_datatype_t var_type,
+                                uint16_t divider);
+ums_err_t ums_ctx_trace_aggregated(ums_context_t *ctx, void *var_ptr, char *var_name_ptr, ums_datatype_t var_type,
+                                   uint16_t divider, ums_aggregate_t aggregate);
+ums_err_t ums_ctx_capture(ums_context_t *ctx);
+ums_err_t ums_ctx_update(ums_context_t *ctx);
+void ums_ctx_transfer_complete_callback(ums_context_t *ctx);
+ums_err_t ums_ctx_destroy(ums_context_t *ctx);
+
 /**
  * Enter critical section, default no implementation. Platform specific.
  */
@@ -67,4 +436,24 @@ void ums_platform_exit_critical(void);
  */
 uint32_t ums_platform_get_timestamp(void);
 
+/**
+ * Free-running cycle counter for ums_set_instrumentation(), only differences are used so it may wrap.
+ * Default reads the DWT cycle counter on Cortex-M3/M4/M7/M33 (enable it with DEMCR.TRCENA and DWT_CTRL.CYCCNTENA
+ * first), the time stamp counter on x86 and CLOCK_MONOTONIC nanoseconds on other Linux hosts, 0U elsewhere.
+ * @return current cycle count.
+ */
+uint32_t ums_platform_get_cycles(void);
+
+/**
+ * Hardware CRC hook, e.g. the CRC unit of an STM32 configured for the polynomial, init value, bit reversal and
+ * final xor of the requested kind (see ums_crc_t). Called for every frame with ums_set_crc().
+ * Default returns false, which selects the table-driven ums_crc16()/ums_crc32().
+ * @param [in] crc UMS_CRC_16 or UMS_CRC_32.
+ * @param [in] data bytes to check.
+ * @param [in] length number of bytes.
+ * @param [out] result CRC value, in the low 16 bits for UMS_CRC_16.
+ * @return true if the hardware computed result, false to fall back to software.
+ */
+bool ums_platform_crc(ums_crc_t crc, const uint8_t *data, uint16_t length, uint32_t *result);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+//
+//
+//
+
+#ifndef UMS_PLATFORM_POSIX_H
+#define UMS_PLATFORM_POSIX_H
+
+#include "stdint.h"
+
+#include "ums/context.h"
+#include "ums/error.h"
+
+/**
+ * POSIX port of the platform hooks, so ums-core runs as a process on Linux (load generator, soak tests, host tool
+ * development). Linking ums::platform_posix replaces the weak defaults of ums-core:
+ * ums_platform_get_timestamp()    CLOCK_MONOTONIC microseconds since ums_posix_open(), wraps after ~71 minutes.
+ * ums_platform_enter_critical()   recursive process-wide mutex, also held while the writer thread runs
+ * ums_platform_exit_critical()    ums_transfer_complete_callback(), like an ISR that critical sections mask.
+ *
+ * The transport is one file descriptor (pty, pipe, socket, file) written by a background thread. ums_posix_transmit()
+ * and ums_posix_gather_transmit() only hand the transfer over, the thread writes it completely and then calls
+ * ums_transfer_complete_callback() on the context passed to ums_posix_open(). A failed write completes the transfer
+ * as well, the frame is lost and counted. Ignore SIGPIPE when writing to pipes or sockets whose reader may go away.
+ *
+ * The transmit functions carry no context, so there is one link per process.
+ */
+
+/**
+ * Writer counters, see ums_posix_get_stats().
+ * transfers       transfers written and completed, failed ones included.
+ * bytes           bytes written.
+ * write_errors    transfers cut short by a write error other than EINTR/EAGAIN.
+ */
+typedef struct ums_posix_stats_t
+{
+    uint32_t    transfers;
+    uint64_t    bytes;
+    uint32_t    write_errors;
+} ums_posix_stats_t;
+
+/**
+ * Starts the writer thread for fd and restarts the timestamp at 0. Call before ums_setup() with ums_posix_transmit()
+ * (or ums_gather_setup() with ums_posix_gather_transmit()). A non-blocking fd is polled until writable.
+ * @param [in] ctx context whose ums_ctx_transfer_complete_callback() is called, NULL for the default context.
+ * @param [in] fd file descriptor to write to, stays owned by the caller.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_INVALID_PARAMETER when a link is already open or fd is
+ *         negative, UMS_FAIL when the thread could not be started.
+ */
+ums_err_t ums_posix_open(ums_context_t *ctx, int fd);
+
+/**
+ * Transmit function for ums_setup(), queues the transfer for the writer thread and returns right away.
+ * @param [in] data_ptr frame data, left untouched by the library until the transfer completed.
+ * @param [in] length number of bytes.
+ */
+void ums_posix_transmit(void *data_ptr, uint16_t length);
+
+/**
+ * Gather transmit function for ums_gather_setup(), written with a single writev() where possible.
+ * @param [in] iov gather list.
+ * @param [in] iov_count number of elements.
+ * @param [in] length bytes of the whole frame.
+ */
+void ums_posix_gather_transmit(const ums_iovec_t *iov, uint8_t iov_count, uint16_t length);
+
+/**
+ * Blocks until no transfer is queued or being written, including transfers the completion started.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_NOT_INITIALIZED without an open link.
+ */
+ums_err_t ums_posix_drain(void);
+
+/**
+ * Copies the writer counters.
+ * @param [out] stats counters.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+ums_err_t ums_posix_get_stats(ums_posix_stats_t *stats);
+
+/**
+ * Lets the writer finish the transfer in progress, stops and joins it. Queued transfers are not written but
+ * completed, so the context is idle and can stream again after the next ums_posix_open().
+ * Call before ums_destroy(), the fd is not closed.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_NOT_INITIALIZED without an open link.
+ */
+ums_err_t ums_posix_close(void);
+
+#endif
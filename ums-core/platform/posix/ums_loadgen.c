@@ -0,0 +1,240 @@
+//
+// ums_loadgen: runs ums-core on the POSIX port and streams synthetic channels to stdout or a file, e.g.
+//
+//     ums_loadgen --rate 10000 --count 100000 --cobs | ums_decode --handshake --cobs /dev/stdin
+//
+// Reports the sample accounting and the rate actually achieved on stderr.
+//
+
+#include "fcntl.h"
+#include "math.h"
+#include "signal.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "time.h"
+#include "unistd.h"
+
+#include "ums/platform/posix.h"
+#include "ums/ums_core.h"
+
+typedef struct ums_loadgen_options_t
+{
+    uint32_t    rate;
+    uint32_t    count;
+    uint32_t    budget;
+    uint8_t     channels;
+    uint8_t     queue_slots;
+    uint8_t     sequence;
+    ums_crc_t   crc;
+    bool        cobs;
+    const char* path;
+} ums_loadgen_options_t;
+
+static int usage(void)
+{
+    fprintf(stderr, "usage: ums_loadgen [--rate <hz>] [--count <samples>] [--channels <n>] [--queue <slots>]\n"
+                    "                   [--sequence 1|2] [--crc 16|32] [--cobs] [--budget <bytes/s>] [<output>]\n"
+                    "       --rate 0 samples as fast as possible, default 1000 Hz\n"
+                    "       --count 0 samples until interrupted, default 10000\n"
+                    "       --budget decimates to that link bandwidth with ums_set_rate_limit()\n"
+                    "       output defaults to stdout\n");
+    return 2;
+}
+
+static bool parse_options(const int argc, char **argv, ums_loadgen_options_t *options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--rate") == 0 && has_value)
+        {
+            options->rate = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--count") == 0 && has_value)
+        {
+            options->count = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--budget") == 0 && has_value)
+        {
+            options->budget = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--channels") == 0 && has_value)
+        {
+            options->channels = (uint8_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--queue") == 0 && has_value)
+        {
+            options->queue_slots = (uint8_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--sequence") == 0 && has_value)
+        {
+            options->sequence = (uint8_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--crc") == 0 && has_value)
+        {
+            const unsigned long bits = strtoul(argv[++i], NULL, 10);
+            if (bits != 16 && bits != 32)
+            {
+                return false;
+            }
+            options->crc = (bits == 16) ? UMS_CRC_16 : UMS_CRC_32;
+        }
+        else if (strcmp(argv[i], "--cobs") == 0)
+        {
+            options->cobs = true;
+        }
+        else if (argv[i][0] != '-' && !options->path)
+        {
+            options->path = argv[i];
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return options->channels > 0 && options->channels <= UMS_MAX_CHANNELS;
+}
+
+static volatile sig_atomic_t s_interrupted = 0;
+
+static void on_interrupt(const int signal_number)
+{
+    (void)signal_number;
+    s_interrupted = 1;
+}
+
+static double seconds_since(const struct timespec *start)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) + (double)(now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+    ums_loadgen_options_t options = {1000U, 10000U, 0U, 4U, 0U, 0U, UMS_CRC_NONE, false, NULL};
+    if (!parse_options(argc, argv, &options))
+    {
+        return usage();
+    }
+
+    const int fd = options.path ? open(options.path, O_WRONLY | O_CREAT | O_TRUNC, 0644) : STDOUT_FILENO;
+    if (fd < 0)
+    {
+        perror(options.path);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, on_interrupt);
+    signal(SIGTERM, on_interrupt);
+
+    // Sine, counter and sawtooth channels in turn: floats, wide and narrow integers.
+    static float sines[UMS_MAX_CHANNELS];
+    static int32_t counters[UMS_MAX_CHANNELS];
+    static uint16_t saws[UMS_MAX_CHANNELS];
+    static char names[UMS_MAX_CHANNELS][16];
+    static sample_packet_t slots[UMS_FRAME_QUEUE_MAX_SLOTS];
+
+    ums_err_t err = ums_posix_open(NULL, fd);
+    if (err == UMS_SUCCESS)
+    {
+        err = ums_setup(ums_posix_transmit);
+    }
+    if (err == UMS_SUCCESS && options.queue_slots > 0)
+    {
+        err = ums_queue_setup(slots, options.queue_slots, UMS_DROP_NEWEST);
+    }
+    if (err == UMS_SUCCESS && options.cobs)
+    {
+        err = ums_set_framing(UMS_FRAMING_COBS);
+    }
+    if (err == UMS_SUCCESS && options.sequence > 0)
+    {
+        err = ums_set_sequence(options.sequence);
+    }
+    if (err == UMS_SUCCESS && options.crc != UMS_CRC_NONE)
+    {
+        err = ums_set_crc(options.crc);
+    }
+    for (uint8_t i = 0; i < options.channels && err == UMS_SUCCESS; i++)
+    {
+        snprintf(names[i], sizeof(names[i]), "ch%u", (unsigned)i);
+        switch (i % 3U)
+        {
+        case 0:  err = ums_trace(&sines[i], names[i], UMS_FLOAT32); break;
+        case 1:  err = ums_trace(&counters[i], names[i], UMS_INT32); break;
+        default: err = ums_trace(&saws[i], names[i], UMS_UINT16); break;
+        }
+    }
+    if (err == UMS_SUCCESS && options.budget > 0)
+    {
+        // Free running (--rate 0) has no known update rate, budget it at 1 MHz.
+        err = ums_set_rate_limit(options.budget, options.rate ? options.rate : 1000000U);
+    }
+    if (err == UMS_SUCCESS)
+    {
+        err = ums_send_handshake();
+    }
+    if (err != UMS_SUCCESS)
+    {
+        fprintf(stderr, "ums_loadgen: setup failed (%d)\n", (int)err);
+        return 1;
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    struct timespec next = start;
+    const long period_ns = options.rate ? (long)(1000000000UL / options.rate) : 0;
+
+    uint32_t busy = 0;
+    uint32_t n = 0;
+    for (; (options.count == 0 || n < options.count) && !s_interrupted; n++)
+    {
+        for (uint8_t i = 0; i < options.channels; i++)
+        {
+            sines[i] = sinf((float)n * 0.01f * (float)(i + 1U));
+            counters[i] = (int32_t)n;
+            saws[i] = (uint16_t)(n * (i + 1U));
+        }
+        if (ums_update() == UMS_BUFFER_FULL)
+        {
+            busy++;
+        }
+
+        if (period_ns == 0)
+        {
+            continue;
+        }
+        next.tv_nsec += period_ns;
+        while (next.tv_nsec >= 1000000000L)
+        {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+    ums_flush();
+    ums_posix_drain();
+    const double elapsed = seconds_since(&start);
+
+    ums_link_stats_t link;
+    ums_posix_stats_t writer;
+    ums_get_link_stats(&link);
+    ums_posix_get_stats(&writer);
+    ums_posix_close();
+    ums_destroy();
+    if (options.path)
+    {
+        close(fd);
+    }
+
+    fprintf(stderr, "ums_loadgen: %u updates in %.3f s (%.0f/s), captured %u, dropped %u (%u rejected), "
+                    "transmitted %u\n", n, elapsed, elapsed > 0 ? n / elapsed : 0.0, link.captured, link.dropped,
+            busy, link.transmitted);
+    fprintf(stderr, "ums_loadgen: %u transfers, %llu bytes (%.1f kB/s), %u write errors\n", writer.transfers,
+            (unsigned long long)writer.bytes, elapsed > 0 ? (double)writer.bytes / elapsed / 1000.0 : 0.0,
+            writer.write_errors);
+
+    return writer.write_errors == 0 ? 0 : 1;
+}
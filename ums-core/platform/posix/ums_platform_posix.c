@@ -0,0 +1,307 @@
+//
+//
+//
+
+#include "errno.h"
+#include "poll.h"
+#include "pthread.h"
+#include "string.h"
+#include "sys/uio.h"
+#include "time.h"
+
+#include "ums/platform/posix.h"
+#include "ums/ums_core.h"
+
+/**
+ * The link: one transfer at a time is handed from the transmit functions to the writer thread.
+ * lock guards everything below, work wakes the writer, idle wakes ums_posix_drain().
+ * pending is set from the transmit call until the writer takes the transfer, busy from then until its completion
+ * callback returned.
+ */
+typedef struct ums_posix_link_t
+{
+    pthread_mutex_t     lock;
+    pthread_cond_t      work;
+    pthread_cond_t      idle;
+    pthread_t           thread;
+    ums_context_t*      ctx;
+    int                 fd;
+    bool                open;
+    bool                stop;
+    bool                pending;
+    bool                busy;
+    struct iovec        iov[UMS_MAX_CHANNELS + 3U];
+    int                 iov_count;
+    ums_posix_stats_t   stats;
+} ums_posix_link_t;
+
+static ums_posix_link_t s_link = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work = PTHREAD_COND_INITIALIZER,
+    .idle = PTHREAD_COND_INITIALIZER,
+    .fd = -1,
+};
+
+static pthread_once_t s_critical_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t s_critical;
+static struct timespec s_epoch;
+
+static void ums_posix_critical_init(void)
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    // The completion callback runs inside the critical section and enters it again, e.g. to claim a batch.
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&s_critical, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+/**
+ * Writes the whole gather list, resuming after partial writes and waiting for a non-blocking fd to drain.
+ * @return bytes written, stops early on a write error.
+ */
+static uint32_t ums_posix_write_all(const int fd, struct iovec *iov, int iov_count, bool *failed)
+{
+    uint32_t total = 0;
+    while (iov_count > 0)
+    {
+        const ssize_t written = writev(fd, iov, iov_count);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                struct pollfd pfd = {fd, POLLOUT, 0};
+                poll(&pfd, 1, -1);
+                continue;
+            }
+            *failed = true;
+            return total;
+        }
+
+        total += (uint32_t)written;
+        size_t remaining = (size_t)written;
+        while (iov_count > 0 && remaining >= iov->iov_len)
+        {
+            remaining -= iov->iov_len;
+            iov++;
+            iov_count--;
+        }
+        if (iov_count > 0)
+        {
+            iov->iov_base = (uint8_t*)iov->iov_base + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+    return total;
+}
+
+/**
+ * Runs the completion callback like the transfer complete ISR: atomic with respect to the critical sections of the
+ * sampling thread. Call without holding the link lock, the callback may start the next transfer.
+ */
+static void ums_posix_complete(void)
+{
+    ums_platform_enter_critical();
+    if (s_link.ctx)
+    {
+        ums_ctx_transfer_complete_callback(s_link.ctx);
+    }
+    else
+    {
+        ums_transfer_complete_callback();
+    }
+    ums_platform_exit_critical();
+}
+
+static void *ums_posix_writer(void *arg)
+{
+    (void)arg;
+    struct iovec iov[UMS_MAX_CHANNELS + 3U];
+
+    pthread_mutex_lock(&s_link.lock);
+    for (;;)
+    {
+        while (!s_link.pending && !s_link.stop)
+        {
+            pthread_cond_wait(&s_link.work, &s_link.lock);
+        }
+        if (s_link.stop)
+        {
+            break;
+        }
+        const int iov_count = s_link.iov_count;
+        memcpy(iov, s_link.iov, sizeof(iov[0]) * (size_t)iov_count);
+        s_link.pending = false;
+        s_link.busy = true;
+        pthread_mutex_unlock(&s_link.lock);
+
+        bool failed = false;
+        const uint32_t written = ums_posix_write_all(s_link.fd, iov, iov_count, &failed);
+
+        pthread_mutex_lock(&s_link.lock);
+        s_link.stats.transfers++;
+        s_link.stats.bytes += written;
+        s_link.stats.write_errors += failed ? 1U : 0U;
+        pthread_mutex_unlock(&s_link.lock);
+
+        // A transfer the completion starts is queued by the transmit function and picked up by the next iteration.
+        ums_posix_complete();
+
+        pthread_mutex_lock(&s_link.lock);
+        s_link.busy = false;
+        if (!s_link.pending)
+        {
+            pthread_cond_broadcast(&s_link.idle);
+        }
+    }
+    s_link.busy = false;
+    pthread_cond_broadcast(&s_link.idle);
+    pthread_mutex_unlock(&s_link.lock);
+
+    return NULL;
+}
+
+ums_err_t ums_posix_open(ums_context_t *ctx, const int fd)
+{
+    if (fd < 0)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_lock(&s_link.lock);
+    if (s_link.open)
+    {
+        pthread_mutex_unlock(&s_link.lock);
+        return UMS_INVALID_PARAMETER;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &s_epoch);
+    s_link.ctx = ctx;
+    s_link.fd = fd;
+    s_link.stop = false;
+    s_link.pending = false;
+    s_link.busy = false;
+    memset(&s_link.stats, 0, sizeof(s_link.stats));
+
+    if (pthread_create(&s_link.thread, NULL, ums_posix_writer, NULL) != 0)
+    {
+        pthread_mutex_unlock(&s_link.lock);
+        return UMS_FAIL;
+    }
+    s_link.open = true;
+    pthread_mutex_unlock(&s_link.lock);
+
+    return UMS_SUCCESS;
+}
+
+void ums_posix_transmit(void *data_ptr, const uint16_t length)
+{
+    pthread_mutex_lock(&s_link.lock);
+    s_link.iov[0] = (struct iovec){data_ptr, length};
+    s_link.iov_count = 1;
+    s_link.pending = true;
+    pthread_cond_signal(&s_link.work);
+    pthread_mutex_unlock(&s_link.lock);
+}
+
+void ums_posix_gather_transmit(const ums_iovec_t *iov, const uint8_t iov_count, const uint16_t length)
+{
+    (void)length;
+
+    pthread_mutex_lock(&s_link.lock);
+    for (uint8_t i = 0; i < iov_count; i++)
+    {
+        // writev() does not write through iov_base, the cast only drops the const.
+        s_link.iov[i] = (struct iovec){(void*)iov[i].base, iov[i].length};
+    }
+    s_link.iov_count = iov_count;
+    s_link.pending = true;
+    pthread_cond_signal(&s_link.work);
+    pthread_mutex_unlock(&s_link.lock);
+}
+
+ums_err_t ums_posix_drain(void)
+{
+    pthread_mutex_lock(&s_link.lock);
+    if (!s_link.open)
+    {
+        pthread_mutex_unlock(&s_link.lock);
+        return UMS_NOT_INITIALIZED;
+    }
+    while (s_link.pending || s_link.busy)
+    {
+        pthread_cond_wait(&s_link.idle, &s_link.lock);
+    }
+    pthread_mutex_unlock(&s_link.lock);
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_posix_get_stats(ums_posix_stats_t *stats)
+{
+    if (!stats)
+    {
+        return UMS_NULL_POINTER;
+    }
+    pthread_mutex_lock(&s_link.lock);
+    *stats = s_link.stats;
+    pthread_mutex_unlock(&s_link.lock);
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_posix_close(void)
+{
+    pthread_mutex_lock(&s_link.lock);
+    if (!s_link.open)
+    {
+        pthread_mutex_unlock(&s_link.lock);
+        return UMS_NOT_INITIALIZED;
+    }
+    s_link.stop = true;
+    pthread_cond_signal(&s_link.work);
+    pthread_mutex_unlock(&s_link.lock);
+
+    pthread_join(s_link.thread, NULL);
+
+    // Queued transfers are completed unwritten, like a failed write, or the context would stay busy for good.
+    // A completion may queue the next transfer, e.g. from the frame queue, so this runs until none is left.
+    pthread_mutex_lock(&s_link.lock);
+    while (s_link.pending)
+    {
+        s_link.pending = false;
+        pthread_mutex_unlock(&s_link.lock);
+
+        ums_posix_complete();
+
+        pthread_mutex_lock(&s_link.lock);
+    }
+    s_link.open = false;
+    s_link.fd = -1;
+    pthread_mutex_unlock(&s_link.lock);
+
+    return UMS_SUCCESS;
+}
+
+void ums_platform_enter_critical(void)
+{
+    pthread_once(&s_critical_once, ums_posix_critical_init);
+    pthread_mutex_lock(&s_critical);
+}
+
+void ums_platform_exit_critical(void)
+{
+    pthread_mutex_unlock(&s_critical);
+}
+
+uint32_t ums_platform_get_timestamp(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const int64_t micros = (int64_t)(now.tv_sec - s_epoch.tv_sec) * 1000000
+                         + (now.tv_nsec - s_epoch.tv_nsec) / 1000;
+    return (uint32_t)micros;
+}
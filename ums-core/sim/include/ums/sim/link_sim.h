@@ -0,0 +1,85 @@
+#ifndef UMS_SIM_LINK_SIM_H
+#define UMS_SIM_LINK_SIM_H
+
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+namespace ums::sim {
+
+/**
+ * Transport timing: a transfer of n bytes completes transfer_overhead_us + n / bytes_per_second after the transmit
+ * function was called (DMA setup and interrupt latency, then the bytes on the wire).
+ */
+struct LinkModel {
+    double bytes_per_second = 11520.0;
+    double transfer_overhead_us = 0.0;
+
+    /**
+     * A UART at baud with bits_per_byte line bits per byte (8N1 = start + 8 data + stop = 10).
+     */
+    static LinkModel uart(uint32_t baud, double transfer_overhead_us = 0.0, uint32_t bits_per_byte = 10);
+};
+
+/**
+ * One simulated deployment: the stream setup and the ums_update() rate.
+ * channels are UMS_FLOAT32 variables traced with ums_trace(). queue_slots 0 keeps the triple buffer,
+ * otherwise ums_queue_setup() with UMS_DROP_NEWEST. rate_limit calls ums_set_rate_limit() with the link bandwidth
+ * and update rate, which adds the "ums.decimation" channel.
+ */
+struct SimConfig {
+    LinkModel link;
+    double update_rate_hz = 1000.0;
+    double duration_s = 1.0;
+    uint8_t channels = 4;
+    uint8_t queue_slots = 0;
+    ums_framing_t framing = UMS_FRAMING_NONE;
+    ums_crc_t crc = UMS_CRC_NONE;
+    uint8_t sequence_size = 0;
+    bool rate_limit = false;
+};
+
+/**
+ * Capture to transfer complete latency of the transmitted frames, in microseconds of virtual time.
+ * Percentiles are nearest rank, all 0 without frames.
+ */
+struct LatencyStats {
+    size_t count = 0;
+    double min_us = 0.0;
+    double mean_us = 0.0;
+    double p50_us = 0.0;
+    double p90_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+};
+
+struct SimResult {
+    uint64_t updates = 0;
+    ums_link_stats_t link{};        // captured, dropped and transmitted as the device counted them
+    uint64_t wire_bytes = 0;        // bytes of the completed transfers
+    double achieved_rate_hz = 0.0;  // transmitted samples per second of simulated time
+    double drop_ratio = 0.0;        // dropped / captured
+    double link_utilisation = 0.0;  // share of the simulated time a transfer was on the wire
+    LatencyStats latency;
+
+    double frame_bytes() const {
+        return link.transmitted ? static_cast<double>(wire_bytes) / link.transmitted : 0.0;
+    }
+};
+
+/**
+ * Runs the library on a virtual clock: ums_update() every 1 / update_rate_hz, the transmit function modelled by
+ * config.link, ums_transfer_complete_callback() at the modelled completion time. A completion due at the same time
+ * as an update runs first, like a pending interrupt. Deterministic, the result depends on config only.
+ * Uses the default context, ums_platform_get_timestamp() returns the virtual time in microseconds in binaries
+ * linking ums::sim. Transfers still on the wire when duration_s ends are not counted.
+ * @return false if the library rejected the configuration, result is left unchanged then.
+ */
+bool simulate(const SimConfig &config, SimResult &result);
+
+} // namespace ums::sim
+
+#endif
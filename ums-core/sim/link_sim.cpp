@@ -0,0 +1,181 @@
+#include "ums/sim/link_sim.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "ums/host/cobs.h"
+
+namespace ums::sim {
+
+namespace {
+
+// State of the running simulation, reached from the C callbacks of the library (the transmit function carries no
+// context).
+struct Run {
+    const SimConfig *config = nullptr;
+    uint64_t now_ns = 0;
+    bool in_flight = false;
+    uint64_t start_ns = 0;
+    uint64_t complete_ns = 0;
+    uint32_t frame_timestamp = 0;
+    uint32_t frame_length = 0;
+    uint64_t busy_ns = 0;
+    uint64_t wire_bytes = 0;
+    std::vector<double> latencies_us;
+    std::vector<uint8_t> decoded;
+};
+
+Run g_run;
+
+float g_channels[UMS_MAX_CHANNELS];
+char g_names[UMS_MAX_CHANNELS][8];
+
+// Capture timestamp of the sample in a transfer: behind the sequence number, COBS stuffing undone first
+uint32_t frame_timestamp(const uint8_t *data, uint16_t length) {
+    const uint8_t *frame = data;
+    size_t frame_length = length;
+    if (g_run.config->framing == UMS_FRAMING_COBS) {
+        g_run.decoded.clear();
+        // The transfer ends with the 0x00 delimiter
+        if (length == 0 || !ums::host::cobs_decode(data, length - 1U, g_run.decoded)) {
+            return 0;
+        }
+        frame = g_run.decoded.data();
+        frame_length = g_run.decoded.size();
+    }
+    uint32_t timestamp = 0;
+    if (frame_length >= g_run.config->sequence_size + sizeof(timestamp)) {
+        memcpy(&timestamp, frame + g_run.config->sequence_size, sizeof(timestamp));
+    }
+    return timestamp;
+}
+
+void sim_transmit(void *data_ptr, uint16_t length) {
+    const LinkModel &link = g_run.config->link;
+    const double duration_ns = link.transfer_overhead_us * 1e3 + length * 1e9 / link.bytes_per_second;
+    g_run.in_flight = true;
+    g_run.start_ns = g_run.now_ns;
+    g_run.complete_ns = g_run.now_ns + static_cast<uint64_t>(std::llround(duration_ns));
+    g_run.frame_timestamp = frame_timestamp(static_cast<const uint8_t*>(data_ptr), length);
+    g_run.frame_length = length;
+}
+
+void complete_transfer() {
+    g_run.busy_ns += g_run.complete_ns - g_run.start_ns;
+    g_run.wire_bytes += g_run.frame_length;
+    g_run.latencies_us.push_back(static_cast<double>(g_run.complete_ns) / 1e3 - g_run.frame_timestamp);
+    g_run.in_flight = false;
+    // May start the next transfer right away
+    ums_transfer_complete_callback();
+}
+
+double percentile(const std::vector<double> &sorted, double p) {
+    const size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+LatencyStats latency_stats(std::vector<double> &latencies) {
+    LatencyStats stats;
+    if (latencies.empty()) {
+        return stats;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    stats.count = latencies.size();
+    stats.min_us = latencies.front();
+    stats.max_us = latencies.back();
+    double total = 0.0;
+    for (double latency : latencies) {
+        total += latency;
+    }
+    stats.mean_us = total / latencies.size();
+    stats.p50_us = percentile(latencies, 0.50);
+    stats.p90_us = percentile(latencies, 0.90);
+    stats.p99_us = percentile(latencies, 0.99);
+    return stats;
+}
+
+bool setup_stream(const SimConfig &config) {
+    static sample_packet_t slots[UMS_FRAME_QUEUE_MAX_SLOTS];
+
+    ums_destroy();
+    bool ok = ums_setup(sim_transmit) == UMS_SUCCESS;
+    if (ok && config.queue_slots > 0) {
+        ok = ums_queue_setup(slots, config.queue_slots, UMS_DROP_NEWEST) == UMS_SUCCESS;
+    }
+    ok = ok && ums_set_framing(config.framing) == UMS_SUCCESS;
+    ok = ok && ums_set_crc(config.crc) == UMS_SUCCESS;
+    ok = ok && ums_set_sequence(config.sequence_size) == UMS_SUCCESS;
+    for (uint8_t i = 0; ok && i < config.channels; i++) {
+        snprintf(g_names[i], sizeof(g_names[i]), "ch%u", static_cast<unsigned>(i));
+        ok = ums_trace(&g_channels[i], g_names[i], UMS_FLOAT32) == UMS_SUCCESS;
+    }
+    if (ok && config.rate_limit) {
+        ok = ums_set_rate_limit(static_cast<uint32_t>(config.link.bytes_per_second),
+                                static_cast<uint32_t>(config.update_rate_hz)) == UMS_SUCCESS;
+    }
+    return ok && config.channels > 0;
+}
+
+} // namespace
+
+LinkModel LinkModel::uart(uint32_t baud, double transfer_overhead_us, uint32_t bits_per_byte) {
+    LinkModel link;
+    link.bytes_per_second = static_cast<double>(baud) / bits_per_byte;
+    link.transfer_overhead_us = transfer_overhead_us;
+    return link;
+}
+
+bool simulate(const SimConfig &config, SimResult &result) {
+    if (config.update_rate_hz <= 0.0 || config.link.bytes_per_second <= 0.0 || config.duration_s <= 0.0) {
+        return false;
+    }
+    g_run = Run();
+    g_run.config = &config;
+    if (!setup_stream(config)) {
+        ums_destroy();
+        return false;
+    }
+
+    const double period_ns = 1e9 / config.update_rate_hz;
+    const auto end_ns = static_cast<uint64_t>(std::llround(config.duration_s * 1e9));
+    SimResult run;
+    for (;;) {
+        // Update times are derived from the count, so the period does not accumulate rounding
+        const auto update_ns = static_cast<uint64_t>(std::llround(static_cast<double>(run.updates) * period_ns));
+        if (g_run.in_flight && g_run.complete_ns <= update_ns && g_run.complete_ns <= end_ns) {
+            g_run.now_ns = g_run.complete_ns;
+            complete_transfer();
+        } else if (update_ns < end_ns) {
+            g_run.now_ns = update_ns;
+            for (uint8_t i = 0; i < config.channels; i++) {
+                g_channels[i] = static_cast<float>(run.updates) + i;
+            }
+            ums_update();
+            run.updates++;
+        } else {
+            break;
+        }
+    }
+
+    ums_get_link_stats(&run.link);
+    ums_destroy();
+
+    run.wire_bytes = g_run.wire_bytes;
+    run.achieved_rate_hz = run.link.transmitted / config.duration_s;
+    run.drop_ratio = run.link.captured ? static_cast<double>(run.link.dropped) / run.link.captured : 0.0;
+    run.link_utilisation = static_cast<double>(g_run.busy_ns) / static_cast<double>(end_ns);
+    run.latency = latency_stats(g_run.latencies_us);
+    result = run;
+    g_run.config = nullptr;
+    return true;
+}
+
+} // namespace ums::sim
+
+// Virtual clock for the library, replaces the weak default of ums-core
+extern "C" uint32_t ums_platform_get_timestamp(void) {
+    return static_cast<uint32_t>(ums::sim::g_run.now_ns / 1000U);
+}
@@ -0,0 +1,116 @@
+// ums_sim: predicts the sample rate, drop rate and latency of a stream before it is deployed, by running ums-core
+// against a modelled UART on a virtual clock. Sweeps channel count and baud rate.
+//
+// usage: ums_sim [--channels 1,4,16] [--baud 115200,921600] [--rate <hz>] [--duration <s>] [--overhead <us>]
+//                [--queue <slots>] [--cobs] [--crc 16|32] [--sequence 1|2] [--rate-limit] [--csv]
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ums/sim/link_sim.h"
+
+using ums::sim::LinkModel;
+using ums::sim::SimConfig;
+using ums::sim::SimResult;
+
+static int usage() {
+    fprintf(stderr, "usage: ums_sim [--channels <n,n,...>] [--baud <baud,baud,...>] [--rate <hz>] [--duration <s>]\n"
+                    "               [--overhead <us>] [--queue <slots>] [--cobs] [--crc 16|32] [--sequence 1|2]\n"
+                    "               [--rate-limit] [--csv]\n"
+                    "       channels are float32, the UART is 8N1 (10 line bits per byte)\n"
+                    "       --overhead: per transfer, e.g. DMA setup and completion interrupt latency\n"
+                    "       --queue: frame queue slots instead of the triple buffer\n"
+                    "       --rate-limit: decimate captures to the link budget (ums_set_rate_limit())\n");
+    return 2;
+}
+
+static std::vector<uint32_t> parse_list(const char *text) {
+    std::vector<uint32_t> values;
+    std::stringstream list(text);
+    std::string value;
+    while (std::getline(list, value, ',')) {
+        values.push_back(static_cast<uint32_t>(std::stoul(value)));
+    }
+    return values;
+}
+
+int main(int argc, char **argv) {
+    std::vector<uint32_t> channels = {1, 4, 8, UMS_MAX_CHANNELS};
+    std::vector<uint32_t> bauds = {115200, 460800, 921600, 2000000};
+    SimConfig config;
+    double overhead_us = 0.0;
+    bool csv = false;
+
+    for (int i = 1; i < argc; i++) {
+        const bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--channels") == 0 && has_value) {
+            channels = parse_list(argv[++i]);
+        } else if (strcmp(argv[i], "--baud") == 0 && has_value) {
+            bauds = parse_list(argv[++i]);
+        } else if (strcmp(argv[i], "--rate") == 0 && has_value) {
+            config.update_rate_hz = std::stod(argv[++i]);
+        } else if (strcmp(argv[i], "--duration") == 0 && has_value) {
+            config.duration_s = std::stod(argv[++i]);
+        } else if (strcmp(argv[i], "--overhead") == 0 && has_value) {
+            overhead_us = std::stod(argv[++i]);
+        } else if (strcmp(argv[i], "--queue") == 0 && has_value) {
+            config.queue_slots = static_cast<uint8_t>(std::stoul(argv[++i]));
+        } else if (strcmp(argv[i], "--cobs") == 0) {
+            config.framing = UMS_FRAMING_COBS;
+        } else if (strcmp(argv[i], "--crc") == 0 && has_value) {
+            const std::string bits = argv[++i];
+            if (bits == "16") {
+                config.crc = UMS_CRC_16;
+            } else if (bits == "32") {
+                config.crc = UMS_CRC_32;
+            } else {
+                return usage();
+            }
+        } else if (strcmp(argv[i], "--sequence") == 0 && has_value) {
+            config.sequence_size = static_cast<uint8_t>(std::stoul(argv[++i]));
+        } else if (strcmp(argv[i], "--rate-limit") == 0) {
+            config.rate_limit = true;
+        } else if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else {
+            return usage();
+        }
+    }
+
+    if (csv) {
+        printf("channels,baud,frame_bytes,updates,captured,dropped,transmitted,achieved_hz,drop_ratio,utilisation,"
+               "latency_min_us,latency_mean_us,latency_p50_us,latency_p90_us,latency_p99_us,latency_max_us\n");
+    } else {
+        printf("update rate %.0f Hz, %.3f s simulated, %s%s\n", config.update_rate_hz, config.duration_s,
+               config.queue_slots ? "frame queue" : "triple buffer", config.rate_limit ? ", rate limited" : "");
+        printf("%8s %8s %6s %10s %7s %6s %10s %10s %10s\n", "channels", "baud", "frame", "achieved", "drops",
+               "link", "p50 [us]", "p99 [us]", "max [us]");
+    }
+    for (uint32_t channel_count : channels) {
+        for (uint32_t baud : bauds) {
+            config.channels = static_cast<uint8_t>(channel_count);
+            config.link = LinkModel::uart(baud, overhead_us);
+            SimResult result;
+            if (!ums::sim::simulate(config, result)) {
+                fprintf(stderr, "ums_sim: configuration rejected (%u channels)\n", channel_count);
+                return 1;
+            }
+            if (csv) {
+                printf("%u,%u,%.1f,%llu,%u,%u,%u,%.3f,%.6f,%.6f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", channel_count, baud,
+                       result.frame_bytes(), static_cast<unsigned long long>(result.updates), result.link.captured,
+                       result.link.dropped, result.link.transmitted, result.achieved_rate_hz, result.drop_ratio,
+                       result.link_utilisation, result.latency.min_us, result.latency.mean_us, result.latency.p50_us,
+                       result.latency.p90_us, result.latency.p99_us, result.latency.max_us);
+            } else {
+                printf("%8u %8u %6.1f %8.0fHz %6.2f%% %5.1f%% %10.1f %10.1f %10.1f\n", channel_count, baud,
+                       result.frame_bytes(), result.achieved_rate_hz, result.drop_ratio * 100.0,
+                       result.link_utilisation * 100.0, result.latency.p50_us, result.latency.p99_us,
+                       result.latency.max_us);
+            }
+        }
+    }
+    return 0;
+}
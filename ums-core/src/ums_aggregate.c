@@ -0,0 +1,143 @@
+//
+//
+//
+
+#include "float.h"
+#include "string.h"
+
+#include "ums/aggregate.h"
+
+static void ums_aggregator_restart(ums_aggregator_t *agg)
+{
+    agg->count = 0;
+    switch (agg->domain)
+    {
+    case UMS_AGGREGATE_SIGNED:
+        agg->min.i = INT64_MAX;
+        agg->max.i = INT64_MIN;
+        agg->sum.i = 0;
+        break;
+    case UMS_AGGREGATE_FLOAT:
+        agg->min.f = DBL_MAX;
+        agg->max.f = -DBL_MAX;
+        agg->sum.f = 0.0;
+        break;
+    default:
+        agg->min.u = UINT64_MAX;
+        agg->max.u = 0;
+        agg->sum.u = 0;
+        break;
+    }
+}
+
+static inline void ums_accumulate_unsigned(ums_aggregator_t *agg, const uint64_t value)
+{
+    agg->min.u = (value < agg->min.u) ? value : agg->min.u;
+    agg->max.u = (value > agg->max.u) ? value : agg->max.u;
+    agg->sum.u += value;
+}
+
+static inline void ums_accumulate_signed(ums_aggregator_t *agg, const int64_t value)
+{
+    agg->min.i = (value < agg->min.i) ? value : agg->min.i;
+    agg->max.i = (value > agg->max.i) ? value : agg->max.i;
+    agg->sum.u += (uint64_t)value;
+}
+
+static inline void ums_accumulate_float(ums_aggregator_t *agg, const double value)
+{
+    agg->min.f = (value < agg->min.f) ? value : agg->min.f;
+    agg->max.f = (value > agg->max.f) ? value : agg->max.f;
+    agg->sum.f += value;
+}
+
+ums_err_t ums_aggregator_init(ums_aggregator_t *agg, const void *src_ptr, const ums_datatype_t type,
+                              const ums_aggregate_t mode)
+{
+    if (!agg || !src_ptr)
+    {
+        return UMS_NULL_POINTER;
+    }
+    if (ums_datatype_size(type) == 0 || mode > UMS_AGGREGATE_MEAN)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+
+    agg->src_ptr = src_ptr;
+    agg->type = type;
+    agg->mode = mode;
+    agg->group = 0;
+    agg->domain = ums_aggregate_domain(type);
+    memset(agg->result, 0, sizeof(agg->result));
+    ums_aggregator_restart(agg);
+
+    return UMS_SUCCESS;
+}
+
+void ums_aggregator_accumulate(ums_aggregator_t *agg)
+{
+    const void *src = agg->src_ptr;
+    switch (agg->type)
+    {
+    case UMS_UINT8:
+    case UMS_BOOL:    ums_accumulate_unsigned(agg, *(const uint8_t*)src); break;
+    case UMS_UINT16:  { uint16_t v; memcpy(&v, src, sizeof(v)); ums_accumulate_unsigned(agg, v); break; }
+    case UMS_UINT32:  { uint32_t v; memcpy(&v, src, sizeof(v)); ums_accumulate_unsigned(agg, v); break; }
+    case UMS_UINT64:  { uint64_t v; memcpy(&v, src, sizeof(v)); ums_accumulate_unsigned(agg, v); break; }
+    case UMS_INT8:    ums_accumulate_signed(agg, *(const int8_t*)src); break;
+    case UMS_INT16:   { int16_t v;  memcpy(&v, src, sizeof(v)); ums_accumulate_signed(agg, v); break; }
+    case UMS_INT32:   { int32_t v;  memcpy(&v, src, sizeof(v)); ums_accumulate_signed(agg, v); break; }
+    case UMS_INT64:   { int64_t v;  memcpy(&v, src, sizeof(v)); ums_accumulate_signed(agg, v); break; }
+    case UMS_FLOAT32: { float v;    memcpy(&v, src, sizeof(v)); ums_accumulate_float(agg, v); break; }
+    default:          { double v;   memcpy(&v, src, sizeof(v)); ums_accumulate_float(agg, v); break; }
+    }
+    agg->count++;
+}
+
+void ums_aggregator_finish(ums_aggregator_t *agg)
+{
+    if (agg->count == 0)
+    {
+        // Nothing accumulated yet, report the current value
+        ums_aggregator_accumulate(agg);
+    }
+
+    ums_aggregate_value_t value;
+    switch (agg->mode)
+    {
+    case UMS_AGGREGATE_MIN: value = agg->min; break;
+    case UMS_AGGREGATE_MAX: value = agg->max; break;
+    default:
+        if (agg->domain == UMS_AGGREGATE_SIGNED)
+        {
+            value.i = agg->sum.i / (int64_t)agg->count;
+        }
+        else if (agg->domain == UMS_AGGREGATE_FLOAT)
+        {
+            value.f = agg->sum.f / (double)agg->count;
+        }
+        else
+        {
+            value.u = agg->sum.u / agg->count;
+        }
+        break;
+    }
+
+    uint8_t *dst = agg->result;
+    switch (agg->type)
+    {
+    case UMS_UINT8:
+    case UMS_BOOL:    *dst = (uint8_t)value.u; break;
+    case UMS_UINT16:  { const uint16_t v = (uint16_t)value.u; memcpy(dst, &v, sizeof(v)); break; }
+    case UMS_UINT32:  { const uint32_t v = (uint32_t)value.u; memcpy(dst, &v, sizeof(v)); break; }
+    case UMS_UINT64:  memcpy(dst, &value.u, sizeof(value.u)); break;
+    case UMS_INT8:    { const int8_t v = (int8_t)value.i; memcpy(dst, &v, sizeof(v)); break; }
+    case UMS_INT16:   { const int16_t v = (int16_t)value.i; memcpy(dst, &v, sizeof(v)); break; }
+    case UMS_INT32:   { const int32_t v = (int32_t)value.i; memcpy(dst, &v, sizeof(v)); break; }
+    case UMS_INT64:   memcpy(dst, &value.i, sizeof(value.i)); break;
+    case UMS_FLOAT32: { const float v = (float)value.f; memcpy(dst, &v, sizeof(v)); break; }
+    default:          memcpy(dst, &value.f, sizeof(value.f)); break;
+    }
+
+    ums_aggregator_restart(agg);
+}
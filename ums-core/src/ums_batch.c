@@ -0,0 +1,120 @@
+//
+//
+//
+
+#include "ums/batch.h"
+
+ums_err_t ums_batch_init(ums_batch_t *batch, uint8_t *buffer, const uint16_t buffer_size,
+                         const uint8_t frames_per_batch, const uint32_t timeout)
+{
+    if (!batch || !buffer)
+    {
+        return UMS_NULL_POINTER;
+    }
+    if (frames_per_batch == 0 || buffer_size < 2U)
+    {
+        return UMS_RANGE_ERROR;
+    }
+
+    batch->buffer = buffer;
+    batch->half_size = buffer_size / 2U;
+    batch->frames_per_batch = frames_per_batch;
+    batch->timeout = timeout;
+
+    batch->fill_half = 0;
+    batch->frame_count = 0;
+    batch->fill_length = 0;
+    batch->first_timestamp = 0;
+    batch->tx_pending = false;
+    batch->tx_busy = false;
+    batch->tx_frame_count = 0;
+
+    return UMS_SUCCESS;
+}
+
+uint8_t* ums_batch_reserve(ums_batch_t *batch, const uint16_t max_frame_size)
+{
+    if (batch->tx_pending)
+    {
+        return nullptr;
+    }
+    if (max_frame_size > batch->half_size)
+    {
+        return nullptr;
+    }
+    if ((uint32_t)batch->fill_length + max_frame_size > batch->half_size)
+    {
+        ums_batch_seal(batch);
+        return nullptr;
+    }
+    return &batch->buffer[(batch->fill_half * batch->half_size) + batch->fill_length];
+}
+
+static inline bool ums_batch_expired(const ums_batch_t *batch, const uint32_t timestamp)
+{
+    return (batch->timeout != 0U) && ((timestamp - batch->first_timestamp) >= batch->timeout);
+}
+
+bool ums_batch_commit(ums_batch_t *batch, const uint16_t frame_size, const uint16_t max_frame_size,
+                      const uint32_t timestamp)
+{
+    if (batch->frame_count == 0)
+    {
+        batch->first_timestamp = timestamp;
+    }
+    batch->frame_count++;
+    batch->fill_length += frame_size;
+
+    const bool full = (batch->frame_count >= batch->frames_per_batch)
+                   || ((uint32_t)batch->fill_length + max_frame_size > batch->half_size);
+    if (full || ums_batch_expired(batch, timestamp))
+    {
+        ums_batch_seal(batch);
+        return true;
+    }
+    return false;
+}
+
+bool ums_batch_expire(ums_batch_t *batch, const uint32_t timestamp)
+{
+    if (batch->tx_pending || batch->frame_count == 0 || !ums_batch_expired(batch, timestamp))
+    {
+        return false;
+    }
+    batch->tx_pending = true;
+    return true;
+}
+
+void ums_batch_seal(ums_batch_t *batch)
+{
+    if (batch->frame_count > 0)
+    {
+        batch->tx_pending = true;
+    }
+}
+
+uint8_t* ums_batch_claim(ums_batch_t *batch, uint16_t *length)
+{
+    if (batch->tx_busy || !batch->tx_pending)
+    {
+        return nullptr;
+    }
+
+    uint8_t *data = &batch->buffer[batch->fill_half * batch->half_size];
+    *length = batch->fill_length;
+
+    batch->fill_half ^= 1U;
+    batch->tx_frame_count = batch->frame_count;
+    batch->frame_count = 0;
+    batch->fill_length = 0;
+    batch->tx_pending = false;
+    batch->tx_busy = true;
+
+    return data;
+}
+
+uint8_t* ums_batch_complete(ums_batch_t *batch, uint16_t *length)
+{
+    batch->tx_busy = false;
+    return ums_batch_claim(batch, length);
+}
@@ -0,0 +1,78 @@
+//
+//
+//
+
+#include "string.h"
+
+#include "ums/cobs.h"
+
+/**
+ * @return true if any of the four bytes of word is 0x00.
+ */
+static inline bool ums_cobs_has_zero(const uint32_t word)
+{
+    return ((word - 0x01010101U) & ~word & 0x80808080U) != 0;
+}
+
+uint16_t ums_cobs_stuff(uint8_t *frame_ptr, const uint16_t length)
+{
+    uint16_t code_index = 0;
+    uint16_t i = 1U;
+    while (i <= length)
+    {
+        // Zero-free words are skipped whole, the common case for sample payloads.
+        if (i + 3U <= length)
+        {
+            uint32_t word;
+            memcpy(&word, &frame_ptr[i], sizeof(word));
+            if (!ums_cobs_has_zero(word))
+            {
+                i += 4U;
+                continue;
+            }
+        }
+        if (frame_ptr[i] == UMS_COBS_DELIMITER)
+        {
+            frame_ptr[code_index] = (uint8_t)(i - code_index);
+            code_index = i;
+        }
+        i++;
+    }
+    frame_ptr[code_index] = (uint8_t)(length + 1U - code_index);
+    frame_ptr[length + 1U] = UMS_COBS_DELIMITER;
+
+    return length + UMS_COBS_OVERHEAD;
+}
+
+uint16_t ums_cobs_encode(const uint8_t *src_ptr, const uint16_t length, uint8_t *dst_ptr)
+{
+    uint16_t code_index = 0;
+    uint16_t out = 1U;
+    uint8_t code = 1U;
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        // Read before the write below, which may land on the same byte when encoding in place.
+        const uint8_t byte = src_ptr[i];
+        if (byte == UMS_COBS_DELIMITER)
+        {
+            dst_ptr[code_index] = code;
+            code_index = out++;
+            code = 1U;
+            continue;
+        }
+
+        dst_ptr[out++] = byte;
+        code++;
+        if (code == UMS_COBS_MAX_RUN + 1U)
+        {
+            dst_ptr[code_index] = code;
+            code_index = out++;
+            code = 1U;
+        }
+    }
+    dst_ptr[code_index] = code;
+    dst_ptr[out++] = UMS_COBS_DELIMITER;
+
+    return out;
+}
@@ -0,0 +1,131 @@
+//
+//
+//
+
+#include "string.h"
+
+#include "ums/copy_plan.h"
+
+static uint8_t ums_copy_kind_for_length(const uint16_t length)
+{
+    switch (length)
+    {
+    case 1U: return UMS_COPY_8BIT;
+    case 2U: return UMS_COPY_16BIT;
+    case 4U: return UMS_COPY_32BIT;
+    case 8U: return UMS_COPY_64BIT;
+    default: return UMS_COPY_BLOCK;
+    }
+}
+
+/**
+ * Runs ops [op, end), writing each at dst_ptr + (dst_offset - base).
+ */
+static void ums_copy_ops_execute(const ums_copy_op_t *op, const ums_copy_op_t *end, uint8_t *dst_ptr,
+                                 const uint16_t base)
+{
+    // Constant-size memcpy is lowered to a single (unaligned-safe) load/store by the compiler.
+    for (; op != end; op++)
+    {
+        uint8_t *dst = dst_ptr + (op->dst_offset - base);
+        switch (op->kind)
+        {
+        case UMS_COPY_8BIT:  *dst = *(const uint8_t*)op->src_ptr; break;
+        case UMS_COPY_16BIT: memcpy(dst, op->src_ptr, 2U); break;
+        case UMS_COPY_32BIT: memcpy(dst, op->src_ptr, 4U); break;
+        case UMS_COPY_64BIT: memcpy(dst, op->src_ptr, 8U); break;
+        default:             memcpy(dst, op->src_ptr, op->length); break;
+        }
+    }
+}
+
+void ums_copy_plan_reset(ums_copy_plan_t *plan)
+{
+    plan->op_count = 0;
+    plan->payload_size = 0;
+    memset(plan->groups, 0, sizeof(plan->groups));
+}
+
+ums_err_t ums_copy_plan_append(ums_copy_plan_t *plan, const void *src_ptr, const uint16_t length)
+{
+    return ums_copy_plan_append_group(plan, 0, src_ptr, length);
+}
+
+ums_err_t ums_copy_plan_append_group(ums_copy_plan_t *plan, const uint8_t group, const void *src_ptr,
+                                     const uint16_t length)
+{
+    if (!plan || !src_ptr)
+    {
+        return UMS_NULL_POINTER;
+    }
+    if (group >= UMS_MAX_GROUPS)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+    if (length == 0 || (plan->payload_size + length) > UMS_MAX_PAYLOAD_SIZE)
+    {
+        return UMS_RANGE_ERROR;
+    }
+
+    ums_copy_group_t *grp = &plan->groups[group];
+    uint8_t next_op = grp->first_op + grp->op_count;
+
+    ums_copy_op_t *last = (grp->op_count > 0) ? &plan->ops[next_op - 1] : nullptr;
+    if (last && (const uint8_t*)last->src_ptr + last->length == (const uint8_t*)src_ptr)
+    {
+        last->length += length;
+        last->kind = ums_copy_kind_for_length(last->length);
+    }
+    else
+    {
+        if (plan->op_count == UMS_MAX_CHANNELS)
+        {
+            return UMS_RANGE_ERROR;
+        }
+
+        // Open a slot at the end of this group's segment.
+        memmove(&plan->ops[next_op + 1], &plan->ops[next_op], (plan->op_count - next_op) * sizeof(ums_copy_op_t));
+
+        ums_copy_op_t *op = &plan->ops[next_op];
+        op->src_ptr = src_ptr;
+        op->dst_offset = grp->payload_offset + grp->payload_size;
+        op->length = length;
+        op->kind = ums_copy_kind_for_length(length);
+
+        plan->op_count++;
+        grp->op_count++;
+        next_op++;
+        for (uint8_t g = group + 1U; g < UMS_MAX_GROUPS; g++)
+        {
+            plan->groups[g].first_op++;
+        }
+    }
+
+    // Later groups move back by the added bytes.
+    for (uint8_t i = next_op; i < plan->op_count; i++)
+    {
+        plan->ops[i].dst_offset += length;
+    }
+    for (uint8_t g = group + 1U; g < UMS_MAX_GROUPS; g++)
+    {
+        plan->groups[g].payload_offset += length;
+    }
+
+    grp->payload_size += length;
+    plan->payload_size += length;
+
+    return UMS_SUCCESS;
+}
+
+void ums_copy_plan_execute(const ums_copy_plan_t *plan, uint8_t *dst_ptr)
+{
+    ums_copy_ops_execute(plan->ops, plan->ops + plan->op_count, dst_ptr, 0);
+}
+
+void ums_copy_plan_execute_group(const ums_copy_plan_t *plan, const uint8_t group, uint8_t *dst_ptr)
+{
+    const ums_copy_group_t *grp = &plan->groups[group];
+    const ums_copy_op_t *first = &plan->ops[grp->first_op];
+
+    ums_copy_ops_execute(first, first + grp->op_count, dst_ptr, grp->payload_offset);
+}
@@ -4,76 +4,1499 @@
 
 #include "string.h"
 
-#include "ums/triple_buffer.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include "x86intrin.h"
+#elif defined(__linux__)
+#include "time.h"
+#endif
+
+#include "ums/context.h"
 #include "ums/ums_core.h"
 
-/**
- * triple buffer array to store the sample_packets in.
- * During transmission, send the data on the address of the index of the array that is the write index,
- * but calculate the size of the data in that function and only transmit the necessary length for optimization.
- */
-sample_packet_t     ums_triple_buffer[3];
-volatile uint8_t    idx_write           = 0;
-volatile uint8_t    idx_read            = 1;
-volatile uint8_t    idx_spare           = 2;
+/**
+ * How packed samples reach the transmit function.
+ * TRIPLE_BUFFER is the default, QUEUE, BATCH, SCOPE and GATHER are selected by ums_queue_setup(),
+ * ums_batch_setup(), ums_scope_setup() and ums_gather_setup().
+ */
+typedef enum ums_delivery_t {
+    UMS_DELIVERY_TRIPLE_BUFFER = 0,
+    UMS_DELIVERY_QUEUE,
+    UMS_DELIVERY_BATCH,
+    UMS_DELIVERY_SCOPE,
+    UMS_DELIVERY_GATHER,
+} ums_delivery_t;
+
+/**
+ * Handshake transmission, see ums_send_handshake().
+ */
+typedef enum ums_handshake_state_t {
+    UMS_HANDSHAKE_IDLE = 0,
+    UMS_HANDSHAKE_PENDING,
+    UMS_HANDSHAKE_BUSY,
+} ums_handshake_state_t;
+
+/**
+ * Context used by the ums_* functions without ctx argument.
+ */
+static ums_context_t s_default_context;
+
+/**
+ * Largest frame ums_pack_frame() can produce with the current registry and encoding.
+ */
+static uint16_t ums_max_frame_size(ums_context_t *ctx)
+{
+    uint16_t extra = ctx->sequence_size + ums_crc_size(ctx->crc);
+    if (ctx->sync_interval != 0)
+    {
+        extra += UMS_SYNC_MARKER_SIZE;
+    }
+    if (ctx->framing == UMS_FRAMING_COBS)
+    {
+        extra += UMS_COBS_OVERHEAD;
+    }
+    if (ctx->group_count > 1U)
+    {
+        return extra + ctx->actual_frame_size + 1U;
+    }
+    if (ctx->encoding == UMS_ENCODING_RAW)
+    {
+        return extra + ctx->actual_frame_size;
+    }
+    return extra + ums_delta_encoder_max_size(&ctx->delta_encoder, ctx->encoding);
+}
+
+/**
+ * Decimation factor keeping frames of frame_size bytes at update_rate within bytes_per_second, rounded up.
+ */
+static uint16_t ums_rate_limit_factor(const uint32_t bytes_per_second, const uint32_t update_rate,
+                                      const uint16_t frame_size)
+{
+    const uint64_t demand = (uint64_t)update_rate * frame_size;
+    const uint64_t factor = (demand + bytes_per_second - 1U) / bytes_per_second;
+    if (factor == 0)
+    {
+        return 1U;
+    }
+    return (factor > UINT16_MAX) ? UINT16_MAX : (uint16_t)factor;
+}
+
+/**
+ * Counts one frame towards the next sync marker.
+ * @param [in] replaces_pending whether the frame replaces an unsent one, which then hands its marker on.
+ * @return true if the frame gets the marker.
+ */
+static bool ums_sync_due(ums_context_t *ctx, const bool replaces_pending)
+{
+    if (ctx->sync_interval == 0)
+    {
+        return false;
+    }
+    if (replaces_pending && ctx->sync_carry)
+    {
+        return true;
+    }
+    ctx->sync_carry = (ctx->sync_countdown == 0);
+    if (ctx->sync_carry)
+    {
+        ctx->sync_countdown = ctx->sync_interval;
+    }
+    ctx->sync_countdown--;
+    return ctx->sync_carry;
+}
+
+/**
+ * Multi-rate frame: group mask (1 byte), timestamp, then the payload block of every due group
+ * in ascending group order, each in registration order.
+ * @param [out] dst_ptr frame destination, at least ums_max_frame_size() bytes.
+ * @param [in] timestamp sample timestamp.
+ * @return frame length in bytes.
+ */
+static uint16_t ums_pack_group_frame(ums_context_t *ctx, uint8_t *dst_ptr, const uint32_t timestamp)
+{
+    const uint8_t due = ctx->due_groups;
+    dst_ptr[0] = due;
+    memcpy(&dst_ptr[1], &timestamp, sizeof(timestamp));
+
+    uint16_t length = 1U + sizeof(timestamp);
+    for (uint8_t g = 0; g < ctx->group_count; g++)
+    {
+        if (due & (1U << g))
+        {
+            ums_copy_plan_execute_group(&ctx->copy_plan, g, &dst_ptr[length]);
+            length += ctx->copy_plan.groups[g].payload_size;
+        }
+    }
+    return length;
+}
+
+/**
+ * Advances every group's countdown by one ums_update() tick.
+ * @return mask of the non-empty groups due on this tick.
+ */
+static uint8_t ums_tick_groups(ums_context_t *ctx)
+{
+    uint8_t due = 0;
+    for (uint8_t g = 0; g < ctx->group_count; g++)
+    {
+        if (ctx->group_countdown[g] == 0)
+        {
+            ctx->group_countdown[g] = ctx->group_divider[g] - 1U;
+            if (ctx->copy_plan.groups[g].payload_size != 0)
+            {
+                due |= (uint8_t)(1U << g);
+            }
+        }
+        else
+        {
+            ctx->group_countdown[g]--;
+        }
+    }
+    return due;
+}
+
+/**
+ * Accumulates every aggregated channel, called on every ums_update() tick.
+ */
+static void ums_tick_aggregators(ums_context_t *ctx)
+{
+    for (uint8_t i = 0; i < ctx->aggregator_count; i++)
+    {
+        ums_aggregator_accumulate(&ctx->aggregators[i]);
+    }
+}
+
+/**
+ * Finishes the aggregates of the groups in the frame about to be packed. Only a packed frame closes a window,
+ * so ticks that were gated, skipped by the rate limit or dropped roll over into the next frame's aggregate.
+ */
+static void ums_finish_aggregators(ums_context_t *ctx)
+{
+    for (uint8_t i = 0; i < ctx->aggregator_count; i++)
+    {
+        ums_aggregator_t *agg = &ctx->aggregators[i];
+        if (ctx->due_groups & (1U << agg->group))
+        {
+            ums_aggregator_finish(agg);
+        }
+    }
+}
+
+/**
+ * Evaluates the trigger once per ums_update() tick. In scope mode the trigger freezes the deep capture,
+ * otherwise it gates streaming.
+ * @return false when this sample is gated off.
+ */
+static bool ums_apply_trigger(ums_context_t *ctx)
+{
+    if (ctx->delivery == UMS_DELIVERY_SCOPE)
+    {
+        if (ums_trigger_evaluate(&ctx->trigger))
+        {
+            ums_ctx_scope_trigger(ctx);
+        }
+        return true;
+    }
+    return ums_trigger_gate(&ctx->trigger);
+}
+
+/**
+ * Packs timestamp and traced variables into dst_ptr in the configured encoding.
+ * @param [out] dst_ptr frame destination, at least ums_max_frame_size() bytes.
+ * @param [in] timestamp sample timestamp.
+ * @return frame length in bytes.
+ */
+static uint16_t ums_pack_body(ums_context_t *ctx, uint8_t *dst_ptr, const uint32_t timestamp)
+{
+    if (ctx->encoding == UMS_ENCODING_DELTA)
+    {
+        ums_copy_plan_execute(&ctx->copy_plan, ums_delta_encoder_snapshot(&ctx->delta_encoder));
+        return ums_delta_encode(&ctx->delta_encoder, timestamp, dst_ptr);
+    }
+    if (ctx->encoding == UMS_ENCODING_CHANGED)
+    {
+        ums_copy_plan_execute(&ctx->copy_plan, ums_delta_encoder_snapshot(&ctx->delta_encoder));
+        return ums_changed_encode(&ctx->delta_encoder, timestamp, dst_ptr);
+    }
+
+    if (ctx->group_count > 1U)
+    {
+        return ums_pack_group_frame(ctx, dst_ptr, timestamp);
+    }
+
+    memcpy(dst_ptr, &timestamp, sizeof(timestamp));
+    ums_copy_plan_execute(&ctx->copy_plan, dst_ptr + sizeof(timestamp));
+    return ctx->actual_frame_size;
+}
+
+/**
+ * ums_pack_body() behind the sync marker when one is due and the sequence number when enabled.
+ * A frame behind a marker is a keyframe, so a host that just found the marker can decode it.
+ * @param [out] dst_ptr frame destination, at least ums_max_frame_size() bytes.
+ * @param [in] timestamp sample timestamp.
+ * @return frame length in bytes, marker and sequence number included.
+ */
+static uint16_t ums_pack_marked(ums_context_t *ctx, uint8_t *dst_ptr, const uint32_t timestamp)
+{
+    // Only the triple buffer replaces a frame that was never sent.
+    const bool replaces_pending = ctx->delivery == UMS_DELIVERY_TRIPLE_BUFFER
+                                  && ums_triple_buffer_pending(&ctx->triple_buffer);
+    uint16_t offset = 0;
+    if (ums_sync_due(ctx, replaces_pending))
+    {
+        memcpy(dst_ptr, ctx->sync_marker, UMS_SYNC_MARKER_SIZE);
+        offset = UMS_SYNC_MARKER_SIZE;
+        if (ctx->encoding != UMS_ENCODING_RAW)
+        {
+            ums_delta_encoder_force_keyframe(&ctx->delta_encoder);
+        }
+    }
+
+    // Numbered by capture, so samples dropped before they were packed leave a gap too.
+    const uint16_t sequence = (uint16_t)(ctx->link_stats.captured - 1U);
+    memcpy(&dst_ptr[offset], &sequence, ctx->sequence_size);
+    offset += ctx->sequence_size;
+
+    return offset + ums_pack_body(ctx, dst_ptr + offset, timestamp);
+}
+
+/**
+ * ums_pack_marked() followed by the CRC trailer when enabled.
+ * @param [out] dst_ptr frame destination, at least ums_max_frame_size() bytes.
+ * @param [in] timestamp sample timestamp.
+ * @return frame length in bytes, trailer included.
+ */
+static uint16_t ums_pack_checked(ums_context_t *ctx, uint8_t *dst_ptr, const uint32_t timestamp)
+{
+    const uint16_t length = ums_pack_marked(ctx, dst_ptr, timestamp);
+    if (ctx->crc == UMS_CRC_NONE)
+    {
+        return length;
+    }
+
+    // Computed over the packed frame while it is still in cache, no second pass over the variables.
+    const uint32_t crc = ums_crc_compute((ums_crc_t)ctx->crc, dst_ptr, length);
+    const uint8_t size = ums_crc_size((ums_crc_t)ctx->crc);
+    memcpy(&dst_ptr[length], &crc, size);
+    return length + size;
+}
+
+/**
+ * Packs a complete wire frame: ums_pack_checked(), COBS stuffed when framing is enabled.
+ * @param [out] dst_ptr frame destination, at least ums_max_frame_size() bytes.
+ * @param [in] timestamp sample timestamp.
+ * @return frame length in bytes.
+ */
+static uint16_t ums_pack_frame(ums_context_t *ctx, uint8_t *dst_ptr, const uint32_t timestamp)
+{
+    ums_finish_aggregators(ctx);
+    if (ctx->framing == UMS_FRAMING_COBS)
+    {
+        // Packed one byte in and stuffed where it lies, the payload is still copied exactly once.
+        return ums_cobs_stuff(dst_ptr, ums_pack_checked(ctx, dst_ptr + 1U, timestamp));
+    }
+    return ums_pack_checked(ctx, dst_ptr, timestamp);
+}
+
+/**
+ * Queue variant of ums_create_sample(), used once ums_queue_setup() succeeded.
+ * Packs the sample into a free queue slot, ums_kick() or ums_transfer_complete_callback() sends it.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_BUFFER_FULL when the overflow policy dropped the sample.
+ */
+static ums_err_t ums_create_queued_sample(ums_context_t *ctx)
+{
+    const uint32_t dropped = ctx->frame_queue.stats.dropped;
+    sample_packet_t *packet = ums_frame_queue_acquire(&ctx->frame_queue);
+    if (!packet)
+    {
+        return UMS_BUFFER_FULL;
+    }
+    // A pending frame evicted to make room (UMS_DROP_OLDEST) is lost just the same.
+    ctx->link_stats.dropped += ctx->frame_queue.stats.dropped - dropped;
+
+    const uint16_t length = ums_pack_frame(ctx, (uint8_t*)packet, ums_platform_get_timestamp());
+    ums_frame_queue_publish(&ctx->frame_queue, length);
+
+    return UMS_SUCCESS;
+}
+
+/**
+ * Marks the start of the transfer about to be handed to the transport, see ums_set_instrumentation().
+ */
+static void ums_stamp_transfer(ums_context_t *ctx)
+{
+    ctx->instrumentation.transfer_start = ums_platform_get_cycles();
+    ctx->instrumentation.transfer_timed = true;
+}
+
+/**
+ * Hands a frame to the transmit function, stamping the start of the transfer while instrumentation is enabled.
+ */
+static void ums_start_transfer(ums_context_t *ctx, void *data_ptr, const uint16_t length)
+{
+    if (ctx->instrumentation.enabled)
+    {
+        ums_stamp_transfer(ctx);
+    }
+    ctx->transmit_function_ptr(data_ptr, length);
+}
+
+/**
+ * Starts transmission of the sealed batch if the link is idle.
+ */
+static void ums_kick_batch(ums_context_t *ctx)
+{
+    uint16_t length = 0;
+
+    ums_platform_enter_critical();
+    uint8_t *data = ums_batch_claim(&ctx->batch, &length);
+    ums_platform_exit_critical();
+
+    if (data)
+    {
+        ums_start_transfer(ctx, (void*)data, length);
+    }
+}
+
+/**
+ * Seals a partial batch whose timeout expired, also on ticks that pack no frame (gated, not due, decimated).
+ */
+static void ums_expire_batch(ums_context_t *ctx)
+{
+    if (ctx->batch.timeout == 0U || ctx->batch.frame_count == 0)
+    {
+        return;
+    }
+    const uint32_t timestamp = ums_platform_get_timestamp();
+
+    ums_platform_enter_critical();
+    ums_batch_expire(&ctx->batch, timestamp);
+    ums_platform_exit_critical();
+}
+
+/**
+ * Batch variant of ums_create_sample(), used once ums_batch_setup() succeeded.
+ * Appends the frame to the batch being filled, ums_kick() sends the batch once it is sealed.
+ * @param [in] kick whether a sealed half may be sent to make room for this frame.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_BUFFER_FULL when both halves are in use.
+ */
+static ums_err_t ums_create_batched_sample(ums_context_t *ctx, const bool kick)
+{
+    const uint16_t max_frame_size = ums_max_frame_size(ctx);
+    uint8_t *frame = ums_batch_reserve(&ctx->batch, max_frame_size);
+    if (!frame)
+    {
+        if (!kick)
+        {
+            return UMS_BUFFER_FULL;
+        }
+        // A half sealed because this frame did not fit still has to go out.
+        ums_kick_batch(ctx);
+        frame = ums_batch_reserve(&ctx->batch, max_frame_size);
+        if (!frame)
+        {
+            return UMS_BUFFER_FULL;
+        }
+    }
+
+    const uint32_t timestamp = ums_platform_get_timestamp();
+    const uint16_t length = ums_pack_frame(ctx, frame, timestamp);
+
+    ums_batch_commit(&ctx->batch, length, max_frame_size, timestamp);
+
+    return UMS_SUCCESS;
+}
+
+/**
+ * Starts draining the scope window once it is frozen. Later frames follow from ums_transfer_complete_callback().
+ */
+static void ums_kick_scope(ums_context_t *ctx)
+{
+    if (ctx->scope.state != UMS_SCOPE_FROZEN)
+    {
+        return;
+    }
+
+    uint16_t length = 0;
+    uint8_t *frame = ums_scope_ring_next(&ctx->scope, &length);
+    if (frame)
+    {
+        ums_start_transfer(ctx, (void*)frame, length);
+    }
+}
+
+/**
+ * Scope variant of ums_create_sample(), used once ums_scope_setup() succeeded.
+ * Records the frame into the scope ring without transmitting. While a captured window is frozen, draining or done,
+ * nothing is recorded, ums_kick() starts draining a frozen window. Samples not recorded and history frames
+ * overwritten by the ring never reach the host and count as dropped.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+static ums_err_t ums_create_scoped_sample(ums_context_t *ctx)
+{
+    uint8_t *frame = ums_scope_ring_reserve(&ctx->scope);
+    if (!frame)
+    {
+        ctx->link_stats.dropped++;
+        return UMS_SUCCESS;
+    }
+
+    const uint16_t length = ums_pack_frame(ctx, frame, ums_platform_get_timestamp());
+
+    ums_platform_enter_critical();
+    if (ctx->scope.filled == ctx->scope.slot_count)
+    {
+        ctx->link_stats.dropped++;
+    }
+    ums_scope_ring_commit(&ctx->scope, length);
+    ums_platform_exit_critical();
+
+    return UMS_SUCCESS;
+}
+
+/**
+ * Rebuilds the gather list from the copy plan: sync marker, timestamp, then one element per op, so adjacent
+ * traced variables share an element exactly like they share a copy. gather_count excludes the marker, which is
+ * only sent when due.
+ */
+static void ums_gather_compile(ums_context_t *ctx)
+{
+    uint8_t count = 0;
+    ctx->gather_list[count++] = (ums_iovec_t){ctx->sync_marker, UMS_SYNC_MARKER_SIZE};
+    if (ctx->sequence_size != 0)
+    {
+        ctx->gather_list[count++] = (ums_iovec_t){&ctx->gather_sequence, ctx->sequence_size};
+    }
+    ctx->gather_list[count++] = (ums_iovec_t){&ctx->gather_timestamp, sizeof(ctx->gather_timestamp)};
+
+    for (uint8_t i = 0; i < ctx->copy_plan.op_count; i++)
+    {
+        ctx->gather_list[count++] = (ums_iovec_t){ctx->copy_plan.ops[i].src_ptr, ctx->copy_plan.ops[i].length};
+    }
+    ctx->gather_count = count - 1U;
+}
+
+/**
+ * Starts the gather transfer of the pending sample if the link is idle.
+ */
+static void ums_kick_gather(ums_context_t *ctx)
+{
+    ums_platform_enter_critical();
+    const bool start = ctx->gather_pending && !ctx->gather_busy;
+    if (start)
+    {
+        ctx->gather_pending = false;
+        ctx->gather_busy = true;
+    }
+    ums_platform_exit_critical();
+
+    const uint16_t length = ctx->sequence_size + ctx->actual_frame_size;
+    if (start && ctx->instrumentation.enabled)
+    {
+        ums_stamp_transfer(ctx);
+    }
+    if (start && ctx->gather_sync)
+    {
+        ctx->gather_function_ptr(ctx->gather_list, ctx->gather_count + 1U, UMS_SYNC_MARKER_SIZE + length);
+    }
+    else if (start)
+    {
+        ctx->gather_function_ptr(&ctx->gather_list[1], ctx->gather_count, length);
+    }
+}
+
+/**
+ * Creates a new sample with the current values of the traced variables.
+ * The payload is filled by executing the copy plan compiled in ums_trace(), no per-channel type dispatch.
+ * Writes the sample packet to the write index and swaps the write index with the spare index.
+ * Never calls the transmit function, see ums_kick().
+ * @param [in] kick whether the caller kicks the transmission afterwards (ums_update()) or not (ums_capture()).
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+static ums_err_t ums_create_sample(ums_context_t *ctx, const bool kick)
+{
+    if (ctx->channel_count == 0)
+    {
+        return UMS_RANGE_ERROR;
+    }
+    if (ctx->delivery == UMS_DELIVERY_QUEUE)
+    {
+        return ums_create_queued_sample(ctx);
+    }
+    if (ctx->delivery == UMS_DELIVERY_BATCH)
+    {
+        return ums_create_batched_sample(ctx, kick);
+    }
+    if (ctx->delivery == UMS_DELIVERY_SCOPE)
+    {
+        return ums_create_scoped_sample(ctx);
+    }
+    if (ctx->delivery == UMS_DELIVERY_GATHER)
+    {
+        // Nothing to pack, the gather list already points at the variables and aggregate results.
+        ums_finish_aggregators(ctx);
+        ctx->gather_sync = ums_sync_due(ctx, ctx->gather_pending);
+        ctx->gather_sequence = (uint16_t)(ctx->link_stats.captured - 1U);
+        ctx->gather_timestamp = ums_platform_get_timestamp();
+        ctx->gather_pending = true;
+        return UMS_SUCCESS;
+    }
+
+    sample_packet_t *packet = ums_triple_buffer_write_slot(&ctx->triple_buffer);
+    const uint16_t length = ums_pack_frame(ctx, (uint8_t*)packet, ums_platform_get_timestamp());
+    if (ums_triple_buffer_publish(&ctx->triple_buffer, length))
+    {
+        // Latest value wins, the replaced frame never reaches the host.
+        ctx->link_stats.dropped++;
+    }
+
+    return UMS_SUCCESS;
+}
+
+/**
+ * Builds the handshake of the current layout into the context and derives layout hash and sync marker from it.
+ * Must not run while the handshake is on the wire.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS, UMS_RANGE_ERROR when it does not fit UMS_HANDSHAKE_MAX_SIZE.
+ */
+static ums_err_t ums_build_handshake(ums_context_t *ctx)
+{
+    const ums_handshake_layout_t layout = {
+        .channels = ctx->registry,
+        .channel_count = ctx->channel_count,
+        .encoding = ctx->encoding,
+        .sequence_size = ctx->sequence_size,
+        .crc = ctx->crc,
+        .group_divider = ctx->group_divider,
+        .group_count = ctx->group_count,
+    };
+    const bool cobs = (ctx->framing == UMS_FRAMING_COBS);
+    uint8_t *packet = cobs ? &ctx->handshake[UMS_COBS_MAX_OVERHEAD(UMS_HANDSHAKE_MAX_SIZE)] : ctx->handshake;
+    const ums_err_t err = ums_handshake_build(&layout, packet, UMS_HANDSHAKE_MAX_SIZE, &ctx->handshake_length);
+    if (err != UMS_SUCCESS)
+    {
+        return err;
+    }
+    ctx->layout_hash = ums_handshake_layout_hash(packet);
+    if (cobs)
+    {
+        ctx->handshake_length = ums_cobs_encode(packet, ctx->handshake_length, ctx->handshake);
+    }
+    ctx->handshake_timestamp = ums_platform_get_timestamp();
+    ums_sync_marker_build(ctx->layout_hash, ctx->sync_marker);
+
+    return UMS_SUCCESS;
+}
+
+/**
+ * Queues the last built handshake again once handshake_interval ticks passed since it was built or queued,
+ * for hosts that attached after it went out. Sent by the next ums_kick().
+ */
+static void ums_requeue_handshake(ums_context_t *ctx)
+{
+    const uint32_t now = ums_platform_get_timestamp();
+    if (ctx->handshake_state == UMS_HANDSHAKE_IDLE
+        && (uint32_t)(now - ctx->handshake_timestamp) >= ctx->handshake_interval)
+    {
+        ctx->handshake_timestamp = now;
+        ctx->handshake_state = UMS_HANDSHAKE_PENDING;
+    }
+}
+
+/**
+ * Marks the link busy for the handshake if no transfer of the current delivery is in progress.
+ * Released by ums_transfer_complete_callback() like a sample transfer.
+ * @return true if the link was reserved.
+ */
+static bool ums_reserve_link(ums_context_t *ctx)
+{
+    if (ctx->delivery == UMS_DELIVERY_QUEUE)
+    {
+        return ums_frame_queue_reserve(&ctx->frame_queue);
+    }
+    if (ctx->delivery == UMS_DELIVERY_TRIPLE_BUFFER)
+    {
+        return ums_triple_buffer_reserve(&ctx->triple_buffer);
+    }
+
+    bool reserved = false;
+    ums_platform_enter_critical();
+    if (ctx->delivery == UMS_DELIVERY_BATCH && !ctx->batch.tx_busy)
+    {
+        ctx->batch.tx_busy = true;
+        reserved = true;
+    }
+    else if (ctx->delivery == UMS_DELIVERY_GATHER && !ctx->gather_busy)
+    {
+        ctx->gather_busy = true;
+        reserved = true;
+    }
+    else if (ctx->delivery == UMS_DELIVERY_SCOPE && ctx->scope.state != UMS_SCOPE_FROZEN
+             && ctx->scope.state != UMS_SCOPE_DRAINING)
+    {
+        // Nothing is transmitted outside of a drain, a trigger meanwhile waits for the handshake.
+        reserved = true;
+    }
+    ums_platform_exit_critical();
+
+    return reserved;
+}
+
+/**
+ * Starts the pending handshake once the link is free.
+ * @return true while the handshake is on the wire, no sample transfer may start then.
+ */
+static bool ums_kick_handshake(ums_context_t *ctx)
+{
+    if (ctx->handshake_state == UMS_HANDSHAKE_PENDING && ums_reserve_link(ctx))
+    {
+        ctx->handshake_state = UMS_HANDSHAKE_BUSY;
+        ums_start_transfer(ctx, (void*)ctx->handshake, ctx->handshake_length);
+    }
+    return ctx->handshake_state == UMS_HANDSHAKE_BUSY;
+}
+
+/**
+ * Starts transmission of the newest published frame, the next queued frame, a sealed batch, a frozen
+ * scope window or the pending gather list, whichever applies to the delivery. No-op while the link is busy.
+ * A pending handshake goes first.
+ */
+static void ums_kick(ums_context_t *ctx)
+{
+    if (ctx->handshake_state != UMS_HANDSHAKE_IDLE && ums_kick_handshake(ctx))
+    {
+        return;
+    }
+    if (ctx->delivery == UMS_DELIVERY_GATHER)
+    {
+        ums_kick_gather(ctx);
+        return;
+    }
+    if (ctx->delivery == UMS_DELIVERY_BATCH)
+    {
+        ums_kick_batch(ctx);
+        return;
+    }
+    if (ctx->delivery == UMS_DELIVERY_SCOPE)
+    {
+        ums_kick_scope(ctx);
+        return;
+    }
+
+    uint16_t length = 0;
+    sample_packet_t *next = (ctx->delivery == UMS_DELIVERY_QUEUE)
+                          ? ums_frame_queue_claim(&ctx->frame_queue, &length)
+                          : ums_triple_buffer_claim(&ctx->triple_buffer, &length);
+    if (next)
+    {
+        ums_start_transfer(ctx, (void*)next, length);
+    }
+}
+
+/**
+ * @return true for block and struct channels, which the delta/changed encoders cannot split into scalars.
+ */
+static bool ums_channel_is_block(const data_channel_t *channel)
+{
+    return channel->var_type == UMS_STRUCT || channel->count > 1U;
+}
+
+/**
+ * Registry entry of a single scalar variable.
+ */
+static data_channel_t ums_scalar_channel(void *var_ptr, char *var_name_ptr, const ums_datatype_t var_type,
+                                         const uint8_t group)
+{
+    return (data_channel_t){
+        .var_ptr = var_ptr,
+        .var_type = var_type,
+        .var_name_ptr = var_name_ptr,
+        .group = group,
+        .count = 1U,
+        .size = ums_datatype_size(var_type),
+    };
+}
+
+/**
+ * Puts ctx into the state of a freshly destroyed stream: no channels, raw encoding, triple buffer delivery.
+ */
+static void ums_context_reset(ums_context_t *ctx)
+{
+    memset(ctx, 0, sizeof(*ctx));
+    ums_triple_buffer_init(&ctx->triple_buffer);
+    ums_delta_encoder_reset(&ctx->delta_encoder);
+    ctx->encoding = UMS_ENCODING_RAW;
+    ctx->delivery = UMS_DELIVERY_TRIPLE_BUFFER;
+    ctx->group_divider[0] = 1U;
+    ctx->group_count = 1U;
+    ctx->due_groups = 0x01U;
+    ctx->actual_frame_size = sizeof(uint32_t);
+}
+
+ums_err_t ums_ctx_setup(ums_context_t *ctx, const transmit_function transmit_function_ptr)
+{
+    if (!ctx || !transmit_function_ptr)
+    {
+        return UMS_NULL_POINTER;
+    }
+    if (!ctx->initialized)
+    {
+        // Caller-owned contexts may hold anything before their first setup.
+        ums_context_reset(ctx);
+    }
+    ctx->transmit_function_ptr = transmit_function_ptr;
+    ums_triple_buffer_init(&ctx->triple_buffer);
+    ctx->initialized = true;
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_queue_setup(ums_context_t *ctx, sample_packet_t *slots, const uint8_t slot_count,
+                              const ums_overflow_policy_t policy)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (ctx->delivery != UMS_DELIVERY_TRIPLE_BUFFER)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+
+    if (policy == UMS_DROP_OLDEST && ctx->encoding != UMS_ENCODING_RAW)
+    {
+        // Dropping an already encoded frame would break the delta chain of the frames queued after it.
+        return UMS_INVALID_PARAMETER;
+    }
+
+    const ums_err_t err = ums_frame_queue_init(&ctx->frame_queue, slots, slot_count, policy);
+    if (err != UMS_SUCCESS)
+    {
+        return err;
+    }
+    ctx->delivery = UMS_DELIVERY_QUEUE;
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_batch_setup(ums_context_t *ctx, uint8_t *buffer, const uint16_t buffer_size,
+                              const uint8_t frames_per_batch, const uint32_t timeout)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (ctx->delivery != UMS_DELIVERY_TRIPLE_BUFFER)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+    if ((buffer_size / 2U) < UMS_MAX_WIRE_FRAME_SIZE)
+    {
+        return UMS_RANGE_ERROR;
+    }
+
+    const ums_err_t err = ums_batch_init(&ctx->batch, buffer, buffer_size, frames_per_batch, timeout);
+    if (err != UMS_SUCCESS)
+    {
+        return err;
+    }
+    ctx->delivery = UMS_DELIVERY_BATCH;
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_scope_setup(ums_context_t *ctx, uint8_t *buffer, const uint32_t buffer_size,
+                              const uint32_t post_trigger)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (ctx->delivery != UMS_DELIVERY_TRIPLE_BUFFER || ctx->encoding != UMS_ENCODING_RAW)
+    {
+        // Overwriting the oldest frames would break the chain of a stateful encoding.
+        return UMS_INVALID_PARAMETER;
+    }
+    if (ctx->channel_count == 0)
+    {
+        return UMS_RANGE_ERROR;
+    }
+
+    const ums_err_t err = ums_scope_ring_init(&ctx->scope, buffer, buffer_size, ums_max_frame_size(ctx), post_trigger);
+    if (err != UMS_SUCCESS)
+    {
+        return err;
+    }
+    ctx->delivery = UMS_DELIVERY_SCOPE;
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_scope_trigger(ums_context_t *ctx)
+{
+    if (ctx->delivery != UMS_DELIVERY_SCOPE)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+
+    ums_platform_enter_critical();
+    ums_scope_ring_trigger(&ctx->scope);
+    ums_platform_exit_critical();
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_scope_arm(ums_context_t *ctx)
+{
+    if (ctx->delivery != UMS_DELIVERY_SCOPE)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (ctx->scope.state == UMS_SCOPE_FROZEN || ctx->scope.state == UMS_SCOPE_DRAINING)
+    {
+        return UMS_BUFFER_FULL;
+    }
+
+    ums_platform_enter_critical();
+    // A window that was never drained is discarded.
+    if (ctx->scope.state != UMS_SCOPE_DONE)
+    {
+        ctx->link_stats.dropped += ctx->scope.filled;
+    }
+    ums_scope_ring_arm(&ctx->scope);
+    ums_platform_exit_critical();
+
+    return UMS_SUCCESS;
+}
+
+ums_scope_state_t ums_ctx_scope_get_state(ums_context_t *ctx)
+{
+    if (ctx->delivery != UMS_DELIVERY_SCOPE)
+    {
+        return UMS_SCOPE_IDLE;
+    }
+    return (ums_scope_state_t)ctx->scope.state;
+}
+
+ums_err_t ums_ctx_gather_setup(ums_context_t *ctx, const gather_transmit_function gather_function_ptr)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (!gather_function_ptr)
+    {
+        return UMS_NULL_POINTER;
+    }
+    if (ctx->delivery != UMS_DELIVERY_TRIPLE_BUFFER || ctx->encoding != UMS_ENCODING_RAW || ctx->group_count > 1U
+        || ctx->framing != UMS_FRAMING_NONE || ctx->crc != UMS_CRC_NONE)
+    {
+        // The wire frame has to be the traced variables as they are, back-to-back.
+        return UMS_INVALID_PARAMETER;
+    }
+
+    ctx->gather_function_ptr = gather_function_ptr;
+    ums_gather_compile(ctx);
+    ctx->delivery = UMS_DELIVERY_GATHER;
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_trigger_setup(ums_context_t *ctx, const ums_trigger_condition_t *conditions,
+                                const uint8_t condition_count, const uint16_t hold_off)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    // Compiled aside and swapped in whole, so a failed setup keeps the armed trigger and ums_update() never
+    // evaluates a half-written op list.
+    ums_trigger_t trigger;
+    memset(&trigger, 0, sizeof(trigger));
+    if (condition_count != 0)
+    {
+        const ums_err_t err = ums_trigger_compile(&trigger, conditions, condition_count, ctx->registry,
+                                                  ctx->channel_count, hold_off);
+        if (err != UMS_SUCCESS)
+        {
+            return err;
+        }
+    }
+
+    ums_platform_enter_critical();
+    ctx->trigger = trigger;
+    ums_platform_exit_critical();
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_set_encoding(ums_context_t *ctx, const ums_encoding_t encoding, const uint16_t keyframe_interval)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (encoding != UMS_ENCODING_RAW && encoding != UMS_ENCODING_DELTA && encoding != UMS_ENCODING_CHANGED)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+    if (encoding != UMS_ENCODING_RAW && ctx->delivery == UMS_DELIVERY_QUEUE && ctx->frame_queue.policy == UMS_DROP_OLDEST)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+    if (encoding != UMS_ENCODING_RAW
+        && (ctx->group_count > 1U || ctx->delivery == UMS_DELIVERY_SCOPE || ctx->delivery == UMS_DELIVERY_GATHER))
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+    for (uint8_t i = 0; encoding != UMS_ENCODING_RAW && i < ctx->channel_count; i++)
+    {
+        if (ums_channel_is_block(&ctx->registry[i]))
+        {
+            return UMS_INVALID_PARAMETER;
+        }
+    }
+
+    ums_delta_encoder_configure(&ctx->delta_encoder, keyframe_interval);
+    ctx->encoding = encoding;
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_set_framing(ums_context_t *ctx, const ums_framing_t framing)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (framing != UMS_FRAMING_NONE && framing != UMS_FRAMING_COBS)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+    if (framing != UMS_FRAMING_NONE && (ctx->delivery == UMS_DELIVERY_GATHER || ctx->delivery == UMS_DELIVERY_SCOPE))
+    {
+        // Gathered frames are never packed, the scope ring slots are sized for the frame at ums_scope_setup().
+        return UMS_INVALID_PARAMETER;
+    }
+
+    ctx->framing = framing;
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_flush(ums_context_t *ctx)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (ctx->delivery == UMS_DELIVERY_BATCH)
+    {
+        ums_platform_enter_critical();
+        ums_batch_seal(&ctx->batch);
+        ums_platform_exit_critical();
+    }
+    ums_kick(ctx);
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_send_handshake(ums_context_t *ctx)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (ctx->handshake_state == UMS_HANDSHAKE_BUSY)
+    {
+        // The previous handshake is still being read from the buffer.
+        return UMS_BUFFER_FULL;
+    }
+
+    const ums_err_t err = ums_build_handshake(ctx);
+    if (err != UMS_SUCCESS)
+    {
+        return err;
+    }
+    ctx->handshake_state = UMS_HANDSHAKE_PENDING;
+
+    ums_kick(ctx);
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_set_resync(ums_context_t *ctx, const uint16_t marker_interval, const uint32_t handshake_interval)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (marker_interval != 0 && ctx->delivery == UMS_DELIVERY_SCOPE)
+    {
+        // The scope ring slots are sized for the frame at ums_scope_setup().
+        return UMS_INVALID_PARAMETER;
+    }
+    if (ctx->handshake_state == UMS_HANDSHAKE_BUSY)
+    {
+        return UMS_BUFFER_FULL;
+    }
+
+    // The markers carry the hash of the layout as it is now.
+    const ums_err_t err = ums_build_handshake(ctx);
+    if (err != UMS_SUCCESS)
+    {
+        return err;
+    }
+    ctx->sync_interval = marker_interval;
+    ctx->sync_countdown = 0;
+    ctx->sync_carry = false;
+    ctx->handshake_interval = handshake_interval;
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_set_sequence(ums_context_t *ctx, const uint8_t size)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (size > UMS_MAX_SEQUENCE_SIZE)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+    if (size != ctx->sequence_size && ctx->delivery == UMS_DELIVERY_SCOPE)
+    {
+        // The scope ring slots are sized for the frame at ums_scope_setup().
+        return UMS_INVALID_PARAMETER;
+    }
+    // The gather list on the wire includes the sequence element, it may not change until the transfer completed.
+    if (size != ctx->sequence_size && ctx->delivery == UMS_DELIVERY_GATHER && ctx->gather_busy)
+    {
+        return UMS_BUFFER_FULL;
+    }
+
+    ctx->sequence_size = size;
+    if (ctx->delivery == UMS_DELIVERY_GATHER)
+    {
+        ums_gather_compile(ctx);
+    }
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_set_crc(ums_context_t *ctx, const ums_crc_t crc)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (crc != UMS_CRC_NONE && crc != UMS_CRC_16 && crc != UMS_CRC_32)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+    if (crc != UMS_CRC_NONE && ctx->delivery == UMS_DELIVERY_GATHER)
+    {
+        // Gathered frames are never packed, the variables are only read by the transport.
+        return UMS_INVALID_PARAMETER;
+    }
+    if (crc != ctx->crc && ctx->delivery == UMS_DELIVERY_SCOPE)
+    {
+        // The scope ring slots are sized for the frame at ums_scope_setup().
+        return UMS_INVALID_PARAMETER;
+    }
+
+    ctx->crc = crc;
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_get_link_stats(ums_context_t *ctx, ums_link_stats_t *stats)
+{
+    if (!stats)
+    {
+        return UMS_NULL_POINTER;
+    }
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    // transmitted is written by ums_transfer_complete_callback().
+    ums_platform_enter_critical();
+    *stats = ctx->link_stats;
+    ums_platform_exit_critical();
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_link_budget(ums_context_t *ctx, const uint32_t bytes_per_second, uint32_t *max_frame_rate)
+{
+    if (!max_frame_rate)
+    {
+        return UMS_NULL_POINTER;
+    }
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (ctx->channel_count == 0)
+    {
+        return UMS_RANGE_ERROR;
+    }
+
+    *max_frame_rate = bytes_per_second / ums_max_frame_size(ctx);
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_set_rate_limit(ums_context_t *ctx, const uint32_t bytes_per_second, const uint32_t update_rate)
+{
+    static char decimation_name[] = "ums.decimation";
+
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (bytes_per_second != 0 && update_rate == 0)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+    if (bytes_per_second != 0 && !ctx->rate_limit.traced)
+    {
+        const ums_err_t err = ums_ctx_trace(ctx, &ctx->rate_limit.decimation, decimation_name, UMS_UINT16);
+        if (err != UMS_SUCCESS)
+        {
+            return err;
+        }
+        ctx->rate_limit.traced = true;
+    }
+
+    // frame_size 0 rebases the factor on the next update.
+    ctx->rate_limit = (ums_rate_limit_t){
+        .bytes_per_second = bytes_per_second,
+        .update_rate = update_rate,
+        .factor = 1U,
+        .base_factor = 1U,
+        .decimation = 1U,
+        .traced = ctx->rate_limit.traced,
+    };
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_get_decimation(ums_context_t *ctx, uint16_t *factor)
+{
+    if (!factor)
+    {
+        return UMS_NULL_POINTER;
+    }
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+
+    const ums_rate_limit_t *limit = &ctx->rate_limit;
+    if (limit->bytes_per_second == 0)
+    {
+        *factor = 1U;
+        return UMS_SUCCESS;
+    }
+    // The factor is rebased on the next update after a layout change, report what that update applies.
+    const uint16_t base_factor = ums_rate_limit_factor(limit->bytes_per_second, limit->update_rate,
+                                                       ums_max_frame_size(ctx));
+    *factor = (limit->factor > base_factor) ? limit->factor : base_factor;
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_set_instrumentation(ums_context_t *ctx, const bool enable)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+
+    ums_platform_enter_critical();
+    ctx->instrumentation.enabled = false;
+    ctx->instrumentation.transfer_timed = false;
+    ums_cycle_stats_reset(&ctx->instrumentation.update);
+    ums_cycle_stats_reset(&ctx->instrumentation.create_sample);
+    ums_cycle_stats_reset(&ctx->instrumentation.transfer);
+    ctx->instrumentation.enabled = enable;
+    ums_platform_exit_critical();
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_get_instrumentation(ums_context_t *ctx, ums_instrumentation_t *instrumentation)
+{
+    if (!instrumentation)
+    {
+        return UMS_NULL_POINTER;
+    }
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    // The transfer statistics are written by ums_transfer_complete_callback().
+    ums_platform_enter_critical();
+    *instrumentation = ctx->instrumentation;
+    ums_platform_exit_critical();
+
+    return UMS_SUCCESS;
+}
+
+ums_err_t ums_ctx_queue_get_stats(ums_context_t *ctx, ums_queue_stats_t *stats)
+{
+    if (!stats)
+    {
+        return UMS_NULL_POINTER;
+    }
+    if (ctx->delivery != UMS_DELIVERY_QUEUE)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    *stats = ctx->frame_queue.stats;
+
+    return UMS_SUCCESS;
+}
+
+/**
+ * Registers a channel, shared by all ums_trace variants. The whole channel (scalar, block or struct) is one
+ * registry entry and one copy, channel->size bytes from src_ptr.
+ * src_ptr is what the copy plan reads, var_ptr itself or the result of an aggregator.
+ */
+static ums_err_t ums_register_channel(ums_context_t *ctx, const data_channel_t *channel, const void *src_ptr)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (!channel->var_ptr)
+    {
+        return UMS_INVALID_VARIABLE_REGISTRATION;
+    }
+    if (!channel->var_name_ptr)
+    {
+        return UMS_NULL_POINTER;
+    }
+    if (channel->size == 0)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+    if (ctx->channel_count == UMS_MAX_CHANNELS)
+    {
+        return UMS_RANGE_ERROR;
+    }
+    if (ctx->delivery == UMS_DELIVERY_SCOPE)
+    {
+        // The scope ring slots are sized for the frame at ums_scope_setup().
+        return UMS_INVALID_PARAMETER;
+    }
+    if (ums_channel_is_block(channel) && ctx->encoding != UMS_ENCODING_RAW)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+    // Same for the channel elements, the list is recompiled below.
+    if (ctx->delivery == UMS_DELIVERY_GATHER && ctx->gather_busy)
+    {
+        return UMS_BUFFER_FULL;
+    }
+    if (ums_copy_plan_append_group(&ctx->copy_plan, channel->group, src_ptr, channel->size) != UMS_SUCCESS)
+    {
+        return UMS_RANGE_ERROR;
+    }
+    if (!ums_channel_is_block(channel))
+    {
+        ums_delta_encoder_add_channel(&ctx->delta_encoder, channel->var_type);
+    }
+
+    ctx->registry[ctx->channel_count] = *channel;
+
+    ctx->channel_count++;
+    ctx->actual_frame_size += channel->size;
+
+    if (ctx->delivery == UMS_DELIVERY_GATHER)
+    {
+        ums_gather_compile(ctx);
+    }
+
+    return UMS_SUCCESS;
+}
+
+/**
+ * Registers a channel in the sample group for divider, opening a new group for a new divider.
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+static ums_err_t ums_register_divided(ums_context_t *ctx, void *var_ptr, char *var_name_ptr, const ums_datatype_t var_type,
+                                      const uint16_t divider, const void *src_ptr)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
+    if (divider == 0)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+    if (divider == 1U)
+    {
+        const data_channel_t channel = ums_scalar_channel(var_ptr, var_name_ptr, var_type, 0);
+        return ums_register_channel(ctx, &channel, src_ptr);
+    }
+    if (ctx->encoding != UMS_ENCODING_RAW || ctx->delivery == UMS_DELIVERY_GATHER)
+    {
+        // Group frames have their own layout, the delta/changed encoders and the gather list only know
+        // the full payload.
+        return UMS_INVALID_PARAMETER;
+    }
+
+    uint8_t group = 1U;
+    while (group < ctx->group_count && ctx->group_divider[group] != divider)
+    {
+        group++;
+    }
+    if (group == UMS_MAX_GROUPS)
+    {
+        return UMS_RANGE_ERROR;
+    }
+
+    const data_channel_t channel = ums_scalar_channel(var_ptr, var_name_ptr, var_type, group);
+    const ums_err_t err = ums_register_channel(ctx, &channel, src_ptr);
+    if (err != UMS_SUCCESS || group < ctx->group_count)
+    {
+        return err;
+    }
 
-static transmit_function s_transmit_function_ptr;
+    // First channel with this divider opens a new group, due on the next tick like group 0.
+    ctx->group_divider[group] = divider;
+    ctx->group_countdown[group] = 0;
+    ctx->group_count++;
 
-data_channel_t      registry[UMS_MAX_CHANNELS];
-uint8_t             channel_count       = 0;
-bool                g_ums_initialized   = false;
-uint16_t            g_actual_frame_size = sizeof(uint32_t);
-volatile bool       g_dma_busy          = false;
+    return UMS_SUCCESS;
+}
 
-/**
- * Creates a new sample with the current values of the traced variables.
- * Writes the sample packet to the write index and swaps the write index with the spare index.
- * @return ums_err_t error code. 1 = UMS_SUCCESS.
- */
-static ums_err_t ums_create_sample(void)
+ums_err_t ums_ctx_trace(ums_context_t *ctx, void *var_ptr, char *var_name_ptr, const ums_datatype_t var_type)
+{
+    const data_channel_t channel = ums_scalar_channel(var_ptr, var_name_ptr, var_type, 0);
+    return ums_register_channel(ctx, &channel, var_ptr);
+}
+
+ums_err_t ums_ctx_trace_link_stats(ums_context_t *ctx)
 {
-    if (channel_count == 0)
+    static char captured_name[] = "ums.captured";
+    static char dropped_name[] = "ums.dropped";
+    static char transmitted_name[] = "ums.transmitted";
+
+    if (ctx->initialized && ctx->channel_count + 3U > UMS_MAX_CHANNELS)
     {
         return UMS_RANGE_ERROR;
     }
+    // Adjacent in ums_link_stats_t, the copy plan merges them into one op.
+    ums_err_t err = ums_ctx_trace(ctx, &ctx->link_stats.captured, captured_name, UMS_UINT32);
+    if (err == UMS_SUCCESS)
+    {
+        err = ums_ctx_trace(ctx, &ctx->link_stats.dropped, dropped_name, UMS_UINT32);
+    }
+    if (err == UMS_SUCCESS)
+    {
+        err = ums_ctx_trace(ctx, &ctx->link_stats.transmitted, transmitted_name, UMS_UINT32);
+    }
+    return err;
+}
 
-    ums_triple_buffer[idx_write].timestamp = ums_platform_get_timestamp();
-    uint16_t offset = 0;
+ums_err_t ums_ctx_trace_instrumentation(ums_context_t *ctx)
+{
+    static char update_name[] = "ums.update_cycles";
+    static char create_name[] = "ums.create_cycles";
+    static char transfer_name[] = "ums.transfer_cycles";
 
-    for (uint8_t i = 0; i < channel_count; i++)
+    if (ctx->initialized && ctx->channel_count + 3U > UMS_MAX_CHANNELS)
     {
-        const uint8_t var_size = ums_datatype_size(registry[i].var_type);
-        memcpy(&ums_triple_buffer[idx_write].data[offset], registry[i].var_ptr, var_size);
-        offset += var_size;
+        return UMS_RANGE_ERROR;
     }
+    ums_err_t err = ums_ctx_trace(ctx, &ctx->instrumentation.update.last, update_name, UMS_UINT32);
+    if (err == UMS_SUCCESS)
+    {
+        err = ums_ctx_trace(ctx, &ctx->instrumentation.create_sample.last, create_name, UMS_UINT32);
+    }
+    if (err == UMS_SUCCESS)
+    {
+        err = ums_ctx_trace(ctx, &ctx->instrumentation.transfer.last, transfer_name, UMS_UINT32);
+    }
+    return err;
+}
 
-    ums_platform_enter_critical();
-    const uint8_t temp = idx_spare;
-    idx_spare = idx_write;
-    idx_write = temp;
-    ums_platform_exit_critical();
-
-    g_dma_busy = true;
-    s_transmit_function_ptr((void*)&ums_triple_buffer[idx_spare], g_actual_frame_size);
+ums_err_t ums_ctx_trace_block(ums_context_t *ctx, void *var_ptr, char *var_name_ptr, const ums_datatype_t var_type,
+                              const uint16_t count)
+{
+    const uint32_t size = (uint32_t)ums_datatype_size(var_type) * count;
+    if (size == 0)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+    if (size > UMS_MAX_PAYLOAD_SIZE)
+    {
+        return UMS_RANGE_ERROR;
+    }
 
-    return UMS_SUCCESS;
+    data_channel_t channel = ums_scalar_channel(var_ptr, var_name_ptr, var_type, 0);
+    channel.count = count;
+    channel.size = (uint16_t)size;
+    return ums_register_channel(ctx, &channel, var_ptr);
 }
 
-ums_err_t ums_setup(const transmit_function transmit_function_ptr)
+ums_err_t ums_ctx_trace_struct(ums_context_t *ctx, void *struct_ptr, char *var_name_ptr, const ums_field_t *fields,
+                               const uint8_t field_count, const uint16_t struct_size)
 {
-    if (!transmit_function_ptr)
+    if (!fields)
     {
         return UMS_NULL_POINTER;
     }
-    s_transmit_function_ptr = transmit_function_ptr;
-    g_ums_initialized = true;
+    if (field_count == 0 || struct_size == 0)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+    if (struct_size > UMS_MAX_PAYLOAD_SIZE)
+    {
+        return UMS_RANGE_ERROR;
+    }
+    for (uint8_t i = 0; i < field_count; i++)
+    {
+        const uint8_t field_size = ums_datatype_size(fields[i].type);
+        if (!fields[i].name)
+        {
+            return UMS_NULL_POINTER;
+        }
+        if (field_size == 0)
+        {
+            return UMS_INVALID_PARAMETER;
+        }
+        if ((uint32_t)fields[i].offset + field_size > struct_size)
+        {
+            return UMS_RANGE_ERROR;
+        }
+    }
 
-    return UMS_SUCCESS;
+    const data_channel_t channel = {
+        .var_ptr = struct_ptr,
+        .var_type = UMS_STRUCT,
+        .var_name_ptr = var_name_ptr,
+        .count = field_count,
+        .size = struct_size,
+        .fields = fields,
+    };
+    return ums_register_channel(ctx, &channel, struct_ptr);
 }
 
-ums_err_t ums_trace(void *var_ptr, char *var_name_ptr, const ums_datatype_t var_type)
+ums_err_t ums_ctx_trace_divided(ums_context_t *ctx, void *var_ptr, char *var_name_ptr, const ums_datatype_t var_type,
+                                const uint16_t divider)
+{
+    return ums_register_divided(ctx, var_ptr, var_name_ptr, var_type, divider, var_ptr);
+}
+
+ums_err_t ums_ctx_trace_aggregated(ums_context_t *ctx, void *var_ptr, char *var_name_ptr,
+                                   const ums_datatype_t var_type, const uint16_t divider, const ums_aggregate_t aggregate)
 {
-    if (!g_ums_initialized)
+    if (!ctx->initialized)
     {
         return UMS_NOT_INITIALIZED;
     }
@@ -81,85 +1504,450 @@ ums_err_t ums_trace(void *var_ptr, char *var_name_ptr, const ums_datatype_t var_
     {
         return UMS_INVALID_VARIABLE_REGISTRATION;
     }
-    if (!var_name_ptr)
+    if (ctx->aggregator_count == UMS_MAX_CHANNELS)
     {
-        return UMS_NULL_POINTER;
+        return UMS_RANGE_ERROR;
     }
-    if (ums_datatype_size(var_type) == 0)
+
+    ums_aggregator_t *agg = &ctx->aggregators[ctx->aggregator_count];
+    ums_err_t err = ums_aggregator_init(agg, var_ptr, var_type, aggregate);
+    if (err != UMS_SUCCESS)
     {
-        return UMS_INVALID_PARAMETER;
+        return err;
     }
-    if (channel_count == UMS_MAX_CHANNELS)
+    err = ums_register_divided(ctx, var_ptr, var_name_ptr, var_type, divider, agg->result);
+    if (err != UMS_SUCCESS)
     {
-        return UMS_RANGE_ERROR;
+        return err;
     }
 
-    registry[channel_count].var_ptr = var_ptr;
-    registry[channel_count].var_type = var_type;
-    registry[channel_count].var_name_ptr = var_name_ptr;
-
-    channel_count++;
-    g_actual_frame_size += ums_datatype_size(var_type);
+    agg->group = ctx->registry[ctx->channel_count - 1U].group;
+    ctx->aggregator_count++;
 
     return UMS_SUCCESS;
 }
 
-ums_err_t ums_update(void)
+/**
+ * Counts one update towards the next decimated capture, rebasing the factor when the layout changed since.
+ * @return true if this update captures.
+ */
+static bool ums_rate_limit_due(ums_context_t *ctx)
+{
+    ums_rate_limit_t *limit = &ctx->rate_limit;
+    const uint16_t frame_size = ums_max_frame_size(ctx);
+    if (frame_size != limit->frame_size)
+    {
+        const uint16_t base_factor = ums_rate_limit_factor(limit->bytes_per_second, limit->update_rate, frame_size);
+        limit->frame_size = frame_size;
+        limit->factor = (limit->factor > base_factor) ? limit->factor : base_factor;
+        limit->base_factor = base_factor;
+    }
+    if (++limit->countdown < limit->factor)
+    {
+        return false;
+    }
+    limit->countdown = 0;
+    limit->decimation = limit->ticks;
+    limit->ticks = 0;
+    return true;
+}
+
+/**
+ * Backs off by one when a decimated capture was dropped anyway, recovers after UMS_RATE_LIMIT_RECOVERY clean ones.
+ */
+static void ums_rate_limit_adapt(ums_context_t *ctx, const bool dropped)
+{
+    ums_rate_limit_t *limit = &ctx->rate_limit;
+    if (dropped)
+    {
+        limit->factor += (limit->factor < UINT16_MAX) ? 1U : 0U;
+        limit->clean_captures = 0;
+    }
+    else if (limit->factor > limit->base_factor && ++limit->clean_captures >= UMS_RATE_LIMIT_RECOVERY)
+    {
+        limit->factor--;
+        limit->clean_captures = 0;
+    }
+}
+
+/**
+ * Shared body of ums_update() and ums_capture(): ticks, trigger and packing of one sample.
+ * @param [in] kick true for ums_update(), which transmits right after, false for ums_capture().
+ * @return ums_err_t error code. 1 = UMS_SUCCESS.
+ */
+static ums_err_t ums_sample(ums_context_t *ctx, const bool kick)
 {
-    if (!g_ums_initialized)
+    if (!ctx->initialized)
     {
         return UMS_NOT_INITIALIZED;
     }
-    if (channel_count == 0)
+    if (ctx->channel_count == 0)
     {
         return UMS_RANGE_ERROR;
     }
-    if (g_dma_busy)
+    if (ctx->handshake_interval != 0)
     {
-        return UMS_BUFFER_FULL;
+        ums_requeue_handshake(ctx);
+    }
+    if (ctx->rate_limit.bytes_per_second != 0 && ctx->rate_limit.ticks < UINT16_MAX)
+    {
+        ctx->rate_limit.ticks++;
+    }
+    // Ticks advance even when the sample is dropped below, so group rates stay tied to the call rate and
+    // aggregates see every tick. The aggregate windows only close once a frame is packed.
+    if (ctx->group_count > 1U)
+    {
+        ctx->due_groups = ums_tick_groups(ctx);
+    }
+    if (ctx->aggregator_count > 0)
+    {
+        ums_tick_aggregators(ctx);
+    }
+    // Gated samples are never packed, so the encoder reference stays the last transmitted frame.
+    if (ctx->trigger.op_count > 0 && !ums_apply_trigger(ctx))
+    {
+        return UMS_SUCCESS;
+    }
+    if (ctx->due_groups == 0)
+    {
+        return UMS_SUCCESS;
+    }
+    if (ctx->rate_limit.bytes_per_second != 0 && !ums_rate_limit_due(ctx))
+    {
+        return UMS_SUCCESS;
+    }
+    ctx->link_stats.captured++;
+    const uint32_t dropped = ctx->link_stats.dropped;
+
+    ums_err_t err;
+    // A newer frame replaces an unsent one (latest value wins), except when that one is the reference
+    // of the next delta.
+    if (ctx->delivery == UMS_DELIVERY_TRIPLE_BUFFER && ctx->encoding != UMS_ENCODING_RAW
+        && ums_triple_buffer_pending(&ctx->triple_buffer))
+    {
+        err = UMS_BUFFER_FULL;
+    }
+    // The gather list on the wire includes the timestamp, it may not change until the transfer completed.
+    else if (ctx->delivery == UMS_DELIVERY_GATHER && ctx->gather_busy)
+    {
+        err = UMS_BUFFER_FULL;
+    }
+    else if (ctx->instrumentation.enabled)
+    {
+        const uint32_t start = ums_platform_get_cycles();
+        err = ums_create_sample(ctx, kick);
+        ums_cycle_stats_record(&ctx->instrumentation.create_sample, ums_platform_get_cycles() - start);
+    }
+    else
+    {
+        err = ums_create_sample(ctx, kick);
+    }
+
+    if (err == UMS_BUFFER_FULL)
+    {
+        ctx->link_stats.dropped++;
+    }
+    if (ctx->rate_limit.bytes_per_second != 0)
+    {
+        // The scope overwrites its history by design, that says nothing about the link.
+        ums_rate_limit_adapt(ctx, ctx->delivery != UMS_DELIVERY_SCOPE && ctx->link_stats.dropped != dropped);
     }
 
-    if (ums_create_sample() != UMS_SUCCESS)
+    if (err == UMS_BUFFER_FULL)
+    {
+        return err;
+    }
+    if (err != UMS_SUCCESS)
     {
         return UMS_SAMPLING_ERROR;
     }
     return UMS_SUCCESS;
 }
 
-void ums_transfer_complete_callback(void)
+ums_err_t ums_ctx_capture(ums_context_t *ctx)
 {
-    const uint8_t temp = idx_spare;
-    idx_spare = idx_read;
-    idx_read = temp;
-    g_dma_busy = false;
+    return ums_sample(ctx, false);
 }
 
-ums_err_t ums_destroy(void)
+ums_err_t ums_ctx_update(ums_context_t *ctx)
 {
-    if (!g_ums_initialized)
+    // Only ticks that packed a sample are timed, so the statistics are not diluted by skipped ticks.
+    const uint32_t captured = ctx->link_stats.captured;
+    const uint32_t start = ctx->instrumentation.enabled ? ums_platform_get_cycles() : 0U;
+
+    const ums_err_t err = ums_sample(ctx, true);
+    if (ctx->delivery == UMS_DELIVERY_BATCH)
     {
-        return UMS_NOT_INITIALIZED;
+        ums_expire_batch(ctx);
+    }
+    if (err == UMS_SUCCESS)
+    {
+        ums_kick(ctx);
+    }
+
+    if (ctx->instrumentation.enabled && ctx->link_stats.captured != captured)
+    {
+        ums_cycle_stats_record(&ctx->instrumentation.update, ums_platform_get_cycles() - start);
+    }
+    return err;
+}
+
+void ums_ctx_transfer_complete_callback(ums_context_t *ctx)
+{
+    if (ctx->instrumentation.transfer_timed)
+    {
+        ctx->instrumentation.transfer_timed = false;
+        ums_cycle_stats_record(&ctx->instrumentation.transfer,
+                               ums_platform_get_cycles() - ctx->instrumentation.transfer_start);
+    }
+    // The handshake reserved the link like a sample transfer, the release below also ends it.
+    if (ctx->handshake_state == UMS_HANDSHAKE_BUSY)
+    {
+        ctx->handshake_state = UMS_HANDSHAKE_IDLE;
+    }
+    else
+    {
+        ctx->link_stats.transmitted += (ctx->delivery == UMS_DELIVERY_BATCH) ? ctx->batch.tx_frame_count : 1U;
+
+        if (ctx->handshake_state == UMS_HANDSHAKE_PENDING && ctx->delivery != UMS_DELIVERY_SCOPE)
+        {
+            // Back-to-back frames would starve it otherwise. The link stays reserved for the handshake, the frame
+            // that just completed is released together with it.
+            ctx->handshake_state = UMS_HANDSHAKE_BUSY;
+            ums_start_transfer(ctx, (void*)ctx->handshake, ctx->handshake_length);
+            return;
+        }
+    }
+
+    if (ctx->delivery == UMS_DELIVERY_QUEUE)
+    {
+        uint16_t length = 0;
+        sample_packet_t *next = ums_frame_queue_complete(&ctx->frame_queue, &length);
+        if (next)
+        {
+            ums_start_transfer(ctx, (void*)next, length);
+        }
+        return;
+    }
+    if (ctx->delivery == UMS_DELIVERY_BATCH)
+    {
+        uint16_t length = 0;
+        uint8_t *data = ums_batch_complete(&ctx->batch, &length);
+        if (data)
+        {
+            ums_start_transfer(ctx, (void*)data, length);
+        }
+        return;
+    }
+    if (ctx->delivery == UMS_DELIVERY_SCOPE)
+    {
+        uint16_t length = 0;
+        uint8_t *frame = ums_scope_ring_next(&ctx->scope, &length);
+        if (frame)
+        {
+            ums_start_transfer(ctx, (void*)frame, length);
+        }
+        return;
     }
 
-    for (uint8_t i = 0; i < channel_count; i++)
+    if (ctx->delivery == UMS_DELIVERY_GATHER)
     {
-        registry[i].var_ptr = nullptr;
-        registry[i].var_name_ptr = nullptr;
-        registry[i].var_type = 0;
+        ctx->gather_busy = false;
+        ums_kick(ctx);
+        return;
     }
 
-    g_dma_busy = false;
-    channel_count = 0;
-    g_ums_initialized = false;
-    g_actual_frame_size = sizeof(uint32_t);
+    // Back-to-back transfers: the freshest frame published while the link was busy goes out right away.
+    ums_triple_buffer_complete(&ctx->triple_buffer);
+    ums_kick(ctx);
+}
+
+ums_err_t ums_ctx_destroy(ums_context_t *ctx)
+{
+    if (!ctx->initialized)
+    {
+        return UMS_NOT_INITIALIZED;
+    }
 
-    idx_write = 0;
-    idx_read = 1;
-    idx_spare = 2;
+    ums_context_reset(ctx);
 
     return UMS_SUCCESS;
 }
 
+ums_err_t ums_setup(const transmit_function transmit_function_ptr)
+{
+    return ums_ctx_setup(&s_default_context, transmit_function_ptr);
+}
+
+ums_err_t ums_queue_setup(sample_packet_t *slots, const uint8_t slot_count, const ums_overflow_policy_t policy)
+{
+    return ums_ctx_queue_setup(&s_default_context, slots, slot_count, policy);
+}
+
+ums_err_t ums_batch_setup(uint8_t *buffer, const uint16_t buffer_size, const uint8_t frames_per_batch,
+                          const uint32_t timeout)
+{
+    return ums_ctx_batch_setup(&s_default_context, buffer, buffer_size, frames_per_batch, timeout);
+}
+
+ums_err_t ums_scope_setup(uint8_t *buffer, const uint32_t buffer_size, const uint32_t post_trigger)
+{
+    return ums_ctx_scope_setup(&s_default_context, buffer, buffer_size, post_trigger);
+}
+
+ums_err_t ums_scope_trigger(void)
+{
+    return ums_ctx_scope_trigger(&s_default_context);
+}
+
+ums_err_t ums_scope_arm(void)
+{
+    return ums_ctx_scope_arm(&s_default_context);
+}
+
+ums_scope_state_t ums_scope_get_state(void)
+{
+    return ums_ctx_scope_get_state(&s_default_context);
+}
+
+ums_err_t ums_gather_setup(const gather_transmit_function gather_function_ptr)
+{
+    return ums_ctx_gather_setup(&s_default_context, gather_function_ptr);
+}
+
+ums_err_t ums_trigger_setup(const ums_trigger_condition_t *conditions, const uint8_t condition_count,
+                            const uint16_t hold_off)
+{
+    return ums_ctx_trigger_setup(&s_default_context, conditions, condition_count, hold_off);
+}
+
+ums_err_t ums_set_encoding(const ums_encoding_t encoding, const uint16_t keyframe_interval)
+{
+    return ums_ctx_set_encoding(&s_default_context, encoding, keyframe_interval);
+}
+
+ums_err_t ums_set_framing(const ums_framing_t framing)
+{
+    return ums_ctx_set_framing(&s_default_context, framing);
+}
+
+ums_err_t ums_flush(void)
+{
+    return ums_ctx_flush(&s_default_context);
+}
+
+ums_err_t ums_send_handshake(void)
+{
+    return ums_ctx_send_handshake(&s_default_context);
+}
+
+ums_err_t ums_set_resync(const uint16_t marker_interval, const uint32_t handshake_interval)
+{
+    return ums_ctx_set_resync(&s_default_context, marker_interval, handshake_interval);
+}
+
+ums_err_t ums_set_sequence(const uint8_t size)
+{
+    return ums_ctx_set_sequence(&s_default_context, size);
+}
+
+ums_err_t ums_set_crc(const ums_crc_t crc)
+{
+    return ums_ctx_set_crc(&s_default_context, crc);
+}
+
+ums_err_t ums_get_link_stats(ums_link_stats_t *stats)
+{
+    return ums_ctx_get_link_stats(&s_default_context, stats);
+}
+
+ums_err_t ums_trace_link_stats(void)
+{
+    return ums_ctx_trace_link_stats(&s_default_context);
+}
+
+ums_err_t ums_link_budget(const uint32_t bytes_per_second, uint32_t *max_frame_rate)
+{
+    return ums_ctx_link_budget(&s_default_context, bytes_per_second, max_frame_rate);
+}
+
+ums_err_t ums_set_rate_limit(const uint32_t bytes_per_second, const uint32_t update_rate)
+{
+    return ums_ctx_set_rate_limit(&s_default_context, bytes_per_second, update_rate);
+}
+
+ums_err_t ums_get_decimation(uint16_t *factor)
+{
+    return ums_ctx_get_decimation(&s_default_context, factor);
+}
+
+ums_err_t ums_set_instrumentation(const bool enable)
+{
+    return ums_ctx_set_instrumentation(&s_default_context, enable);
+}
+
+ums_err_t ums_get_instrumentation(ums_instrumentation_t *instrumentation)
+{
+    return ums_ctx_get_instrumentation(&s_default_context, instrumentation);
+}
+
+ums_err_t ums_trace_instrumentation(void)
+{
+    return ums_ctx_trace_instrumentation(&s_default_context);
+}
+
+ums_err_t ums_queue_get_stats(ums_queue_stats_t *stats)
+{
+    return ums_ctx_queue_get_stats(&s_default_context, stats);
+}
+
+ums_err_t ums_trace(void *var_ptr, char *var_name_ptr, const ums_datatype_t var_type)
+{
+    return ums_ctx_trace(&s_default_context, var_ptr, var_name_ptr, var_type);
+}
+
+ums_err_t ums_trace_block(void *var_ptr, char *var_name_ptr, const ums_datatype_t var_type, const uint16_t count)
+{
+    return ums_ctx_trace_block(&s_default_context, var_ptr, var_name_ptr, var_type, count);
+}
+
+ums_err_t ums_trace_struct(void *struct_ptr, char *var_name_ptr, const ums_field_t *fields, const uint8_t field_count,
+                           const uint16_t struct_size)
+{
+    return ums_ctx_trace_struct(&s_default_context, struct_ptr, var_name_ptr, fields, field_count, struct_size);
+}
+
+ums_err_t ums_trace_divided(void *var_ptr, char *var_name_ptr, const ums_datatype_t var_type, const uint16_t divider)
+{
+    return ums_ctx_trace_divided(&s_default_context, var_ptr, var_name_ptr, var_type, divider);
+}
+
+ums_err_t ums_trace_aggregated(void *var_ptr, char *var_name_ptr, const ums_datatype_t var_type,
+                               const uint16_t divider, const ums_aggregate_t aggregate)
+{
+    return ums_ctx_trace_aggregated(&s_default_context, var_ptr, var_name_ptr, var_type, divider, aggregate);
+}
+
+ums_err_t ums_capture(void)
+{
+    return ums_ctx_capture(&s_default_context);
+}
+
+ums_err_t ums_update(void)
+{
+    return ums_ctx_update(&s_default_context);
+}
+
+void ums_transfer_complete_callback(void)
+{
+    ums_ctx_transfer_complete_callback(&s_default_context);
+}
+
+ums_err_t ums_destroy(void)
+{
+    return ums_ctx_destroy(&s_default_context);
+}
+
 __attribute__((weak)) void ums_platform_enter_critical(void)
 {
     //
@@ -173,4 +1961,30 @@ __attribute__((weak)) void ums_platform_exit_critical(void)
 __attribute__((weak)) uint32_t ums_platform_get_timestamp(void)
 {
     return 0U;
+}
+
+__attribute__((weak)) uint32_t ums_platform_get_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+    // DWT->CYCCNT
+    return *(volatile const uint32_t*)0xE0001004U;
+#elif defined(__linux__)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec);
+#else
+    return 0U;
+#endif
+}
+
+__attribute__((weak)) bool ums_platform_crc(const ums_crc_t crc, const uint8_t *data, const uint16_t length,
+                                            uint32_t *result)
+{
+    (void)crc;
+    (void)data;
+    (void)length;
+    (void)result;
+    return false;
 }
\ No newline at end of file
@@ -0,0 +1,67 @@
+//
+//
+//
+
+#include "ums/crc.h"
+#include "ums/ums_core.h"
+
+#include "ums_crc_tables.h"
+
+uint8_t ums_crc_size(const ums_crc_t crc)
+{
+    switch (crc)
+    {
+    case UMS_CRC_16: return 2U;
+    case UMS_CRC_32: return 4U;
+    default:         return 0U;
+    }
+}
+
+// Assembled byte by byte so the slice-by-4 tables index the same bytes on any target, compilers fold it into a
+// single load where the CPU is little-endian
+static inline uint32_t ums_crc_load_le32(const uint8_t *data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+uint16_t ums_crc16(const uint8_t *data, uint32_t length)
+{
+    uint32_t crc = 0xFFFFU;
+    for (; length >= 4U; data += 4U, length -= 4U)
+    {
+        const uint32_t word = ums_crc_load_le32(data) ^ crc;
+        crc = ums_crc16_table[3][word & 0xFFU] ^ ums_crc16_table[2][(word >> 8) & 0xFFU]
+              ^ ums_crc16_table[1][(word >> 16) & 0xFFU] ^ ums_crc16_table[0][word >> 24];
+    }
+    for (; length > 0; data++, length--)
+    {
+        crc = ums_crc16_table[0][(crc ^ *data) & 0xFFU] ^ (crc >> 8);
+    }
+    return (uint16_t)crc;
+}
+
+uint32_t ums_crc32(const uint8_t *data, uint32_t length)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+    for (; length >= 4U; data += 4U, length -= 4U)
+    {
+        const uint32_t word = ums_crc_load_le32(data) ^ crc;
+        crc = ums_crc32_table[3][word & 0xFFU] ^ ums_crc32_table[2][(word >> 8) & 0xFFU]
+              ^ ums_crc32_table[1][(word >> 16) & 0xFFU] ^ ums_crc32_table[0][word >> 24];
+    }
+    for (; length > 0; data++, length--)
+    {
+        crc = ums_crc32_table[0][(crc ^ *data) & 0xFFU] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t ums_crc_compute(const ums_crc_t crc, const uint8_t *data, const uint16_t length)
+{
+    uint32_t result;
+    if (ums_platform_crc(crc, data, length, &result))
+    {
+        return result;
+    }
+    return (crc == UMS_CRC_16) ? ums_crc16(data, length) : ums_crc32(data, length);
+}
@@ -0,0 +1,299 @@
+//
+//
+//
+
+#ifndef UMS_CRC_TABLES_H
+#define UMS_CRC_TABLES_H
+
+#include "stdint.h"
+
+/*
+ * Slice-by-4 tables of the reflected polynomials, generated: table[0][n] is the CRC of the byte n from a zero
+ * register, table[k][n] = (table[k - 1][n] >> 8) ^ table[0][table[k - 1][n] & 0xFF] the same byte followed by
+ * k zero bytes. Kept const so they stay in flash.
+ */
+#define UMS_CRC_SLICES  4U
+
+/** CRC-16/MODBUS, polynomial 0x8005 reflected = 0xA001. */
+static const uint16_t ums_crc16_table[UMS_CRC_SLICES][256] =
+{
+    {
+        0x0000U, 0xC0C1U, 0xC181U, 0x0140U, 0xC301U, 0x03C0U, 0x0280U, 0xC241U,
+        0xC601U, 0x06C0U, 0x0780U, 0xC741U, 0x0500U, 0xC5C1U, 0xC481U, 0x0440U,
+        0xCC01U, 0x0CC0U, 0x0D80U, 0xCD41U, 0x0F00U, 0xCFC1U, 0xCE81U, 0x0E40U,
+        0x0A00U, 0xCAC1U, 0xCB81U, 0x0B40U, 0xC901U, 0x09C0U, 0x0880U, 0xC841U,
+        0xD801U, 0x18C0U, 0x1980U, 0xD941U, 0x1B00U, 0xDBC1U, 0xDA81U, 0x1A40U,
+        0x1E00U, 0xDEC1U, 0xDF81U, 0x1F40U, 0xDD01U, 0x1DC0U, 0x1C80U, 0xDC41U,
+        0x1400U, 0xD4C1U, 0xD581U, 0x1540U, 0xD701U, 0x17C0U, 0x1680U, 0xD641U,
+        0xD201U, 0x12C0U, 0x1380U, 0xD341U, 0x1100U, 0xD1C1U, 0xD081U, 0x1040U,
+        0xF001U, 0x30C0U, 0x3180U, 0xF141U, 0x3300U, 0xF3C1U, 0xF281U, 0x3240U,
+        0x3600U, 0xF6C1U, 0xF781U, 0x3740U, 0xF501U, 0x35C0U, 0x3480U, 0xF441U,
+        0x3C00U, 0xFCC1U, 0xFD81U, 0x3D40U, 0xFF01U, 0x3FC0U, 0x3E80U, 0xFE41U,
+        0xFA01U, 0x3AC0U, 0x3B80U, 0xFB41U, 0x3900U, 0xF9C1U, 0xF881U, 0x3840U,
+        0x2800U, 0xE8C1U, 0xE981U, 0x2940U, 0xEB01U, 0x2BC0U, 0x2A80U, 0xEA41U,
+        0xEE01U, 0x2EC0U, 0x2F80U, 0xEF41U, 0x2D00U, 0xEDC1U, 0xEC81U, 0x2C40U,
+        0xE401U, 0x24C0U, 0x2580U, 0xE541U, 0x2700U, 0xE7C1U, 0xE681U, 0x2640U,
+        0x2200U, 0xE2C1U, 0xE381U, 0x2340U, 0xE101U, 0x21C0U, 0x2080U, 0xE041U,
+        0xA001U, 0x60C0U, 0x6180U, 0xA141U, 0x6300U, 0xA3C1U, 0xA281U, 0x6240U,
+        0x6600U, 0xA6C1U, 0xA781U, 0x6740U, 0xA501U, 0x65C0U, 0x6480U, 0xA441U,
+        0x6C00U, 0xACC1U, 0xAD81U, 0x6D40U, 0xAF01U, 0x6FC0U, 0x6E80U, 0xAE41U,
+        0xAA01U, 0x6AC0U, 0x6B80U, 0xAB41U, 0x6900U, 0xA9C1U, 0xA881U, 0x6840U,
+        0x7800U, 0xB8C1U, 0xB981U, 0x7940U, 0xBB01U, 0x7BC0U, 0x7A80U, 0xBA41U,
+        0xBE01U, 0x7EC0U, 0x7F80U, 0xBF41U, 0x7D00U, 0xBDC1U, 0xBC81U, 0x7C40U,
+        0xB401U, 0x74C0U, 0x7580U, 0xB541U, 0x7700U, 0xB7C1U, 0xB681U, 0x7640U,
+        0x7200U, 0xB2C1U, 0xB381U, 0x7340U, 0xB101U, 0x71C0U, 0x7080U, 0xB041U,
+        0x5000U, 0x90C1U, 0x9181U, 0x5140U, 0x9301U, 0x53C0U, 0x5280U, 0x9241U,
+        0x9601U, 0x56C0U, 0x5780U, 0x9741U, 0x5500U, 0x95C1U, 0x9481U, 0x5440U,
+        0x9C01U, 0x5CC0U, 0x5D80U, 0x9D41U, 0x5F00U, 0x9FC1U, 0x9E81U, 0x5E40U,
+        0x5A00U, 0x9AC1U, 0x9B81U, 0x5B40U, 0x9901U, 0x59C0U, 0x5880U, 0x9841U,
+        0x8801U, 0x48C0U, 0x4980U, 0x8941U, 0x4B00U, 0x8BC1U, 0x8A81U, 0x4A40U,
+        0x4E00U, 0x8EC1U, 0x8F81U, 0x4F40U, 0x8D01U, 0x4DC0U, 0x4C80U, 0x8C41U,
+        0x4400U, 0x84C1U, 0x8581U, 0x4540U, 0x8701U, 0x47C0U, 0x4680U, 0x8641U,
+        0x8201U, 0x42C0U, 0x4380U, 0x8341U, 0x4100U, 0x81C1U, 0x8081U, 0x4040U,
+    },
+    {
+        0x0000U, 0x9001U, 0x6001U, 0xF000U, 0xC002U, 0x5003U, 0xA003U, 0x3002U,
+        0xC007U, 0x5006U, 0xA006U, 0x3007U, 0x0005U, 0x9004U, 0x6004U, 0xF005U,
+        0xC00DU, 0x500CU, 0xA00CU, 0x300DU, 0x000FU, 0x900EU, 0x600EU, 0xF00FU,
+        0x000AU, 0x900BU, 0x600BU, 0xF00AU, 0xC008U, 0x5009U, 0xA009U, 0x3008U,
+        0xC019U, 0x5018U, 0xA018U, 0x3019U, 0x001BU, 0x901AU, 0x601AU, 0xF01BU,
+        0x001EU, 0x901FU, 0x601FU, 0xF01EU, 0xC01CU, 0x501DU, 0xA01DU, 0x301CU,
+        0x0014U, 0x9015U, 0x6015U, 0xF014U, 0xC016U, 0x5017U, 0xA017U, 0x3016U,
+        0xC013U, 0x5012U, 0xA012U, 0x3013U, 0x0011U, 0x9010U, 0x6010U, 0xF011U,
+        0xC031U, 0x5030U, 0xA030U, 0x3031U, 0x0033U, 0x9032U, 0x6032U, 0xF033U,
+        0x0036U, 0x9037U, 0x6037U, 0xF036U, 0xC034U, 0x5035U, 0xA035U, 0x3034U,
+        0x003CU, 0x903DU, 0x603DU, 0xF03CU, 0xC03EU, 0x503FU, 0xA03FU, 0x303EU,
+        0xC03BU, 0x503AU, 0xA03AU, 0x303BU, 0x0039U, 0x9038U, 0x6038U, 0xF039U,
+        0x0028U, 0x9029U, 0x6029U, 0xF028U, 0xC02AU, 0x502BU, 0xA02BU, 0x302AU,
+        0xC02FU, 0x502EU, 0xA02EU, 0x302FU, 0x002DU, 0x902CU, 0x602CU, 0xF02DU,
+        0xC025U, 0x5024U, 0xA024U, 0x3025U, 0x0027U, 0x9026U, 0x6026U, 0xF027U,
+        0x0022U, 0x9023U, 0x6023U, 0xF022U, 0xC020U, 0x5021U, 0xA021U, 0x3020U,
+        0xC061U, 0x5060U, 0xA060U, 0x3061U, 0x0063U, 0x9062U, 0x6062U, 0xF063U,
+        0x0066U, 0x9067U, 0x6067U, 0xF066U, 0xC064U, 0x5065U, 0xA065U, 0x3064U,
+        0x006CU, 0x906DU, 0x606DU, 0xF06CU, 0xC06EU, 0x506FU, 0xA06FU, 0x306EU,
+        0xC06BU, 0x506AU, 0xA06AU, 0x306BU, 0x0069U, 0x9068U, 0x6068U, 0xF069U,
+        0x0078U, 0x9079U, 0x6079U, 0xF078U, 0xC07AU, 0x507BU, 0xA07BU, 0x307AU,
+        0xC07FU, 0x507EU, 0xA07EU, 0x307FU, 0x007DU, 0x907CU, 0x607CU, 0xF07DU,
+        0xC075U, 0x5074U, 0xA074U, 0x3075U, 0x0077U, 0x9076U, 0x6076U, 0xF077U,
+        0x0072U, 0x9073U, 0x6073U, 0xF072U, 0xC070U, 0x5071U, 0xA071U, 0x3070U,
+        0x0050U, 0x9051U, 0x6051U, 0xF050U, 0xC052U, 0x5053U, 0xA053U, 0x3052U,
+        0xC057U, 0x5056U, 0xA056U, 0x3057U, 0x0055U, 0x9054U, 0x6054U, 0xF055U,
+        0xC05DU, 0x505CU, 0xA05CU, 0x305DU, 0x005FU, 0x905EU, 0x605EU, 0xF05FU,
+        0x005AU, 0x905BU, 0x605BU, 0xF05AU, 0xC058U, 0x5059U, 0xA059U, 0x3058U,
+        0xC049U, 0x5048U, 0xA048U, 0x3049U, 0x004BU, 0x904AU, 0x604AU, 0xF04BU,
+        0x004EU, 0x904FU, 0x604FU, 0xF04EU, 0xC04CU, 0x504DU, 0xA04DU, 0x304CU,
+        0x0044U, 0x9045U, 0x6045U, 0xF044U, 0xC046U, 0x5047U, 0xA047U, 0x3046U,
+        0xC043U, 0x5042U, 0xA042U, 0x3043U, 0x0041U, 0x9040U, 0x6040U, 0xF041U,
+    },
+    {
+        0x0000U, 0xC051U, 0xC0A1U, 0x00F0U, 0xC141U, 0x0110U, 0x01E0U, 0xC1B1U,
+        0xC281U, 0x02D0U, 0x0220U, 0xC271U, 0x03C0U, 0xC391U, 0xC361U, 0x0330U,
+        0xC501U, 0x0550U, 0x05A0U, 0xC5F1U, 0x0440U, 0xC411U, 0xC4E1U, 0x04B0U,
+        0x0780U, 0xC7D1U, 0xC721U, 0x0770U, 0xC6C1U, 0x0690U, 0x0660U, 0xC631U,
+        0xCA01U, 0x0A50U, 0x0AA0U, 0xCAF1U, 0x0B40U, 0xCB11U, 0xCBE1U, 0x0BB0U,
+        0x0880U, 0xC8D1U, 0xC821U, 0x0870U, 0xC9C1U, 0x0990U, 0x0960U, 0xC931U,
+        0x0F00U, 0xCF51U, 0xCFA1U, 0x0FF0U, 0xCE41U, 0x0E10U, 0x0EE0U, 0xCEB1U,
+        0xCD81U, 0x0DD0U, 0x0D20U, 0xCD71U, 0x0CC0U, 0xCC91U, 0xCC61U, 0x0C30U,
+        0xD401U, 0x1450U, 0x14A0U, 0xD4F1U, 0x1540U, 0xD511U, 0xD5E1U, 0x15B0U,
+        0x1680U, 0xD6D1U, 0xD621U, 0x1670U, 0xD7C1U, 0x1790U, 0x1760U, 0xD731U,
+        0x1100U, 0xD151U, 0xD1A1U, 0x11F0U, 0xD041U, 0x1010U, 0x10E0U, 0xD0B1U,
+        0xD381U, 0x13D0U, 0x1320U, 0xD371U, 0x12C0U, 0xD291U, 0xD261U, 0x1230U,
+        0x1E00U, 0xDE51U, 0xDEA1U, 0x1EF0U, 0xDF41U, 0x1F10U, 0x1FE0U, 0xDFB1U,
+        0xDC81U, 0x1CD0U, 0x1C20U, 0xDC71U, 0x1DC0U, 0xDD91U, 0xDD61U, 0x1D30U,
+        0xDB01U, 0x1B50U, 0x1BA0U, 0xDBF1U, 0x1A40U, 0xDA11U, 0xDAE1U, 0x1AB0U,
+        0x1980U, 0xD9D1U, 0xD921U, 0x1970U, 0xD8C1U, 0x1890U, 0x1860U, 0xD831U,
+        0xE801U, 0x2850U, 0x28A0U, 0xE8F1U, 0x2940U, 0xE911U, 0xE9E1U, 0x29B0U,
+        0x2A80U, 0xEAD1U, 0xEA21U, 0x2A70U, 0xEBC1U, 0x2B90U, 0x2B60U, 0xEB31U,
+        0x2D00U, 0xED51U, 0xEDA1U, 0x2DF0U, 0xEC41U, 0x2C10U, 0x2CE0U, 0xECB1U,
+        0xEF81U, 0x2FD0U, 0x2F20U, 0xEF71U, 0x2EC0U, 0xEE91U, 0xEE61U, 0x2E30U,
+        0x2200U, 0xE251U, 0xE2A1U, 0x22F0U, 0xE341U, 0x2310U, 0x23E0U, 0xE3B1U,
+        0xE081U, 0x20D0U, 0x2020U, 0xE071U, 0x21C0U, 0xE191U, 0xE161U, 0x2130U,
+        0xE701U, 0x2750U, 0x27A0U, 0xE7F1U, 0x2640U, 0xE611U, 0xE6E1U, 0x26B0U,
+        0x2580U, 0xE5D1U, 0xE521U, 0x2570U, 0xE4C1U, 0x2490U, 0x2460U, 0xE431U,
+        0x3C00U, 0xFC51U, 0xFCA1U, 0x3CF0U, 0xFD41U, 0x3D10U, 0x3DE0U, 0xFDB1U,
+        0xFE81U, 0x3ED0U, 0x3E20U, 0xFE71U, 0x3FC0U, 0xFF91U, 0xFF61U, 0x3F30U,
+        0xF901U, 0x3950U, 0x39A0U, 0xF9F1U, 0x3840U, 0xF811U, 0xF8E1U, 0x38B0U,
+        0x3B80U, 0xFBD1U, 0xFB21U, 0x3B70U, 0xFAC1U, 0x3A90U, 0x3A60U, 0xFA31U,
+        0xF601U, 0x3650U, 0x36A0U, 0xF6F1U, 0x3740U, 0xF711U, 0xF7E1U, 0x37B0U,
+        0x3480U, 0xF4D1U, 0xF421U, 0x3470U, 0xF5C1U, 0x3590U, 0x3560U, 0xF531U,
+        0x3300U, 0xF351U, 0xF3A1U, 0x33F0U, 0xF241U, 0x3210U, 0x32E0U, 0xF2B1U,
+        0xF181U, 0x31D0U, 0x3120U, 0xF171U, 0x30C0U, 0xF091U, 0xF061U, 0x3030U,
+    },
+    {
+        0x0000U, 0xFC01U, 0xB801U, 0x4400U, 0x3001U, 0xCC00U, 0x8800U, 0x7401U,
+        0x6002U, 0x9C03U, 0xD803U, 0x2402U, 0x5003U, 0xAC02U, 0xE802U, 0x1403U,
+        0xC004U, 0x3C05U, 0x7805U, 0x8404U, 0xF005U, 0x0C04U, 0x4804U, 0xB405U,
+        0xA006U, 0x5C07U, 0x1807U, 0xE406U, 0x9007U, 0x6C06U, 0x2806U, 0xD407U,
+        0xC00BU, 0x3C0AU, 0x780AU, 0x840BU, 0xF00AU, 0x0C0BU, 0x480BU, 0xB40AU,
+        0xA009U, 0x5C08U, 0x1808U, 0xE409U, 0x9008U, 0x6C09U, 0x2809U, 0xD408U,
+        0x000FU, 0xFC0EU, 0xB80EU, 0x440FU, 0x300EU, 0xCC0FU, 0x880FU, 0x740EU,
+        0x600DU, 0x9C0CU, 0xD80CU, 0x240DU, 0x500CU, 0xAC0DU, 0xE80DU, 0x140CU,
+        0xC015U, 0x3C14U, 0x7814U, 0x8415U, 0xF014U, 0x0C15U, 0x4815U, 0xB414U,
+        0xA017U, 0x5C16U, 0x1816U, 0xE417U, 0x9016U, 0x6C17U, 0x2817U, 0xD416U,
+        0x0011U, 0xFC10U, 0xB810U, 0x4411U, 0x3010U, 0xCC11U, 0x8811U, 0x7410U,
+        0x6013U, 0x9C12U, 0xD812U, 0x2413U, 0x5012U, 0xAC13U, 0xE813U, 0x1412U,
+        0x001EU, 0xFC1FU, 0xB81FU, 0x441EU, 0x301FU, 0xCC1EU, 0x881EU, 0x741FU,
+        0x601CU, 0x9C1DU, 0xD81DU, 0x241CU, 0x501DU, 0xAC1CU, 0xE81CU, 0x141DU,
+        0xC01AU, 0x3C1BU, 0x781BU, 0x841AU, 0xF01BU, 0x0C1AU, 0x481AU, 0xB41BU,
+        0xA018U, 0x5C19U, 0x1819U, 0xE418U, 0x9019U, 0x6C18U, 0x2818U, 0xD419U,
+        0xC029U, 0x3C28U, 0x7828U, 0x8429U, 0xF028U, 0x0C29U, 0x4829U, 0xB428U,
+        0xA02BU, 0x5C2AU, 0x182AU, 0xE42BU, 0x902AU, 0x6C2BU, 0x282BU, 0xD42AU,
+        0x002DU, 0xFC2CU, 0xB82CU, 0x442DU, 0x302CU, 0xCC2DU, 0x882DU, 0x742CU,
+        0x602FU, 0x9C2EU, 0xD82EU, 0x242FU, 0x502EU, 0xAC2FU, 0xE82FU, 0x142EU,
+        0x0022U, 0xFC23U, 0xB823U, 0x4422U, 0x3023U, 0xCC22U, 0x8822U, 0x7423U,
+        0x6020U, 0x9C21U, 0xD821U, 0x2420U, 0x5021U, 0xAC20U, 0xE820U, 0x1421U,
+        0xC026U, 0x3C27U, 0x7827U, 0x8426U, 0xF027U, 0x0C26U, 0x4826U, 0xB427U,
+        0xA024U, 0x5C25U, 0x1825U, 0xE424U, 0x9025U, 0x6C24U, 0x2824U, 0xD425U,
+        0x003CU, 0xFC3DU, 0xB83DU, 0x443CU, 0x303DU, 0xCC3CU, 0x883CU, 0x743DU,
+        0x603EU, 0x9C3FU, 0xD83FU, 0x243EU, 0x503FU, 0xAC3EU, 0xE83EU, 0x143FU,
+        0xC038U, 0x3C39U, 0x7839U, 0x8438U, 0xF039U, 0x0C38U, 0x4838U, 0xB439U,
+        0xA03AU, 0x5C3BU, 0x183BU, 0xE43AU, 0x903BU, 0x6C3AU, 0x283AU, 0xD43BU,
+        0xC037U, 0x3C36U, 0x7836U, 0x8437U, 0xF036U, 0x0C37U, 0x4837U, 0xB436U,
+        0xA035U, 0x5C34U, 0x1834U, 0xE435U, 0x9034U, 0x6C35U, 0x2835U, 0xD434U,
+        0x0033U, 0xFC32U, 0xB832U, 0x4433U, 0x3032U, 0xCC33U, 0x8833U, 0x7432U,
+        0x6031U, 0x9C30U, 0xD830U, 0x2431U, 0x5030U, 0xAC31U, 0xE831U, 0x1430U,
+    },
+};
+
+/** CRC-32/ISO-HDLC, polynomial 0x04C11DB7 reflected = 0xEDB88320. */
+static const uint32_t ums_crc32_table[UMS_CRC_SLICES][256] =
+{
+    {
+        0x00000000U, 0x77073096U, 0xEE0E612CU, 0x990951BAU, 0x076DC419U, 0x706AF48FU, 0xE963A535U, 0x9E6495A3U,
+        0x0EDB8832U, 0x79DCB8A4U, 0xE0D5E91EU, 0x97D2D988U, 0x09B64C2BU, 0x7EB17CBDU, 0xE7B82D07U, 0x90BF1D91U,
+        0x1DB71064U, 0x6AB020F2U, 0xF3B97148U, 0x84BE41DEU, 0x1ADAD47DU, 0x6DDDE4EBU, 0xF4D4B551U, 0x83D385C7U,
+        0x136C9856U, 0x646BA8C0U, 0xFD62F97AU, 0x8A65C9ECU, 0x14015C4FU, 0x63066CD9U, 0xFA0F3D63U, 0x8D080DF5U,
+        0x3B6E20C8U, 0x4C69105EU, 0xD56041E4U, 0xA2677172U, 0x3C03E4D1U, 0x4B04D447U, 0xD20D85FDU, 0xA50AB56BU,
+        0x35B5A8FAU, 0x42B2986CU, 0xDBBBC9D6U, 0xACBCF940U, 0x32D86CE3U, 0x45DF5C75U, 0xDCD60DCFU, 0xABD13D59U,
+        0x26D930ACU, 0x51DE003AU, 0xC8D75180U, 0xBFD06116U, 0x21B4F4B5U, 0x56B3C423U, 0xCFBA9599U, 0xB8BDA50FU,
+        0x2802B89EU, 0x5F058808U, 0xC60CD9B2U, 0xB10BE924U, 0x2F6F7C87U, 0x58684C11U, 0xC1611DABU, 0xB6662D3DU,
+        0x76DC4190U, 0x01DB7106U, 0x98D220BCU, 0xEFD5102AU, 0x71B18589U, 0x06B6B51FU, 0x9FBFE4A5U, 0xE8B8D433U,
+        0x7807C9A2U, 0x0F00F934U, 0x9609A88EU, 0xE10E9818U, 0x7F6A0DBBU, 0x086D3D2DU, 0x91646C97U, 0xE6635C01U,
+        0x6B6B51F4U, 0x1C6C6162U, 0x856530D8U, 0xF262004EU, 0x6C0695EDU, 0x1B01A57BU, 0x8208F4C1U, 0xF50FC457U,
+        0x65B0D9C6U, 0x12B7E950U, 0x8BBEB8EAU, 0xFCB9887CU, 0x62DD1DDFU, 0x15DA2D49U, 0x8CD37CF3U, 0xFBD44C65U,
+        0x4DB26158U, 0x3AB551CEU, 0xA3BC0074U, 0xD4BB30E2U, 0x4ADFA541U, 0x3DD895D7U, 0xA4D1C46DU, 0xD3D6F4FBU,
+        0x4369E96AU, 0x346ED9FCU, 0xAD678846U, 0xDA60B8D0U, 0x44042D73U, 0x33031DE5U, 0xAA0A4C5FU, 0xDD0D7CC9U,
+        0x5005713CU, 0x270241AAU, 0xBE0B1010U, 0xC90C2086U, 0x5768B525U, 0x206F85B3U, 0xB966D409U, 0xCE61E49FU,
+        0x5EDEF90EU, 0x29D9C998U, 0xB0D09822U, 0xC7D7A8B4U, 0x59B33D17U, 0x2EB40D81U, 0xB7BD5C3BU, 0xC0BA6CADU,
+        0xEDB88320U, 0x9ABFB3B6U, 0x03B6E20CU, 0x74B1D29AU, 0xEAD54739U, 0x9DD277AFU, 0x04DB2615U, 0x73DC1683U,
+        0xE3630B12U, 0x94643B84U, 0x0D6D6A3EU, 0x7A6A5AA8U, 0xE40ECF0BU, 0x9309FF9DU, 0x0A00AE27U, 0x7D079EB1U,
+        0xF00F9344U, 0x8708A3D2U, 0x1E01F268U, 0x6906C2FEU, 0xF762575DU, 0x806567CBU, 0x196C3671U, 0x6E6B06E7U,
+        0xFED41B76U, 0x89D32BE0U, 0x10DA7A5AU, 0x67DD4ACCU, 0xF9B9DF6FU, 0x8EBEEFF9U, 0x17B7BE43U, 0x60B08ED5U,
+        0xD6D6A3E8U, 0xA1D1937EU, 0x38D8C2C4U, 0x4FDFF252U, 0xD1BB67F1U, 0xA6BC5767U, 0x3FB506DDU, 0x48B2364BU,
+        0xD80D2BDAU, 0xAF0A1B4CU, 0x36034AF6U, 0x41047A60U, 0xDF60EFC3U, 0xA867DF55U, 0x316E8EEFU, 0x4669BE79U,
+        0xCB61B38CU, 0xBC66831AU, 0x256FD2A0U, 0x5268E236U, 0xCC0C7795U, 0xBB0B4703U, 0x220216B9U, 0x5505262FU,
+        0xC5BA3BBEU, 0xB2BD0B28U, 0x2BB45A92U, 0x5CB36A04U, 0xC2D7FFA7U, 0xB5D0CF31U, 0x2CD99E8BU, 0x5BDEAE1DU,
+        0x9B64C2B0U, 0xEC63F226U, 0x756AA39CU, 0x026D930AU, 0x9C0906A9U, 0xEB0E363FU, 0x72076785U, 0x05005713U,
+        0x95BF4A82U, 0xE2B87A14U, 0x7BB12BAEU, 0x0CB61B38U, 0x92D28E9BU, 0xE5D5BE0DU, 0x7CDCEFB7U, 0x0BDBDF21U,
+        0x86D3D2D4U, 0xF1D4E242U, 0x68DDB3F8U, 0x1FDA836EU, 0x81BE16CDU, 0xF6B9265BU, 0x6FB077E1U, 0x18B74777U,
+        0x88085AE6U, 0xFF0F6A70U, 0x66063BCAU, 0x11010B5CU, 0x8F659EFFU, 0xF862AE69U, 0x616BFFD3U, 0x166CCF45U,
+        0xA00AE278U, 0xD70DD2EEU, 0x4E048354U, 0x3903B3C2U, 0xA7672661U, 0xD06016F7U, 0x4969474DU, 0x3E6E77DBU,
+        0xAED16A4AU, 0xD9D65ADCU, 0x40DF0B66U, 0x37D83BF0U, 0xA9BCAE53U, 0xDEBB9EC5U, 0x47B2CF7FU, 0x30B5FFE9U,
+        0xBDBDF21CU, 0xCABAC28AU, 0x53B39330U, 0x24B4A3A6U, 0xBAD03605U, 0xCDD70693U, 0x54DE5729U, 0x23D967BFU,
+        0xB3667A2EU, 0xC4614AB8U, 0x5D681B02U, 0x2A6F2B94U, 0xB40BBE37U, 0xC30C8EA1U, 0x5A05DF1BU, 0x2D02EF8DU,
+    },
+    {
+        0x00000000U, 0x191B3141U, 0x32366282U, 0x2B2D53C3U, 0x646CC504U, 0x7D77F445U, 0x565AA786U, 0x4F4196C7U,
+        0xC8D98A08U, 0xD1C2BB49U, 0xFAEFE88AU, 0xE3F4D9CBU, 0xACB54F0CU, 0xB5AE7E4DU, 0x9E832D8EU, 0x87981CCFU,
+        0x4AC21251U, 0x53D92310U, 0x78F470D3U, 0x61EF4192U, 0x2EAED755U, 0x37B5E614U, 0x1C98B5D7U, 0x05838496U,
+        0x821B9859U, 0x9B00A918U, 0xB02DFADBU, 0xA936CB9AU, 0xE6775D5DU, 0xFF6C6C1CU, 0xD4413FDFU, 0xCD5A0E9EU,
+        0x958424A2U, 0x8C9F15E3U, 0xA7B24620U, 0xBEA97761U, 0xF1E8E1A6U, 0xE8F3D0E7U, 0xC3DE8324U, 0xDAC5B265U,
+        0x5D5DAEAAU, 0x44469FEBU, 0x6F6BCC28U, 0x7670FD69U, 0x39316BAEU, 0x202A5AEFU, 0x0B07092CU, 0x121C386DU,
+        0xDF4636F3U, 0xC65D07B2U, 0xED705471U, 0xF46B6530U, 0xBB2AF3F7U, 0xA231C2B6U, 0x891C9175U, 0x9007A034U,
+        0x179FBCFBU, 0x0E848DBAU, 0x25A9DE79U, 0x3CB2EF38U, 0x73F379FFU, 0x6AE848BEU, 0x41C51B7DU, 0x58DE2A3CU,
+        0xF0794F05U, 0xE9627E44U, 0xC24F2D87U, 0xDB541CC6U, 0x94158A01U, 0x8D0EBB40U, 0xA623E883U, 0xBF38D9C2U,
+        0x38A0C50DU, 0x21BBF44CU, 0x0A96A78FU, 0x138D96CEU, 0x5CCC0009U, 0x45D73148U, 0x6EFA628BU, 0x77E153CAU,
+        0xBABB5D54U, 0xA3A06C15U, 0x888D3FD6U, 0x91960E97U, 0xDED79850U, 0xC7CCA911U, 0xECE1FAD2U, 0xF5FACB93U,
+        0x7262D75CU, 0x6B79E61DU, 0x4054B5DEU, 0x594F849FU, 0x160E1258U, 0x0F152319U, 0x243870DAU, 0x3D23419BU,
+        0x65FD6BA7U, 0x7CE65AE6U, 0x57CB0925U, 0x4ED03864U, 0x0191AEA3U, 0x188A9FE2U, 0x33A7CC21U, 0x2ABCFD60U,
+        0xAD24E1AFU, 0xB43FD0EEU, 0x9F12832DU, 0x8609B26CU, 0xC94824ABU, 0xD05315EAU, 0xFB7E4629U, 0xE2657768U,
+        0x2F3F79F6U, 0x362448B7U, 0x1D091B74U, 0x04122A35U, 0x4B53BCF2U, 0x52488DB3U, 0x7965DE70U, 0x607EEF31U,
+        0xE7E6F3FEU, 0xFEFDC2BFU, 0xD5D0917CU, 0xCCCBA03DU, 0x838A36FAU, 0x9A9107BBU, 0xB1BC5478U, 0xA8A76539U,
+        0x3B83984BU, 0x2298A90AU, 0x09B5FAC9U, 0x10AECB88U, 0x5FEF5D4FU, 0x46F46C0EU, 0x6DD93FCDU, 0x74C20E8CU,
+        0xF35A1243U, 0xEA412302U, 0xC16C70C1U, 0xD8774180U, 0x9736D747U, 0x8E2DE606U, 0xA500B5C5U, 0xBC1B8484U,
+        0x71418A1AU, 0x685ABB5BU, 0x4377E898U, 0x5A6CD9D9U, 0x152D4F1EU, 0x0C367E5FU, 0x271B2D9CU, 0x3E001CDDU,
+        0xB9980012U, 0xA0833153U, 0x8BAE6290U, 0x92B553D1U, 0xDDF4C516U, 0xC4EFF457U, 0xEFC2A794U, 0xF6D996D5U,
+        0xAE07BCE9U, 0xB71C8DA8U, 0x9C31DE6BU, 0x852AEF2AU, 0xCA6B79EDU, 0xD37048ACU, 0xF85D1B6FU, 0xE1462A2EU,
+        0x66DE36E1U, 0x7FC507A0U, 0x54E85463U, 0x4DF36522U, 0x02B2F3E5U, 0x1BA9C2A4U, 0x30849167U, 0x299FA026U,
+        0xE4C5AEB8U, 0xFDDE9FF9U, 0xD6F3CC3AU, 0xCFE8FD7BU, 0x80A96BBCU, 0x99B25AFDU, 0xB29F093EU, 0xAB84387FU,
+        0x2C1C24B0U, 0x350715F1U, 0x1E2A4632U, 0x07317773U, 0x4870E1B4U, 0x516BD0F5U, 0x7A468336U, 0x635DB277U,
+        0xCBFAD74EU, 0xD2E1E60FU, 0xF9CCB5CCU, 0xE0D7848DU, 0xAF96124AU, 0xB68D230BU, 0x9DA070C8U, 0x84BB4189U,
+        0x03235D46U, 0x1A386C07U, 0x31153FC4U, 0x280E0E85U, 0x674F9842U, 0x7E54A903U, 0x5579FAC0U, 0x4C62CB81U,
+        0x8138C51FU, 0x9823F45EU, 0xB30EA79DU, 0xAA1596DCU, 0xE554001BU, 0xFC4F315AU, 0xD7626299U, 0xCE7953D8U,
+        0x49E14F17U, 0x50FA7E56U, 0x7BD72D95U, 0x62CC1CD4U, 0x2D8D8A13U, 0x3496BB52U, 0x1FBBE891U, 0x06A0D9D0U,
+        0x5E7EF3ECU, 0x4765C2ADU, 0x6C48916EU, 0x7553A02FU, 0x3A1236E8U, 0x230907A9U, 0x0824546AU, 0x113F652BU,
+        0x96A779E4U, 0x8FBC48A5U, 0xA4911B66U, 0xBD8A2A27U, 0xF2CBBCE0U, 0xEBD08DA1U, 0xC0FDDE62U, 0xD9E6EF23U,
+        0x14BCE1BDU, 0x0DA7D0FCU, 0x268A833FU, 0x3F91B27EU, 0x70D024B9U, 0x69CB15F8U, 0x42E6463BU, 0x5BFD777AU,
+        0xDC656BB5U, 0xC57E5AF4U, 0xEE530937U, 0xF7483876U, 0xB809AEB1U, 0xA1129FF0U, 0x8A3FCC33U, 0x9324FD72U,
+    },
+    {
+        0x00000000U, 0x01C26A37U, 0x0384D46EU, 0x0246BE59U, 0x0709A8DCU, 0x06CBC2EBU, 0x048D7CB2U, 0x054F1685U,
+        0x0E1351B8U, 0x0FD13B8FU, 0x0D9785D6U, 0x0C55EFE1U, 0x091AF964U, 0x08D89353U, 0x0A9E2D0AU, 0x0B5C473DU,
+        0x1C26A370U, 0x1DE4C947U, 0x1FA2771EU, 0x1E601D29U, 0x1B2F0BACU, 0x1AED619BU, 0x18ABDFC2U, 0x1969B5F5U,
+        0x1235F2C8U, 0x13F798FFU, 0x11B126A6U, 0x10734C91U, 0x153C5A14U, 0x14FE3023U, 0x16B88E7AU, 0x177AE44DU,
+        0x384D46E0U, 0x398F2CD7U, 0x3BC9928EU, 0x3A0BF8B9U, 0x3F44EE3CU, 0x3E86840BU, 0x3CC03A52U, 0x3D025065U,
+        0x365E1758U, 0x379C7D6FU, 0x35DAC336U, 0x3418A901U, 0x3157BF84U, 0x3095D5B3U, 0x32D36BEAU, 0x331101DDU,
+        0x246BE590U, 0x25A98FA7U, 0x27EF31FEU, 0x262D5BC9U, 0x23624D4CU, 0x22A0277BU, 0x20E69922U, 0x2124F315U,
+        0x2A78B428U, 0x2BBADE1FU, 0x29FC6046U, 0x283E0A71U, 0x2D711CF4U, 0x2CB376C3U, 0x2EF5C89AU, 0x2F37A2ADU,
+        0x709A8DC0U, 0x7158E7F7U, 0x731E59AEU, 0x72DC3399U, 0x7793251CU, 0x76514F2BU, 0x7417F172U, 0x75D59B45U,
+        0x7E89DC78U, 0x7F4BB64FU, 0x7D0D0816U, 0x7CCF6221U, 0x798074A4U, 0x78421E93U, 0x7A04A0CAU, 0x7BC6CAFDU,
+        0x6CBC2EB0U, 0x6D7E4487U, 0x6F38FADEU, 0x6EFA90E9U, 0x6BB5866CU, 0x6A77EC5BU, 0x68315202U, 0x69F33835U,
+        0x62AF7F08U, 0x636D153FU, 0x612BAB66U, 0x60E9C151U, 0x65A6D7D4U, 0x6464BDE3U, 0x662203BAU, 0x67E0698DU,
+        0x48D7CB20U, 0x4915A117U, 0x4B531F4EU, 0x4A917579U, 0x4FDE63FCU, 0x4E1C09CBU, 0x4C5AB792U, 0x4D98DDA5U,
+        0x46C49A98U, 0x4706F0AFU, 0x45404EF6U, 0x448224C1U, 0x41CD3244U, 0x400F5873U, 0x4249E62AU, 0x438B8C1DU,
+        0x54F16850U, 0x55330267U, 0x5775BC3EU, 0x56B7D609U, 0x53F8C08CU, 0x523AAABBU, 0x507C14E2U, 0x51BE7ED5U,
+        0x5AE239E8U, 0x5B2053DFU, 0x5966ED86U, 0x58A487B1U, 0x5DEB9134U, 0x5C29FB03U, 0x5E6F455AU, 0x5FAD2F6DU,
+        0xE1351B80U, 0xE0F771B7U, 0xE2B1CFEEU, 0xE373A5D9U, 0xE63CB35CU, 0xE7FED96BU, 0xE5B86732U, 0xE47A0D05U,
+        0xEF264A38U, 0xEEE4200FU, 0xECA29E56U, 0xED60F461U, 0xE82FE2E4U, 0xE9ED88D3U, 0xEBAB368AU, 0xEA695CBDU,
+        0xFD13B8F0U, 0xFCD1D2C7U, 0xFE976C9EU, 0xFF5506A9U, 0xFA1A102CU, 0xFBD87A1BU, 0xF99EC442U, 0xF85CAE75U,
+        0xF300E948U, 0xF2C2837FU, 0xF0843D26U, 0xF1465711U, 0xF4094194U, 0xF5CB2BA3U, 0xF78D95FAU, 0xF64FFFCDU,
+        0xD9785D60U, 0xD8BA3757U, 0xDAFC890EU, 0xDB3EE339U, 0xDE71F5BCU, 0xDFB39F8BU, 0xDDF521D2U, 0xDC374BE5U,
+        0xD76B0CD8U, 0xD6A966EFU, 0xD4EFD8B6U, 0xD52DB281U, 0xD062A404U, 0xD1A0CE33U, 0xD3E6706AU, 0xD2241A5DU,
+        0xC55EFE10U, 0xC49C9427U, 0xC6DA2A7EU, 0xC7184049U, 0xC25756CCU, 0xC3953CFBU, 0xC1D382A2U, 0xC011E895U,
+        0xCB4DAFA8U, 0xCA8FC59FU, 0xC8C97BC6U, 0xC90B11F1U, 0xCC440774U, 0xCD866D43U, 0xCFC0D31AU, 0xCE02B92DU,
+        0x91AF9640U, 0x906DFC77U, 0x922B422EU, 0x93E92819U, 0x96A63E9CU, 0x976454ABU, 0x9522EAF2U, 0x94E080C5U,
+        0x9FBCC7F8U, 0x9E7EADCFU, 0x9C381396U, 0x9DFA79A1U, 0x98B56F24U, 0x99770513U, 0x9B31BB4AU, 0x9AF3D17DU,
+        0x8D893530U, 0x8C4B5F07U, 0x8E0DE15EU, 0x8FCF8B69U, 0x8A809DECU, 0x8B42F7DBU, 0x89044982U, 0x88C623B5U,
+        0x839A6488U, 0x82580EBFU, 0x801EB0E6U, 0x81DCDAD1U, 0x8493CC54U, 0x8551A663U, 0x8717183AU, 0x86D5720DU,
+        0xA9E2D0A0U, 0xA820BA97U, 0xAA6604CEU, 0xABA46EF9U, 0xAEEB787CU, 0xAF29124BU, 0xAD6FAC12U, 0xACADC625U,
+        0xA7F18118U, 0xA633EB2FU, 0xA4755576U, 0xA5B73F41U, 0xA0F829C4U, 0xA13A43F3U, 0xA37CFDAAU, 0xA2BE979DU,
+        0xB5C473D0U, 0xB40619E7U, 0xB640A7BEU, 0xB782CD89U, 0xB2CDDB0CU, 0xB30FB13BU, 0xB1490F62U, 0xB08B6555U,
+        0xBBD72268U, 0xBA15485FU, 0xB853F606U, 0xB9919C31U, 0xBCDE8AB4U, 0xBD1CE083U, 0xBF5A5EDAU, 0xBE9834EDU,
+    },
+    {
+        0x00000000U, 0xB8BC6765U, 0xAA09C88BU, 0x12B5AFEEU, 0x8F629757U, 0x37DEF032U, 0x256B5FDCU, 0x9DD738B9U,
+        0xC5B428EFU, 0x7D084F8AU, 0x6FBDE064U, 0xD7018701U, 0x4AD6BFB8U, 0xF26AD8DDU, 0xE0DF7733U, 0x58631056U,
+        0x5019579FU, 0xE8A530FAU, 0xFA109F14U, 0x42ACF871U, 0xDF7BC0C8U, 0x67C7A7ADU, 0x75720843U, 0xCDCE6F26U,
+        0x95AD7F70U, 0x2D111815U, 0x3FA4B7FBU, 0x8718D09EU, 0x1ACFE827U, 0xA2738F42U, 0xB0C620ACU, 0x087A47C9U,
+        0xA032AF3EU, 0x188EC85BU, 0x0A3B67B5U, 0xB28700D0U, 0x2F503869U, 0x97EC5F0CU, 0x8559F0E2U, 0x3DE59787U,
+        0x658687D1U, 0xDD3AE0B4U, 0xCF8F4F5AU, 0x7733283FU, 0xEAE41086U, 0x525877E3U, 0x40EDD80DU, 0xF851BF68U,
+        0xF02BF8A1U, 0x48979FC4U, 0x5A22302AU, 0xE29E574FU, 0x7F496FF6U, 0xC7F50893U, 0xD540A77DU, 0x6DFCC018U,
+        0x359FD04EU, 0x8D23B72BU, 0x9F9618C5U, 0x272A7FA0U, 0xBAFD4719U, 0x0241207CU, 0x10F48F92U, 0xA848E8F7U,
+        0x9B14583DU, 0x23A83F58U, 0x311D90B6U, 0x89A1F7D3U, 0x1476CF6AU, 0xACCAA80FU, 0xBE7F07E1U, 0x06C36084U,
+        0x5EA070D2U, 0xE61C17B7U, 0xF4A9B859U, 0x4C15DF3CU, 0xD1C2E785U, 0x697E80E0U, 0x7BCB2F0EU, 0xC377486BU,
+        0xCB0D0FA2U, 0x73B168C7U, 0x6104C729U, 0xD9B8A04CU, 0x446F98F5U, 0xFCD3FF90U, 0xEE66507EU, 0x56DA371BU,
+        0x0EB9274DU, 0xB6054028U, 0xA4B0EFC6U, 0x1C0C88A3U, 0x81DBB01AU, 0x3967D77FU, 0x2BD27891U, 0x936E1FF4U,
+        0x3B26F703U, 0x839A9066U, 0x912F3F88U, 0x299358EDU, 0xB4446054U, 0x0CF80731U, 0x1E4DA8DFU, 0xA6F1CFBAU,
+        0xFE92DFECU, 0x462EB889U, 0x549B1767U, 0xEC277002U, 0x71F048BBU, 0xC94C2FDEU, 0xDBF98030U, 0x6345E755U,
+        0x6B3FA09CU, 0xD383C7F9U, 0xC1366817U, 0x798A0F72U, 0xE45D37CBU, 0x5CE150AEU, 0x4E54FF40U, 0xF6E89825U,
+        0xAE8B8873U, 0x1637EF16U, 0x048240F8U, 0xBC3E279DU, 0x21E91F24U, 0x99557841U, 0x8BE0D7AFU, 0x335CB0CAU,
+        0xED59B63BU, 0x55E5D15EU, 0x47507EB0U, 0xFFEC19D5U, 0x623B216CU, 0xDA874609U, 0xC832E9E7U, 0x708E8E82U,
+        0x28ED9ED4U, 0x9051F9B1U, 0x82E4565FU, 0x3A58313AU, 0xA78F0983U, 0x1F336EE6U, 0x0D86C108U, 0xB53AA66DU,
+        0xBD40E1A4U, 0x05FC86C1U, 0x1749292FU, 0xAFF54E4AU, 0x322276F3U, 0x8A9E1196U, 0x982BBE78U, 0x2097D91DU,
+        0x78F4C94BU, 0xC048AE2EU, 0xD2FD01C0U, 0x6A4166A5U, 0xF7965E1CU, 0x4F2A3979U, 0x5D9F9697U, 0xE523F1F2U,
+        0x4D6B1905U, 0xF5D77E60U, 0xE762D18EU, 0x5FDEB6EBU, 0xC2098E52U, 0x7AB5E937U, 0x680046D9U, 0xD0BC21BCU,
+        0x88DF31EAU, 0x3063568FU, 0x22D6F961U, 0x9A6A9E04U, 0x07BDA6BDU, 0xBF01C1D8U, 0xADB46E36U, 0x15080953U,
+        0x1D724E9AU, 0xA5CE29FFU, 0xB77B8611U, 0x0FC7E174U, 0x9210D9CDU, 0x2AACBEA8U, 0x38191146U, 0x80A57623U,
+        0xD8C66675U, 0x607A0110U, 0x72CFAEFEU, 0xCA73C99BU, 0x57A4F122U, 0xEF189647U, 0xFDAD39A9U, 0x45115ECCU,
+        0x764DEE06U, 0xCEF18963U, 0xDC44268DU, 0x64F841E8U, 0xF92F7951U, 0x41931E34U, 0x5326B1DAU, 0xEB9AD6BFU,
+        0xB3F9C6E9U, 0x0B45A18CU, 0x19F00E62U, 0xA14C6907U, 0x3C9B51BEU, 0x842736DBU, 0x96929935U, 0x2E2EFE50U,
+        0x2654B999U, 0x9EE8DEFCU, 0x8C5D7112U, 0x34E11677U, 0xA9362ECEU, 0x118A49ABU, 0x033FE645U, 0xBB838120U,
+        0xE3E09176U, 0x5B5CF613U, 0x49E959FDU, 0xF1553E98U, 0x6C820621U, 0xD43E6144U, 0xC68BCEAAU, 0x7E37A9CFU,
+        0xD67F4138U, 0x6EC3265DU, 0x7C7689B3U, 0xC4CAEED6U, 0x591DD66FU, 0xE1A1B10AU, 0xF3141EE4U, 0x4BA87981U,
+        0x13CB69D7U, 0xAB770EB2U, 0xB9C2A15CU, 0x017EC639U, 0x9CA9FE80U, 0x241599E5U, 0x36A0360BU, 0x8E1C516EU,
+        0x866616A7U, 0x3EDA71C2U, 0x2C6FDE2CU, 0x94D3B949U, 0x090481F0U, 0xB1B8E695U, 0xA30D497BU, 0x1BB12E1EU,
+        0x43D23E48U, 0xFB6E592DU, 0xE9DBF6C3U, 0x516791A6U, 0xCCB0A91FU, 0x740CCE7AU, 0x66B96194U, 0xDE0506F1U,
+    },
+};
+
+#endif
@@ -0,0 +1,234 @@
+//
+//
+//
+
+#include "string.h"
+
+#include "ums/encoding.h"
+
+/** Longest varint per codec: zigzag adds one bit to the integer width, float XORs use the full width. */
+static const uint8_t s_codec_max_size[] = {
+    [UMS_CODEC_INT8]    = 2U,
+    [UMS_CODEC_INT16]   = 3U,
+    [UMS_CODEC_INT32]   = 5U,
+    [UMS_CODEC_INT64]   = 10U,
+    [UMS_CODEC_FLOAT32] = 5U,
+    [UMS_CODEC_FLOAT64] = 10U,
+};
+
+/** Byte width per codec. */
+static const uint8_t s_codec_size[] = {
+    [UMS_CODEC_INT8]    = 1U,
+    [UMS_CODEC_INT16]   = 2U,
+    [UMS_CODEC_INT32]   = 4U,
+    [UMS_CODEC_INT64]   = 8U,
+    [UMS_CODEC_FLOAT32] = 4U,
+    [UMS_CODEC_FLOAT64] = 8U,
+};
+
+/**
+ * Decides whether the next frame is a keyframe and updates the keyframe bookkeeping.
+ */
+static bool ums_delta_encoder_next_is_key(ums_delta_encoder_t *encoder)
+{
+    const bool keyframe = encoder->force_keyframe
+                       || (encoder->keyframe_interval != 0U && encoder->frames_since_key >= encoder->keyframe_interval);
+    if (keyframe)
+    {
+        encoder->force_keyframe = false;
+        encoder->frames_since_key = 1U;
+    }
+    else
+    {
+        encoder->frames_since_key++;
+    }
+    return keyframe;
+}
+
+void ums_delta_encoder_reset(ums_delta_encoder_t *encoder)
+{
+    encoder->channel_count = 0;
+    encoder->payload_size = 0;
+    encoder->max_frame_size = 1U + sizeof(uint32_t);
+    encoder->max_changed_frame_size = sizeof(uint32_t) + UMS_PRESENCE_BITMAP_SIZE;
+    encoder->keyframe_interval = 0;
+    encoder->frames_since_key = 0;
+    encoder->force_keyframe = true;
+    encoder->prev_timestamp = 0;
+    encoder->current = 0;
+}
+
+ums_err_t ums_delta_encoder_add_channel(ums_delta_encoder_t *encoder, const ums_datatype_t type)
+{
+    const uint8_t size = ums_datatype_size(type);
+    if (size == 0)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+    if (encoder->channel_count == UMS_MAX_CHANNELS)
+    {
+        return UMS_RANGE_ERROR;
+    }
+
+    const uint8_t kind = ums_codec_kind(type);
+    encoder->kinds[encoder->channel_count++] = kind;
+    encoder->payload_size += size;
+
+    // A keyframe is 1 + 4 + payload, a delta frame 1 + 5 + sum of varints; keep the larger bound.
+    uint16_t delta_size = 1U + 5U;
+    for (uint8_t i = 0; i < encoder->channel_count; i++)
+    {
+        delta_size += s_codec_max_size[encoder->kinds[i]];
+    }
+    const uint16_t key_size = 1U + sizeof(uint32_t) + encoder->payload_size;
+    encoder->max_frame_size = (delta_size > key_size) ? delta_size : key_size;
+    encoder->max_changed_frame_size = sizeof(uint32_t) + UMS_PRESENCE_BITMAP_SIZE + encoder->payload_size;
+
+    return UMS_SUCCESS;
+}
+
+void ums_delta_encoder_configure(ums_delta_encoder_t *encoder, const uint16_t keyframe_interval)
+{
+    encoder->keyframe_interval = keyframe_interval;
+    encoder->frames_since_key = 0;
+    encoder->force_keyframe = true;
+}
+
+void ums_delta_encoder_force_keyframe(ums_delta_encoder_t *encoder)
+{
+    encoder->force_keyframe = true;
+}
+
+uint8_t* ums_delta_encoder_snapshot(ums_delta_encoder_t *encoder)
+{
+    return encoder->values[encoder->current];
+}
+
+uint16_t ums_delta_encode(ums_delta_encoder_t *encoder, const uint32_t timestamp, uint8_t *dst_ptr)
+{
+    const uint8_t *cur = encoder->values[encoder->current];
+    const uint8_t *ref = encoder->values[encoder->current ^ 1U];
+    uint16_t length = 1U;
+
+    if (ums_delta_encoder_next_is_key(encoder))
+    {
+        dst_ptr[0] = UMS_FRAME_TAG_KEYFRAME;
+        memcpy(&dst_ptr[length], &timestamp, sizeof(timestamp));
+        length += sizeof(timestamp);
+        memcpy(&dst_ptr[length], cur, encoder->payload_size);
+        length += encoder->payload_size;
+    }
+    else
+    {
+        dst_ptr[0] = 0;
+        length += ums_varint_encode((uint32_t)(timestamp - encoder->prev_timestamp), &dst_ptr[length]);
+
+        uint16_t offset = 0;
+        for (uint8_t i = 0; i < encoder->channel_count; i++)
+        {
+            uint64_t value;
+            switch (encoder->kinds[i])
+            {
+            case UMS_CODEC_INT8:
+            {
+                value = ums_zigzag_encode((int8_t)(uint8_t)(cur[offset] - ref[offset]));
+                offset += 1U;
+                break;
+            }
+            case UMS_CODEC_INT16:
+            {
+                uint16_t c, r;
+                memcpy(&c, &cur[offset], sizeof(c));
+                memcpy(&r, &ref[offset], sizeof(r));
+                value = ums_zigzag_encode((int16_t)(uint16_t)(c - r));
+                offset += sizeof(c);
+                break;
+            }
+            case UMS_CODEC_INT32:
+            {
+                uint32_t c, r;
+                memcpy(&c, &cur[offset], sizeof(c));
+                memcpy(&r, &ref[offset], sizeof(r));
+                value = ums_zigzag_encode((int32_t)(c - r));
+                offset += sizeof(c);
+                break;
+            }
+            case UMS_CODEC_INT64:
+            {
+                uint64_t c, r;
+                memcpy(&c, &cur[offset], sizeof(c));
+                memcpy(&r, &ref[offset], sizeof(r));
+                value = ums_zigzag_encode((int64_t)(c - r));
+                offset += sizeof(c);
+                break;
+            }
+            case UMS_CODEC_FLOAT32:
+            {
+                uint32_t c, r;
+                memcpy(&c, &cur[offset], sizeof(c));
+                memcpy(&r, &ref[offset], sizeof(r));
+                value = c ^ r;
+                offset += sizeof(c);
+                break;
+            }
+            default:
+            {
+                uint64_t c, r;
+                memcpy(&c, &cur[offset], sizeof(c));
+                memcpy(&r, &ref[offset], sizeof(r));
+                value = c ^ r;
+                offset += sizeof(c);
+                break;
+            }
+            }
+            length += ums_varint_encode(value, &dst_ptr[length]);
+        }
+    }
+
+    encoder->prev_timestamp = timestamp;
+    encoder->current ^= 1U;
+
+    return length;
+}
+
+uint16_t ums_changed_encode(ums_delta_encoder_t *encoder, const uint32_t timestamp, uint8_t *dst_ptr)
+{
+    const uint8_t *cur = encoder->values[encoder->current];
+    const uint8_t *ref = encoder->values[encoder->current ^ 1U];
+    uint8_t *bitmap = &dst_ptr[sizeof(timestamp)];
+    uint16_t length = sizeof(timestamp) + UMS_PRESENCE_BITMAP_SIZE;
+
+    memcpy(dst_ptr, &timestamp, sizeof(timestamp));
+
+    if (ums_delta_encoder_next_is_key(encoder))
+    {
+        memset(bitmap, 0, UMS_PRESENCE_BITMAP_SIZE);
+        for (uint8_t i = 0; i < encoder->channel_count; i++)
+        {
+            bitmap[i >> 3] |= (uint8_t)(1U << (i & 7U));
+        }
+        memcpy(&dst_ptr[length], cur, encoder->payload_size);
+        length += encoder->payload_size;
+    }
+    else
+    {
+        memset(bitmap, 0, UMS_PRESENCE_BITMAP_SIZE);
+        uint16_t offset = 0;
+        for (uint8_t i = 0; i < encoder->channel_count; i++)
+        {
+            const uint8_t size = s_codec_size[encoder->kinds[i]];
+            if (memcmp(&cur[offset], &ref[offset], size) != 0)
+            {
+                bitmap[i >> 3] |= (uint8_t)(1U << (i & 7U));
+                memcpy(&dst_ptr[length], &cur[offset], size);
+                length += size;
+            }
+            offset += size;
+        }
+    }
+
+    encoder->prev_timestamp = timestamp;
+    encoder->current ^= 1U;
+
+    return length;
+}
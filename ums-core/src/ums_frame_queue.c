@@ -0,0 +1,171 @@
+//
+//
+//
+
+#include "ums/frame_queue.h"
+
+#define UMS_FRAME_QUEUE_MASK    (UMS_FRAME_QUEUE_MAX_SLOTS - 1U)
+
+/**
+ * Pops the oldest pending slot index. Called by the transmitter and, for UMS_DROP_OLDEST, by the producer,
+ * so the tail is advanced with compare-and-swap.
+ */
+static uint8_t ums_frame_queue_pop_pending(ums_frame_queue_t *queue)
+{
+    uint32_t tail = atomic_load(&queue->pending_tail);
+    uint8_t slot;
+
+    do
+    {
+        if (tail == atomic_load(&queue->pending_head))
+        {
+            return UMS_FRAME_QUEUE_NO_SLOT;
+        }
+        slot = queue->pending_ring[tail & UMS_FRAME_QUEUE_MASK];
+    } while (!atomic_compare_exchange_weak(&queue->pending_tail, &tail, tail + 1U));
+
+    return slot;
+}
+
+ums_err_t ums_frame_queue_init(ums_frame_queue_t *queue, sample_packet_t *slots, const uint8_t slot_count,
+                               const ums_overflow_policy_t policy)
+{
+    if (!queue || !slots)
+    {
+        return UMS_NULL_POINTER;
+    }
+    if (slot_count < 2U || slot_count > UMS_FRAME_QUEUE_MAX_SLOTS)
+    {
+        return UMS_RANGE_ERROR;
+    }
+    if (policy != UMS_DROP_NEWEST && policy != UMS_DROP_OLDEST)
+    {
+        return UMS_INVALID_PARAMETER;
+    }
+
+    queue->slots = slots;
+    queue->slot_count = slot_count;
+    queue->policy = policy;
+    queue->write_slot = UMS_FRAME_QUEUE_NO_SLOT;
+    queue->tx_slot = UMS_FRAME_QUEUE_NO_SLOT;
+
+    for (uint8_t i = 0; i < slot_count; i++)
+    {
+        queue->free_ring[i] = i;
+    }
+    atomic_store(&queue->free_head, slot_count);
+    atomic_store(&queue->free_tail, 0U);
+    atomic_store(&queue->pending_head, 0U);
+    atomic_store(&queue->pending_tail, 0U);
+    atomic_store(&queue->busy, 0U);
+
+    queue->stats = (ums_queue_stats_t){0};
+
+    return UMS_SUCCESS;
+}
+
+sample_packet_t* ums_frame_queue_acquire(ums_frame_queue_t *queue)
+{
+    if (queue->write_slot == UMS_FRAME_QUEUE_NO_SLOT)
+    {
+        const uint32_t tail = atomic_load(&queue->free_tail);
+        if (tail != atomic_load(&queue->free_head))
+        {
+            queue->write_slot = queue->free_ring[tail & UMS_FRAME_QUEUE_MASK];
+            atomic_store(&queue->free_tail, tail + 1U);
+        }
+        else if (queue->policy == UMS_DROP_OLDEST)
+        {
+            queue->write_slot = ums_frame_queue_pop_pending(queue);
+            if (queue->write_slot != UMS_FRAME_QUEUE_NO_SLOT)
+            {
+                queue->stats.dropped++;
+            }
+        }
+    }
+
+    if (queue->write_slot == UMS_FRAME_QUEUE_NO_SLOT)
+    {
+        // Only the slot under transmission is left (or policy is UMS_DROP_NEWEST), drop this sample.
+        queue->stats.dropped++;
+        return nullptr;
+    }
+    return &queue->slots[queue->write_slot];
+}
+
+void ums_frame_queue_publish(ums_frame_queue_t *queue, const uint16_t length)
+{
+    queue->lengths[queue->write_slot] = length;
+
+    const uint32_t head = atomic_load(&queue->pending_head);
+    queue->pending_ring[head & UMS_FRAME_QUEUE_MASK] = queue->write_slot;
+    atomic_store(&queue->pending_head, head + 1U);
+    queue->write_slot = UMS_FRAME_QUEUE_NO_SLOT;
+
+    queue->stats.captured++;
+    const uint32_t pending = head + 1U - atomic_load(&queue->pending_tail);
+    if (pending > queue->stats.high_water)
+    {
+        queue->stats.high_water = (uint8_t)pending;
+    }
+}
+
+sample_packet_t* ums_frame_queue_claim(ums_frame_queue_t *queue, uint16_t *length)
+{
+    for (;;)
+    {
+        uint32_t idle = 0U;
+        if (!atomic_compare_exchange_strong(&queue->busy, &idle, 1U))
+        {
+            return nullptr;
+        }
+
+        const uint8_t slot = ums_frame_queue_pop_pending(queue);
+        if (slot != UMS_FRAME_QUEUE_NO_SLOT)
+        {
+            queue->tx_slot = slot;
+            *length = queue->lengths[slot];
+            return &queue->slots[slot];
+        }
+        atomic_store(&queue->busy, 0U);
+
+        // A publish between the pop and clearing busy would otherwise stay pending until the next update.
+        if (atomic_load(&queue->pending_tail) == atomic_load(&queue->pending_head))
+        {
+            return nullptr;
+        }
+    }
+}
+
+bool ums_frame_queue_reserve(ums_frame_queue_t *queue)
+{
+    uint32_t idle = 0U;
+    return atomic_compare_exchange_strong(&queue->busy, &idle, 1U);
+}
+
+sample_packet_t* ums_frame_queue_complete(ums_frame_queue_t *queue, uint16_t *length)
+{
+    if (queue->tx_slot == UMS_FRAME_QUEUE_NO_SLOT)
+    {
+        // End of a reserved transfer, no slot to release.
+        atomic_store(&queue->busy, 0U);
+        return ums_frame_queue_claim(queue, length);
+    }
+
+    const uint32_t head = atomic_load(&queue->free_head);
+    queue->free_ring[head & UMS_FRAME_QUEUE_MASK] = queue->tx_slot;
+    atomic_store(&queue->free_head, head + 1U);
+    queue->tx_slot = UMS_FRAME_QUEUE_NO_SLOT;
+    queue->stats.transmitted++;
+
+    const uint8_t slot = ums_frame_queue_pop_pending(queue);
+    if (slot != UMS_FRAME_QUEUE_NO_SLOT)
+    {
+        queue->tx_slot = slot;
+        *length = queue->lengths[slot];
+        return &queue->slots[slot];
+    }
+    atomic_store(&queue->busy, 0U);
+
+    return ums_frame_queue_claim(queue, length);
+}
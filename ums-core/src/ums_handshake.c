@@ -0,0 +1,161 @@
+//
+//
+//
+
+#include "string.h"
+
+#include "ums/crc.h"
+#include "ums/encoding.h"
+#include "ums/handshake.h"
+
+#define UMS_FNV_OFFSET_BASIS    2166136261U
+#define UMS_FNV_PRIME           16777619U
+
+/**
+ * Bounded writer over the packet being built, overflow is sticky and checked once at the end.
+ */
+typedef struct ums_handshake_writer_t
+{
+    uint8_t*    dst;
+    uint16_t    capacity;
+    uint16_t    length;
+    bool        overflow;
+} ums_handshake_writer_t;
+
+static void ums_handshake_put(ums_handshake_writer_t *writer, const void *src_ptr, const uint16_t length)
+{
+    if (writer->overflow || (uint32_t)writer->length + length > writer->capacity)
+    {
+        writer->overflow = true;
+        return;
+    }
+    memcpy(&writer->dst[writer->length], src_ptr, length);
+    writer->length += length;
+}
+
+static void ums_handshake_put_u8(ums_handshake_writer_t *writer, const uint8_t value)
+{
+    ums_handshake_put(writer, &value, 1U);
+}
+
+static void ums_handshake_put_varint(ums_handshake_writer_t *writer, const uint32_t value)
+{
+    uint8_t bytes[UMS_VARINT_MAX_SIZE];
+    ums_handshake_put(writer, bytes, ums_varint_encode(value, bytes));
+}
+
+static void ums_handshake_put_name(ums_handshake_writer_t *writer, const char *name)
+{
+    const size_t length = strlen(name);
+    if (length > UINT8_MAX)
+    {
+        writer->overflow = true;
+        return;
+    }
+    ums_handshake_put_u8(writer, (uint8_t)length);
+    ums_handshake_put(writer, name, (uint16_t)length);
+}
+
+uint8_t ums_handshake_type_byte(const ums_datatype_t type)
+{
+    uint8_t size_log2 = 0;
+    for (uint8_t size = ums_datatype_size(type); size > 1U; size >>= 1U)
+    {
+        size_log2++;
+    }
+    return (uint8_t)((type & UMS_HANDSHAKE_TYPE_MASK) | (size_log2 << UMS_HANDSHAKE_SIZE_SHIFT));
+}
+
+uint32_t ums_handshake_hash(const uint8_t *data, const uint32_t length)
+{
+    uint32_t hash = UMS_FNV_OFFSET_BASIS;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        hash ^= data[i];
+        hash *= UMS_FNV_PRIME;
+    }
+    return hash;
+}
+
+ums_err_t ums_handshake_build(const ums_handshake_layout_t *layout, uint8_t *dst_ptr, const uint16_t capacity,
+                              uint16_t *length)
+{
+    if (!layout || !dst_ptr || !length)
+    {
+        return UMS_NULL_POINTER;
+    }
+
+    ums_handshake_writer_t writer = {dst_ptr, capacity, 0, false};
+    const uint32_t hash_placeholder = 0;
+    ums_handshake_put_u8(&writer, UMS_HANDSHAKE_MAGIC_0);
+    ums_handshake_put_u8(&writer, UMS_HANDSHAKE_MAGIC_1);
+    ums_handshake_put_u8(&writer, UMS_HANDSHAKE_VERSION);
+    ums_handshake_put(&writer, &hash_placeholder, sizeof(hash_placeholder));
+
+    ums_handshake_put_u8(&writer, layout->encoding);
+    ums_handshake_put_u8(&writer, layout->sequence_size);
+    ums_handshake_put_u8(&writer, layout->crc);
+    ums_handshake_put_u8(&writer, layout->group_count);
+    for (uint8_t g = 0; g < layout->group_count; g++)
+    {
+        ums_handshake_put(&writer, &layout->group_divider[g], sizeof(uint16_t));
+    }
+
+    ums_handshake_put_u8(&writer, layout->channel_count);
+    for (uint8_t i = 0; i < layout->channel_count; i++)
+    {
+        const data_channel_t *channel = &layout->channels[i];
+        ums_handshake_put_u8(&writer, ums_handshake_type_byte(channel->var_type));
+        ums_handshake_put_u8(&writer, channel->group);
+        ums_handshake_put_varint(&writer, channel->count);
+        ums_handshake_put_name(&writer, channel->var_name_ptr);
+
+        if (channel->var_type != UMS_STRUCT)
+        {
+            continue;
+        }
+        ums_handshake_put_varint(&writer, channel->size);
+        for (uint16_t f = 0; f < channel->count; f++)
+        {
+            ums_handshake_put_u8(&writer, ums_handshake_type_byte(channel->fields[f].type));
+            ums_handshake_put_varint(&writer, channel->fields[f].offset);
+            ums_handshake_put_name(&writer, channel->fields[f].name);
+        }
+    }
+
+    if (writer.overflow)
+    {
+        return UMS_RANGE_ERROR;
+    }
+
+    const uint32_t hash = ums_handshake_hash(&dst_ptr[UMS_HANDSHAKE_HEADER_SIZE],
+                                             writer.length - UMS_HANDSHAKE_HEADER_SIZE);
+    memcpy(&dst_ptr[3], &hash, sizeof(hash));
+
+    if (layout->crc != UMS_CRC_NONE)
+    {
+        const uint32_t crc = ums_crc_compute((ums_crc_t)layout->crc, dst_ptr, writer.length);
+        ums_handshake_put(&writer, &crc, ums_crc_size((ums_crc_t)layout->crc));
+        if (writer.overflow)
+        {
+            return UMS_RANGE_ERROR;
+        }
+    }
+    *length = writer.length;
+
+    return UMS_SUCCESS;
+}
+
+uint32_t ums_handshake_layout_hash(const uint8_t *packet)
+{
+    uint32_t hash;
+    memcpy(&hash, &packet[3], sizeof(hash));
+    return hash;
+}
+
+void ums_sync_marker_build(const uint32_t layout_hash, uint8_t *dst_ptr)
+{
+    dst_ptr[0] = UMS_SYNC_MAGIC_0;
+    dst_ptr[1] = UMS_SYNC_MAGIC_1;
+    memcpy(&dst_ptr[2], &layout_hash, sizeof(layout_hash));
+}
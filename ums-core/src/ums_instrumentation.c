@@ -0,0 +1,48 @@
+//
+//
+//
+
+#include "string.h"
+
+#include "ums/instrumentation.h"
+
+void ums_cycle_stats_reset(ums_cycle_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->min = UINT32_MAX;
+}
+
+uint8_t ums_cycle_bucket(const uint32_t cycles)
+{
+    if (cycles == 0)
+    {
+        return 0;
+    }
+    const uint8_t width = (uint8_t)(32 - __builtin_clz(cycles));
+    return (width < UMS_CYCLE_HISTOGRAM_BUCKETS) ? width : (uint8_t)(UMS_CYCLE_HISTOGRAM_BUCKETS - 1U);
+}
+
+void ums_cycle_stats_record(ums_cycle_stats_t *stats, const uint32_t cycles)
+{
+    stats->count++;
+    stats->last = cycles;
+    stats->total += cycles;
+    if (cycles < stats->min)
+    {
+        stats->min = cycles;
+    }
+    if (cycles > stats->max)
+    {
+        stats->max = cycles;
+    }
+    stats->histogram[ums_cycle_bucket(cycles)]++;
+}
+
+uint32_t ums_cycle_stats_mean(const ums_cycle_stats_t *stats)
+{
+    if (stats->count == 0)
+    {
+        return 0;
+    }
+    return (uint32_t)(stats->total / stats->count);
+}
@@ -0,0 +1,113 @@
+//
+//
+//
+
+#include "string.h"
+
+#include "ums/scope_ring.h"
+
+static inline uint8_t* ums_scope_ring_slot(const ums_scope_ring_t *ring, const uint32_t slot)
+{
+    return &ring->buffer[slot * (UMS_SCOPE_SLOT_HEADER + ring->frame_size)];
+}
+
+ums_err_t ums_scope_ring_init(ums_scope_ring_t *ring, uint8_t *buffer, const uint32_t buffer_size,
+                              const uint16_t frame_size, const uint32_t post_trigger)
+{
+    if (!ring || !buffer)
+    {
+        return UMS_NULL_POINTER;
+    }
+    if (frame_size == 0)
+    {
+        return UMS_RANGE_ERROR;
+    }
+
+    const uint32_t slot_count = buffer_size / (UMS_SCOPE_SLOT_HEADER + frame_size);
+    if (slot_count < 2U || post_trigger >= slot_count)
+    {
+        return UMS_RANGE_ERROR;
+    }
+
+    ring->buffer = buffer;
+    ring->buffer_size = buffer_size;
+    ring->frame_size = frame_size;
+    ring->slot_count = slot_count;
+    ring->post_trigger = post_trigger;
+    ums_scope_ring_arm(ring);
+
+    return UMS_SUCCESS;
+}
+
+void ums_scope_ring_arm(ums_scope_ring_t *ring)
+{
+    ring->head = 0;
+    ring->filled = 0;
+    ring->remaining = 0;
+    ring->drain_slot = 0;
+    ring->drain_left = 0;
+    ring->state = UMS_SCOPE_ARMED;
+}
+
+void ums_scope_ring_trigger(ums_scope_ring_t *ring)
+{
+    if (ring->state != UMS_SCOPE_ARMED)
+    {
+        return;
+    }
+    ring->remaining = ring->post_trigger;
+    ring->state = (ring->post_trigger == 0) ? UMS_SCOPE_FROZEN : UMS_SCOPE_TRIGGERED;
+}
+
+uint8_t* ums_scope_ring_reserve(ums_scope_ring_t *ring)
+{
+    if (ring->state != UMS_SCOPE_ARMED && ring->state != UMS_SCOPE_TRIGGERED)
+    {
+        return nullptr;
+    }
+    return ums_scope_ring_slot(ring, ring->head) + UMS_SCOPE_SLOT_HEADER;
+}
+
+bool ums_scope_ring_commit(ums_scope_ring_t *ring, const uint16_t length)
+{
+    memcpy(ums_scope_ring_slot(ring, ring->head), &length, sizeof(length));
+
+    ring->head = (ring->head + 1U == ring->slot_count) ? 0 : ring->head + 1U;
+    if (ring->filled < ring->slot_count)
+    {
+        ring->filled++;
+    }
+
+    if (ring->state == UMS_SCOPE_TRIGGERED && --ring->remaining == 0)
+    {
+        ring->state = UMS_SCOPE_FROZEN;
+        return true;
+    }
+    return false;
+}
+
+uint8_t* ums_scope_ring_next(ums_scope_ring_t *ring, uint16_t *length)
+{
+    if (ring->state == UMS_SCOPE_FROZEN)
+    {
+        ring->drain_slot = (ring->head + ring->slot_count - ring->filled) % ring->slot_count;
+        ring->drain_left = ring->filled;
+        ring->state = UMS_SCOPE_DRAINING;
+    }
+    if (ring->state != UMS_SCOPE_DRAINING)
+    {
+        return nullptr;
+    }
+    if (ring->drain_left == 0)
+    {
+        ring->state = UMS_SCOPE_DONE;
+        return nullptr;
+    }
+
+    uint8_t *slot = ums_scope_ring_slot(ring, ring->drain_slot);
+    memcpy(length, slot, sizeof(*length));
+    ring->drain_slot = (ring->drain_slot + 1U == ring->slot_count) ? 0 : ring->drain_slot + 1U;
+    ring->drain_left--;
+
+    return slot + UMS_SCOPE_SLOT_HEADER;
+}
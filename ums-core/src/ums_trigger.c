@@ -0,0 +1,195 @@
+//
+//
+//
+
+#include "math.h"
+#include "string.h"
+
+#include "ums/trigger.h"
+
+/**
+ * Loads a traced variable into its accumulator domain.
+ */
+static inline ums_aggregate_value_t ums_trigger_load(const uint8_t type, const void *src)
+{
+    ums_aggregate_value_t value;
+    switch (type)
+    {
+    case UMS_UINT8:
+    case UMS_BOOL:    value.u = *(const uint8_t*)src; break;
+    case UMS_UINT16:  { uint16_t v; memcpy(&v, src, sizeof(v)); value.u = v; break; }
+    case UMS_UINT32:  { uint32_t v; memcpy(&v, src, sizeof(v)); value.u = v; break; }
+    case UMS_UINT64:  memcpy(&value.u, src, sizeof(value.u)); break;
+    case UMS_INT8:    value.i = *(const int8_t*)src; break;
+    case UMS_INT16:   { int16_t v; memcpy(&v, src, sizeof(v)); value.i = v; break; }
+    case UMS_INT32:   { int32_t v; memcpy(&v, src, sizeof(v)); value.i = v; break; }
+    case UMS_INT64:   memcpy(&value.i, src, sizeof(value.i)); break;
+    case UMS_FLOAT32: { float v; memcpy(&v, src, sizeof(v)); value.f = v; break; }
+    default:          memcpy(&value.f, src, sizeof(value.f)); break;
+    }
+    return value;
+}
+
+/**
+ * Converts a finite threshold to the domain of a channel, clamped to the domain's range.
+ * The range checks are ordered so that only in-range values reach the integer casts.
+ */
+static ums_aggregate_value_t ums_trigger_threshold(const uint8_t domain, const double threshold)
+{
+    ums_aggregate_value_t value;
+    if (domain == UMS_AGGREGATE_FLOAT)
+    {
+        value.f = threshold;
+    }
+    else if (domain == UMS_AGGREGATE_SIGNED)
+    {
+        value.i = !(threshold > -9.2e18) ? INT64_MIN : !(threshold < 9.2e18) ? INT64_MAX : (int64_t)threshold;
+    }
+    else
+    {
+        value.u = !(threshold > 0.0) ? 0 : !(threshold < 1.8e19) ? UINT64_MAX : (uint64_t)threshold;
+    }
+    return value;
+}
+
+static bool ums_trigger_hit(const ums_trigger_op_t *op, const ums_aggregate_value_t value)
+{
+    bool above_low;
+    bool below_low;
+    bool prev_above_low;
+    bool prev_below_low;
+    bool above_high;
+    switch (op->domain)
+    {
+    case UMS_AGGREGATE_SIGNED:
+        above_low = value.i > op->low.i;
+        below_low = value.i < op->low.i;
+        prev_above_low = op->prev.i > op->low.i;
+        prev_below_low = op->prev.i < op->low.i;
+        above_high = value.i > op->high.i;
+        break;
+    case UMS_AGGREGATE_FLOAT:
+        above_low = value.f > op->low.f;
+        below_low = value.f < op->low.f;
+        prev_above_low = op->prev.f > op->low.f;
+        prev_below_low = op->prev.f < op->low.f;
+        above_high = value.f > op->high.f;
+        break;
+    default:
+        above_low = value.u > op->low.u;
+        below_low = value.u < op->low.u;
+        prev_above_low = op->prev.u > op->low.u;
+        prev_below_low = op->prev.u < op->low.u;
+        above_high = value.u > op->high.u;
+        break;
+    }
+
+    switch (op->kind)
+    {
+    case UMS_TRIGGER_ABOVE:   return above_low;
+    case UMS_TRIGGER_BELOW:   return below_low;
+    case UMS_TRIGGER_RISING:  return !prev_above_low && above_low;
+    case UMS_TRIGGER_FALLING: return !prev_below_low && below_low;
+    case UMS_TRIGGER_INSIDE:  return !below_low && !above_high;
+    default:                  return below_low || above_high;
+    }
+}
+
+ums_err_t ums_trigger_compile(ums_trigger_t *trigger, const ums_trigger_condition_t *conditions,
+                              const uint8_t condition_count, const data_channel_t *channels,
+                              const uint8_t channel_count, const uint16_t hold_off)
+{
+    if (!trigger || !conditions || !channels)
+    {
+        return UMS_NULL_POINTER;
+    }
+    if (condition_count == 0 || condition_count > UMS_TRIGGER_MAX_CONDITIONS)
+    {
+        return UMS_RANGE_ERROR;
+    }
+    for (uint8_t i = 0; i < condition_count; i++)
+    {
+        const ums_trigger_condition_t *condition = &conditions[i];
+        if (condition->channel >= channel_count)
+        {
+            return UMS_RANGE_ERROR;
+        }
+        if (condition->kind > UMS_TRIGGER_OUTSIDE || condition->combine > UMS_TRIGGER_OR)
+        {
+            return UMS_INVALID_PARAMETER;
+        }
+        if (!isfinite(condition->low) || !isfinite(condition->high))
+        {
+            return UMS_INVALID_PARAMETER;
+        }
+        // Block and struct channels have no single value to compare.
+        const data_channel_t *channel = &channels[condition->channel];
+        if (channel->var_type == UMS_STRUCT || channel->count > 1U)
+        {
+            return UMS_INVALID_PARAMETER;
+        }
+    }
+
+    for (uint8_t i = 0; i < condition_count; i++)
+    {
+        const ums_trigger_condition_t *condition = &conditions[i];
+        const data_channel_t *channel = &channels[condition->channel];
+        ums_trigger_op_t *op = &trigger->ops[i];
+
+        op->src_ptr = channel->var_ptr;
+        op->type = channel->var_type;
+        op->domain = ums_aggregate_domain(channel->var_type);
+        op->kind = condition->kind;
+        op->combine = condition->combine;
+        op->low = ums_trigger_threshold(op->domain, condition->low);
+        op->high = ums_trigger_threshold(op->domain, condition->high);
+        op->prev = ums_trigger_load(op->type, op->src_ptr);
+    }
+    trigger->op_count = condition_count;
+    trigger->hold_off = hold_off;
+    trigger->hold_left = 0;
+
+    return UMS_SUCCESS;
+}
+
+bool ums_trigger_evaluate(ums_trigger_t *trigger)
+{
+    bool result = false;
+    for (uint8_t i = 0; i < trigger->op_count; i++)
+    {
+        ums_trigger_op_t *op = &trigger->ops[i];
+        const ums_aggregate_value_t value = ums_trigger_load(op->type, op->src_ptr);
+        const bool hit = ums_trigger_hit(op, value);
+        op->prev = value;
+
+        // Every op is evaluated, edge conditions need their previous value even when short-circuited.
+        if (i == 0)
+        {
+            result = hit;
+        }
+        else if (op->combine == UMS_TRIGGER_OR)
+        {
+            result = result || hit;
+        }
+        else
+        {
+            result = result && hit;
+        }
+    }
+    return result;
+}
+
+bool ums_trigger_gate(ums_trigger_t *trigger)
+{
+    if (ums_trigger_evaluate(trigger))
+    {
+        trigger->hold_left = trigger->hold_off;
+        return true;
+    }
+    if (trigger->hold_left > 0)
+    {
+        trigger->hold_left--;
+        return true;
+    }
+    return false;
+}
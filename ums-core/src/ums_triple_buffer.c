@@ -0,0 +1,86 @@
+//
+//
+//
+
+#include "ums/triple_buffer.h"
+
+static inline uint32_t ums_triple_slot(const uint32_t state, const uint32_t shift)
+{
+    return (state >> shift) & UMS_TRIPLE_SLOT_MASK;
+}
+
+/**
+ * Returns state with the slots at shift_a and shift_b exchanged.
+ */
+static inline uint32_t ums_triple_swap(const uint32_t state, const uint32_t shift_a, const uint32_t shift_b)
+{
+    const uint32_t a = ums_triple_slot(state, shift_a);
+    const uint32_t b = ums_triple_slot(state, shift_b);
+    const uint32_t cleared = state & ~((UMS_TRIPLE_SLOT_MASK << shift_a) | (UMS_TRIPLE_SLOT_MASK << shift_b));
+    return cleared | (b << shift_a) | (a << shift_b);
+}
+
+void ums_triple_buffer_init(ums_triple_buffer_t *buffer)
+{
+    atomic_store(&buffer->state, (0U << UMS_TRIPLE_WRITE_SHIFT) | (1U << UMS_TRIPLE_MIDDLE_SHIFT)
+                                 | (2U << UMS_TRIPLE_TX_SHIFT));
+}
+
+sample_packet_t* ums_triple_buffer_write_slot(ums_triple_buffer_t *buffer)
+{
+    // Only the producer moves the write slot, a relaxed view of the other bits is fine.
+    return &buffer->slots[ums_triple_slot(atomic_load(&buffer->state), UMS_TRIPLE_WRITE_SHIFT)];
+}
+
+bool ums_triple_buffer_publish(ums_triple_buffer_t *buffer, const uint16_t length)
+{
+    uint32_t state = atomic_load(&buffer->state);
+    buffer->lengths[ums_triple_slot(state, UMS_TRIPLE_WRITE_SHIFT)] = length;
+
+    uint32_t next;
+    do
+    {
+        next = ums_triple_swap(state, UMS_TRIPLE_WRITE_SHIFT, UMS_TRIPLE_MIDDLE_SHIFT) | UMS_TRIPLE_FRESH;
+    } while (!atomic_compare_exchange_weak(&buffer->state, &state, next));
+
+    return (state & UMS_TRIPLE_FRESH) != 0;
+}
+
+sample_packet_t* ums_triple_buffer_claim(ums_triple_buffer_t *buffer, uint16_t *length)
+{
+    uint32_t state = atomic_load(&buffer->state);
+    uint32_t next;
+    do
+    {
+        if ((state & UMS_TRIPLE_BUSY) || !(state & UMS_TRIPLE_FRESH))
+        {
+            return nullptr;
+        }
+        next = (ums_triple_swap(state, UMS_TRIPLE_MIDDLE_SHIFT, UMS_TRIPLE_TX_SHIFT) & ~UMS_TRIPLE_FRESH)
+             | UMS_TRIPLE_BUSY;
+    } while (!atomic_compare_exchange_weak(&buffer->state, &state, next));
+
+    const uint32_t slot = ums_triple_slot(next, UMS_TRIPLE_TX_SHIFT);
+    *length = buffer->lengths[slot];
+    return &buffer->slots[slot];
+}
+
+bool ums_triple_buffer_reserve(ums_triple_buffer_t *buffer)
+{
+    return (atomic_fetch_or(&buffer->state, UMS_TRIPLE_BUSY) & UMS_TRIPLE_BUSY) == 0U;
+}
+
+void ums_triple_buffer_complete(ums_triple_buffer_t *buffer)
+{
+    atomic_fetch_and(&buffer->state, ~UMS_TRIPLE_BUSY);
+}
+
+bool ums_triple_buffer_busy(ums_triple_buffer_t *buffer)
+{
+    return (atomic_load(&buffer->state) & UMS_TRIPLE_BUSY) != 0U;
+}
+
+bool ums_triple_buffer_pending(ums_triple_buffer_t *buffer)
+{
+    return (atomic_load(&buffer->state) & UMS_TRIPLE_FRESH) != 0U;
+}
@@ -0,0 +1,64 @@
+#include "mock_platform.h"
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "ums/crc.h"
+#include "ums/ums_core.h"
+}
+
+uint32_t g_mock_timestamp = 0;
+bool g_mock_crc_unit = false;
+uint32_t g_mock_crc_calls = 0;
+uint32_t g_mock_cycles = 0;
+uint32_t g_mock_cycle_step = 0;
+MockTransmissionData g_mock_tx;
+
+// Overrides the weak default of ums-core for the whole test binary
+extern "C" uint32_t ums_platform_get_timestamp(void) {
+    return g_mock_timestamp;
+}
+
+extern "C" uint32_t ums_platform_get_cycles(void) {
+    const uint32_t cycles = g_mock_cycles;
+    g_mock_cycles += g_mock_cycle_step;
+    return cycles;
+}
+
+extern "C" bool ums_platform_crc(ums_crc_t crc, const uint8_t *data, uint16_t length, uint32_t *result) {
+    if (!g_mock_crc_unit || crc != UMS_CRC_32) {
+        return false;
+    }
+    g_mock_crc_calls++;
+    *result = ums_crc32(data, length);
+    return true;
+}
+
+void mock_transmit(void *data_ptr, uint16_t length) {
+    const uint8_t *bytes = static_cast<const uint8_t*>(data_ptr);
+    g_mock_tx.transfers.emplace_back(bytes, bytes + length);
+    g_mock_tx.stream.insert(g_mock_tx.stream.end(), bytes, bytes + length);
+    if (g_mock_tx.complete_immediately) {
+        ums_transfer_complete_callback();
+    } else {
+        g_mock_tx.in_flight = true;
+    }
+}
+
+void mock_gather(const ums_iovec_t *iov, uint8_t iov_count, uint16_t length) {
+    std::vector<uint8_t> frame;
+    for (uint8_t i = 0; i < iov_count; i++) {
+        const uint8_t *bytes = static_cast<const uint8_t*>(iov[i].base);
+        frame.insert(frame.end(), bytes, bytes + iov[i].length);
+    }
+    ASSERT_EQ(frame.size(), length);
+    g_mock_tx.iov_counts.push_back(iov_count);
+    mock_transmit(frame.data(), length);
+}
+
+void mock_drain() {
+    while (g_mock_tx.in_flight) {
+        g_mock_tx.in_flight = false;
+        ums_transfer_complete_callback();
+    }
+}
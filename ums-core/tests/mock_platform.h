@@ -0,0 +1,45 @@
+#ifndef UMS_TESTS_MOCK_PLATFORM_H
+#define UMS_TESTS_MOCK_PLATFORM_H
+
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include "ums/context.h"
+}
+
+// Value returned by ums_platform_get_timestamp() in the test binary, reset it in SetUp()
+extern uint32_t g_mock_timestamp;
+
+// Set to have ums_platform_crc() act as a CRC-32 unit, counting its calls. Off by default (software CRC).
+extern bool g_mock_crc_unit;
+extern uint32_t g_mock_crc_calls;
+
+// Value returned by ums_platform_get_cycles(), advanced by g_mock_cycle_step after every read. Step 0 by default.
+extern uint32_t g_mock_cycles;
+extern uint32_t g_mock_cycle_step;
+
+// Every transfer handed to mock_transmit() in order, plus the byte stream a host would see.
+// in_flight stays set until mock_drain() completes the transfer. With complete_immediately the transfer
+// completes within mock_transmit(), like a blocking transport. iov_counts holds the list length of every
+// transfer that came through mock_gather(). Reset it in SetUp().
+struct MockTransmissionData {
+    std::vector<std::vector<uint8_t>> transfers;
+    std::vector<uint8_t> stream;
+    std::vector<uint8_t> iov_counts;
+    bool in_flight = false;
+    bool complete_immediately = false;
+};
+
+extern MockTransmissionData g_mock_tx;
+
+// Recording transmit function for ums_setup()
+void mock_transmit(void *data_ptr, uint16_t length);
+
+// Recording gather function for ums_gather_setup(), records the flattened list as one transfer
+void mock_gather(const ums_iovec_t *iov, uint8_t iov_count, uint16_t length);
+
+// Completes transfers of the default context until the link is idle
+void mock_drain();
+
+#endif
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+
+#include "mock_platform.h"
+
+extern "C" {
+#include "ums/aggregate.h"
+#include "ums/ums_core.h"
+}
+
+template <typename T>
+static T result_of(const ums_aggregator_t &agg) {
+    T value;
+    memcpy(&value, agg.result, sizeof(value));
+    return value;
+}
+
+TEST(AggregatorTest, TracksMinMaxMeanOfSignedValues) {
+    int16_t value = 0;
+    ums_aggregator_t min_agg, max_agg, mean_agg;
+    ASSERT_EQ(ums_aggregator_init(&min_agg, &value, UMS_INT16, UMS_AGGREGATE_MIN), UMS_SUCCESS);
+    ASSERT_EQ(ums_aggregator_init(&max_agg, &value, UMS_INT16, UMS_AGGREGATE_MAX), UMS_SUCCESS);
+    ASSERT_EQ(ums_aggregator_init(&mean_agg, &value, UMS_INT16, UMS_AGGREGATE_MEAN), UMS_SUCCESS);
+
+    for (int16_t v : {-300, 5, 1200, -7}) {
+        value = v;
+        ums_aggregator_accumulate(&min_agg);
+        ums_aggregator_accumulate(&max_agg);
+        ums_aggregator_accumulate(&mean_agg);
+    }
+    ums_aggregator_finish(&min_agg);
+    ums_aggregator_finish(&max_agg);
+    ums_aggregator_finish(&mean_agg);
+
+    EXPECT_EQ(result_of<int16_t>(min_agg), -300);
+    EXPECT_EQ(result_of<int16_t>(max_agg), 1200);
+    EXPECT_EQ(result_of<int16_t>(mean_agg), 224);
+}
+
+TEST(AggregatorTest, WindowRestartsAfterFinish) {
+    float value = 10.0f;
+    ums_aggregator_t agg;
+    ASSERT_EQ(ums_aggregator_init(&agg, &value, UMS_FLOAT32, UMS_AGGREGATE_MAX), UMS_SUCCESS);
+
+    ums_aggregator_accumulate(&agg);
+    ums_aggregator_finish(&agg);
+    EXPECT_FLOAT_EQ(result_of<float>(agg), 10.0f);
+
+    value = 2.5f;
+    ums_aggregator_accumulate(&agg);
+    value = 1.0f;
+    ums_aggregator_accumulate(&agg);
+    ums_aggregator_finish(&agg);
+    EXPECT_FLOAT_EQ(result_of<float>(agg), 2.5f);
+
+    // Empty window reports the current value
+    ums_aggregator_finish(&agg);
+    EXPECT_FLOAT_EQ(result_of<float>(agg), 1.0f);
+}
+
+TEST(AggregatorTest, UnsignedMeanAndExtremes) {
+    uint32_t value = 0;
+    ums_aggregator_t mean_agg, min_agg;
+    ASSERT_EQ(ums_aggregator_init(&mean_agg, &value, UMS_UINT32, UMS_AGGREGATE_MEAN), UMS_SUCCESS);
+    ASSERT_EQ(ums_aggregator_init(&min_agg, &value, UMS_UINT32, UMS_AGGREGATE_MIN), UMS_SUCCESS);
+
+    for (uint32_t v : {UINT32_MAX, UINT32_MAX - 2}) {
+        value = v;
+        ums_aggregator_accumulate(&mean_agg);
+        ums_aggregator_accumulate(&min_agg);
+    }
+    ums_aggregator_finish(&mean_agg);
+    ums_aggregator_finish(&min_agg);
+    EXPECT_EQ(result_of<uint32_t>(mean_agg), UINT32_MAX - 1);
+    EXPECT_EQ(result_of<uint32_t>(min_agg), UINT32_MAX - 2);
+}
+
+TEST(AggregatorTest, RejectsInvalidArguments) {
+    uint8_t value = 0;
+    ums_aggregator_t agg;
+    EXPECT_EQ(ums_aggregator_init(nullptr, &value, UMS_UINT8, UMS_AGGREGATE_MIN), UMS_NULL_POINTER);
+    EXPECT_EQ(ums_aggregator_init(&agg, nullptr, UMS_UINT8, UMS_AGGREGATE_MIN), UMS_NULL_POINTER);
+    EXPECT_EQ(ums_aggregator_init(&agg, &value, UMS_STRING, UMS_AGGREGATE_MIN), UMS_INVALID_PARAMETER);
+    EXPECT_EQ(ums_aggregator_init(&agg, &value, UMS_UINT8, static_cast<ums_aggregate_t>(7)), UMS_INVALID_PARAMETER);
+}
+
+class AggregatedTraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        g_mock_tx.complete_immediately = true;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_destroy();
+    }
+};
+
+TEST_F(AggregatedTraceTest, DecimatedPeakIsNotLost) {
+    static float current = 0.0f;
+    static uint8_t mode = 0;
+    ASSERT_EQ(ums_trace(&mode, (char*)"mode", UMS_UINT8), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace_aggregated(&current, (char*)"current_max", UMS_FLOAT32, 4, UMS_AGGREGATE_MAX), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace_aggregated(&current, (char*)"current_min", UMS_FLOAT32, 4, UMS_AGGREGATE_MIN), UMS_SUCCESS);
+
+    const float trace[] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 9.0f, -3.0f, 1.0f, 1.0f};
+    for (float value : trace) {
+        current = value;
+        ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    }
+
+    // Slow group is due on ticks 0, 4 and 8: [mask][timestamp][mode][max][min]
+    const size_t slow_frame = 1 + sizeof(uint32_t) + 1 + 2 * sizeof(float);
+    ASSERT_EQ(g_mock_tx.transfers.size(), 9u);
+    ASSERT_EQ(g_mock_tx.transfers[8].size(), slow_frame);
+    float max, min;
+    memcpy(&max, &g_mock_tx.transfers[8][6], sizeof(max));
+    memcpy(&min, &g_mock_tx.transfers[8][10], sizeof(min));
+    EXPECT_FLOAT_EQ(max, 9.0f);
+    EXPECT_FLOAT_EQ(min, -3.0f);
+
+    // A plain decimated sample on tick 8 would only have seen 1.0
+    memcpy(&max, &g_mock_tx.transfers[4][6], sizeof(max));
+    EXPECT_FLOAT_EQ(max, 1.0f);
+}
+
+TEST_F(AggregatedTraceTest, GatedTicksRollIntoNextFrame) {
+    static float current = 0.0f;
+    static uint8_t armed = 0;
+    ASSERT_EQ(ums_trace(&armed, (char*)"armed", UMS_UINT8), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace_aggregated(&current, (char*)"current_max", UMS_FLOAT32, 1, UMS_AGGREGATE_MAX), UMS_SUCCESS);
+    const ums_trigger_condition_t condition{0, UMS_TRIGGER_ABOVE, UMS_TRIGGER_AND, 0.5, 0.0};
+    ASSERT_EQ(ums_trigger_setup(&condition, 1, 0), UMS_SUCCESS);
+
+    const uint8_t gate[] = {1, 0, 0, 1};
+    const float trace[] = {1.0f, 9.0f, 2.0f, 1.0f};
+    for (size_t i = 0; i < sizeof(trace) / sizeof(trace[0]); i++) {
+        armed = gate[i];
+        current = trace[i];
+        ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    }
+
+    // [timestamp][armed][max], the spike while the gate was closed is in the next frame
+    ASSERT_EQ(g_mock_tx.transfers.size(), 2u);
+    ASSERT_EQ(g_mock_tx.transfers[1].size(), sizeof(uint32_t) + 1 + sizeof(float));
+    float max;
+    memcpy(&max, &g_mock_tx.transfers[1][5], sizeof(max));
+    EXPECT_FLOAT_EQ(max, 9.0f);
+}
+
+TEST_F(AggregatedTraceTest, RejectsInvalidAggregate) {
+    static int32_t value = 0;
+    EXPECT_EQ(ums_trace_aggregated(&value, (char*)"value", UMS_INT32, 4, static_cast<ums_aggregate_t>(9)),
+              UMS_INVALID_PARAMETER);
+    EXPECT_EQ(ums_trace_aggregated(&value, (char*)"value", UMS_INT32, 0, UMS_AGGREGATE_MEAN), UMS_INVALID_PARAMETER);
+    EXPECT_EQ(ums_trace_aggregated(nullptr, (char*)"value", UMS_INT32, 4, UMS_AGGREGATE_MEAN),
+              UMS_INVALID_VARIABLE_REGISTRATION);
+}
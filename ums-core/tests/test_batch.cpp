@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+
+#include "mock_platform.h"
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+// Frame layout of these tests: [uint32 timestamp][float var1]
+static constexpr size_t kFrameSize = sizeof(uint32_t) + sizeof(float);
+
+static float frame_value(const std::vector<uint8_t> &transfer, size_t frame) {
+    float value;
+    memcpy(&value, &transfer[frame * kFrameSize + sizeof(uint32_t)], sizeof(value));
+    return value;
+}
+
+class BatchTest : public ::testing::Test {
+protected:
+    uint8_t buffer[2 * UMS_MAX_WIRE_FRAME_SIZE] = {};
+    float var1 = 0.0f;
+
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        g_mock_timestamp = 0;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_destroy();
+    }
+
+    void setup_batch(uint8_t frames_per_batch, uint32_t timeout) {
+        ASSERT_EQ(ums_batch_setup(buffer, sizeof(buffer), frames_per_batch, timeout), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&var1, (char*)"var1", UMS_FLOAT32), UMS_SUCCESS);
+    }
+};
+
+TEST_F(BatchTest, SetupRejectsInvalidParameters) {
+    EXPECT_EQ(ums_batch_setup(nullptr, sizeof(buffer), 4, 0), UMS_NULL_POINTER);
+    EXPECT_EQ(ums_batch_setup(buffer, UMS_MAX_WIRE_FRAME_SIZE, 4, 0), UMS_RANGE_ERROR);
+    EXPECT_EQ(ums_batch_setup(buffer, sizeof(buffer), 0, 0), UMS_RANGE_ERROR);
+}
+
+TEST_F(BatchTest, SetupNotCombinableWithQueue) {
+    sample_packet_t slots[2];
+    ASSERT_EQ(ums_queue_setup(slots, 2, UMS_DROP_NEWEST), UMS_SUCCESS);
+    EXPECT_EQ(ums_batch_setup(buffer, sizeof(buffer), 4, 0), UMS_INVALID_PARAMETER);
+}
+
+TEST_F(BatchTest, FullBatchIsSentInOneCall) {
+    setup_batch(3, 0);
+
+    for (int i = 1; i <= 3; i++) {
+        EXPECT_TRUE(g_mock_tx.transfers.empty());
+        var1 = static_cast<float>(i);
+        EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    }
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    ASSERT_EQ(g_mock_tx.transfers[0].size(), 3 * kFrameSize);
+    EXPECT_FLOAT_EQ(frame_value(g_mock_tx.transfers[0], 0), 1.0f);
+    EXPECT_FLOAT_EQ(frame_value(g_mock_tx.transfers[0], 1), 2.0f);
+    EXPECT_FLOAT_EQ(frame_value(g_mock_tx.transfers[0], 2), 3.0f);
+}
+
+TEST_F(BatchTest, NextBatchFillsWhileBusy) {
+    setup_batch(2, 0);
+
+    for (int i = 1; i <= 4; i++) {
+        var1 = static_cast<float>(i);
+        EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    }
+    // Second batch is sealed but waits for the link, no room for a third one
+    EXPECT_EQ(g_mock_tx.transfers.size(), 1u);
+    EXPECT_EQ(ums_update(), UMS_BUFFER_FULL);
+
+    ums_transfer_complete_callback();
+    ASSERT_EQ(g_mock_tx.transfers.size(), 2u);
+    EXPECT_FLOAT_EQ(frame_value(g_mock_tx.transfers[1], 0), 3.0f);
+    EXPECT_FLOAT_EQ(frame_value(g_mock_tx.transfers[1], 1), 4.0f);
+
+    ums_transfer_complete_callback();
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+}
+
+TEST_F(BatchTest, FlushSendsPartialBatch) {
+    setup_batch(8, 0);
+
+    var1 = 5.0f;
+    ums_update();
+    ums_update();
+    EXPECT_TRUE(g_mock_tx.transfers.empty());
+
+    EXPECT_EQ(ums_flush(), UMS_SUCCESS);
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    EXPECT_EQ(g_mock_tx.transfers[0].size(), 2 * kFrameSize);
+
+    // Nothing collected, nothing sent
+    ums_transfer_complete_callback();
+    EXPECT_EQ(ums_flush(), UMS_SUCCESS);
+    EXPECT_EQ(g_mock_tx.transfers.size(), 1u);
+}
+
+TEST_F(BatchTest, TimeoutSendsPartialBatch) {
+    setup_batch(8, 100);
+
+    g_mock_timestamp = 1000;
+    ums_update();
+    g_mock_timestamp = 1050;
+    ums_update();
+    EXPECT_TRUE(g_mock_tx.transfers.empty());
+
+    g_mock_timestamp = 1100;
+    ums_update();
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    EXPECT_EQ(g_mock_tx.transfers[0].size(), 3 * kFrameSize);
+}
+
+TEST_F(BatchTest, TimeoutSendsPartialBatchWithoutFurtherFrames) {
+    setup_batch(8, 100);
+    const ums_trigger_condition_t condition{0, UMS_TRIGGER_ABOVE, UMS_TRIGGER_AND, 0.0, 0.0};
+    ASSERT_EQ(ums_trigger_setup(&condition, 1, 0), UMS_SUCCESS);
+
+    var1 = 1.0f;
+    g_mock_timestamp = 1000;
+    ums_update();
+
+    // The gate closes, the updates pack no more frames
+    var1 = 0.0f;
+    g_mock_timestamp = 1050;
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    EXPECT_TRUE(g_mock_tx.transfers.empty());
+
+    g_mock_timestamp = 1100;
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    ASSERT_EQ(g_mock_tx.transfers[0].size(), kFrameSize);
+    EXPECT_FLOAT_EQ(frame_value(g_mock_tx.transfers[0], 0), 1.0f);
+}
+
+TEST_F(BatchTest, BatchStopsAtBufferCapacity) {
+    setup_batch(255, 0);
+
+    const size_t frames_per_half = UMS_MAX_WIRE_FRAME_SIZE / kFrameSize;
+    for (size_t i = 0; i < frames_per_half; i++) {
+        ums_update();
+    }
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    EXPECT_EQ(g_mock_tx.transfers[0].size(), frames_per_half * kFrameSize);
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+
+#include "mock_platform.h"
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+struct MotorState {
+    float speed;
+    uint8_t mode;
+    int32_t position;
+};
+
+static const ums_field_t kMotorFields[] = {
+    {"speed", offsetof(MotorState, speed), UMS_FLOAT32},
+    {"mode", offsetof(MotorState, mode), UMS_UINT8},
+    {"position", offsetof(MotorState, position), UMS_INT32},
+};
+
+class BlockTest : public ::testing::Test {
+protected:
+    float currents[12] = {};
+    MotorState motor = {};
+    uint16_t flags = 0;
+
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        g_mock_timestamp = 0;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_destroy();
+    }
+};
+
+TEST_F(BlockTest, ArrayIsOneChannelOnTheWire) {
+    for (int i = 0; i < 12; i++) {
+        currents[i] = static_cast<float>(i) * 0.5f;
+    }
+    ASSERT_EQ(ums_trace_block(currents, (char*)"i_phase", UMS_FLOAT32, 12), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace(&flags, (char*)"flags", UMS_UINT16), UMS_SUCCESS);
+
+    flags = 0xBEEF;
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    const std::vector<uint8_t> &frame = g_mock_tx.transfers[0];
+    ASSERT_EQ(frame.size(), sizeof(uint32_t) + sizeof(currents) + sizeof(flags));
+    EXPECT_EQ(memcmp(&frame[sizeof(uint32_t)], currents, sizeof(currents)), 0);
+    uint16_t flags_out;
+    memcpy(&flags_out, &frame[sizeof(uint32_t) + sizeof(currents)], sizeof(flags_out));
+    EXPECT_EQ(flags_out, 0xBEEF);
+}
+
+TEST_F(BlockTest, BlocksDoNotUseUpChannels) {
+    // 16 registry entries, far more than 16 values
+    static uint8_t bytes[UMS_MAX_CHANNELS][8];
+    for (auto &block : bytes) {
+        ASSERT_EQ(ums_trace_block(block, (char*)"bytes", UMS_UINT8, 8), UMS_SUCCESS);
+    }
+    EXPECT_EQ(ums_trace(&flags, (char*)"flags", UMS_UINT16), UMS_RANGE_ERROR);
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    EXPECT_EQ(g_mock_tx.transfers[0].size(), sizeof(uint32_t) + sizeof(bytes));
+}
+
+TEST_F(BlockTest, StructIsCopiedWithItsLayout) {
+    ASSERT_EQ(ums_trace_struct(&motor, (char*)"motor", kMotorFields, 3, sizeof(MotorState)), UMS_SUCCESS);
+
+    motor.speed = 1500.0f;
+    motor.mode = 3;
+    motor.position = -42;
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    const std::vector<uint8_t> &frame = g_mock_tx.transfers[0];
+    ASSERT_EQ(frame.size(), sizeof(uint32_t) + sizeof(MotorState));
+
+    MotorState out;
+    memcpy(&out, &frame[sizeof(uint32_t)], sizeof(out));
+    EXPECT_FLOAT_EQ(out.speed, 1500.0f);
+    EXPECT_EQ(out.mode, 3);
+    EXPECT_EQ(out.position, -42);
+}
+
+TEST_F(BlockTest, RejectsInvalidBlocks) {
+    EXPECT_EQ(ums_trace_block(currents, (char*)"i_phase", UMS_FLOAT32, 0), UMS_INVALID_PARAMETER);
+    EXPECT_EQ(ums_trace_block(currents, (char*)"i_phase", UMS_STRING, 12), UMS_INVALID_PARAMETER);
+    EXPECT_EQ(ums_trace_block(currents, (char*)"i_phase", UMS_FLOAT64, UMS_MAX_PAYLOAD_SIZE), UMS_RANGE_ERROR);
+    EXPECT_EQ(ums_trace_block(nullptr, (char*)"i_phase", UMS_FLOAT32, 12), UMS_INVALID_VARIABLE_REGISTRATION);
+
+    const ums_field_t outside[] = {{"position", sizeof(MotorState), UMS_INT32}};
+    const ums_field_t unnamed[] = {{nullptr, 0, UMS_FLOAT32}};
+    EXPECT_EQ(ums_trace_struct(&motor, (char*)"motor", nullptr, 1, sizeof(MotorState)), UMS_NULL_POINTER);
+    EXPECT_EQ(ums_trace_struct(&motor, (char*)"motor", kMotorFields, 0, sizeof(MotorState)), UMS_INVALID_PARAMETER);
+    EXPECT_EQ(ums_trace_struct(&motor, (char*)"motor", outside, 1, sizeof(MotorState)), UMS_RANGE_ERROR);
+    EXPECT_EQ(ums_trace_struct(&motor, (char*)"motor", unnamed, 1, sizeof(MotorState)), UMS_NULL_POINTER);
+}
+
+TEST_F(BlockTest, BlocksRequireRawEncoding) {
+    ASSERT_EQ(ums_trace_block(currents, (char*)"i_phase", UMS_FLOAT32, 12), UMS_SUCCESS);
+    EXPECT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_INVALID_PARAMETER);
+
+    ums_destroy();
+    ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_CHANGED, 0), UMS_SUCCESS);
+    EXPECT_EQ(ums_trace_struct(&motor, (char*)"motor", kMotorFields, 3, sizeof(MotorState)), UMS_INVALID_PARAMETER);
+}
+
+TEST_F(BlockTest, TriggerRejectsBlockChannels) {
+    ASSERT_EQ(ums_trace_block(currents, (char*)"i_phase", UMS_FLOAT32, 12), UMS_SUCCESS);
+    const ums_trigger_condition_t condition = {0, UMS_TRIGGER_ABOVE, UMS_TRIGGER_AND, 1.0, 0.0};
+    EXPECT_EQ(ums_trigger_setup(&condition, 1, 0), UMS_INVALID_PARAMETER);
+}
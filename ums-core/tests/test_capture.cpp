@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+
+#include "mock_platform.h"
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+// Frame layout of these tests: [uint32 timestamp][float var1]
+static float frame_value(const std::vector<uint8_t> &transfer) {
+    float value;
+    memcpy(&value, &transfer[sizeof(uint32_t)], sizeof(value));
+    return value;
+}
+
+class CaptureTest : public ::testing::Test {
+protected:
+    float var1 = 0.0f;
+
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        g_mock_timestamp = 0;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_destroy();
+    }
+
+    void trace() {
+        ASSERT_EQ(ums_trace(&var1, (char*)"var1", UMS_FLOAT32), UMS_SUCCESS);
+    }
+};
+
+TEST_F(CaptureTest, CaptureNeverTransmits) {
+    trace();
+
+    var1 = 1.0f;
+    EXPECT_EQ(ums_capture(), UMS_SUCCESS);
+    EXPECT_TRUE(g_mock_tx.transfers.empty());
+
+    EXPECT_EQ(ums_flush(), UMS_SUCCESS);
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    EXPECT_FLOAT_EQ(frame_value(g_mock_tx.transfers[0]), 1.0f);
+}
+
+TEST_F(CaptureTest, FlushSendsNewestCapture) {
+    trace();
+
+    for (float v : {1.0f, 2.0f, 3.0f}) {
+        var1 = v;
+        EXPECT_EQ(ums_capture(), UMS_SUCCESS);
+    }
+    EXPECT_EQ(ums_flush(), UMS_SUCCESS);
+    // Nothing new since the last flush
+    EXPECT_EQ(ums_flush(), UMS_SUCCESS);
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    EXPECT_FLOAT_EQ(frame_value(g_mock_tx.transfers[0]), 3.0f);
+}
+
+TEST_F(CaptureTest, FlushWaitsForIdleLink) {
+    trace();
+
+    var1 = 1.0f;
+    ums_capture();
+    ums_flush();
+
+    // Captures keep going while the first frame is on the wire
+    var1 = 2.0f;
+    EXPECT_EQ(ums_capture(), UMS_SUCCESS);
+    ums_flush();
+    EXPECT_EQ(g_mock_tx.transfers.size(), 1u);
+
+    ums_transfer_complete_callback();
+    ums_flush();
+    ASSERT_EQ(g_mock_tx.transfers.size(), 2u);
+    EXPECT_FLOAT_EQ(frame_value(g_mock_tx.transfers[1]), 2.0f);
+}
+
+TEST_F(CaptureTest, LatestValueIsSentOnCompletion) {
+    trace();
+
+    var1 = 1.0f;
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    // Published while the first frame is on the wire, only the newest survives
+    var1 = 2.0f;
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    var1 = 3.0f;
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    EXPECT_EQ(g_mock_tx.transfers.size(), 1u);
+
+    // The completion starts the next transfer without waiting for another update
+    ums_transfer_complete_callback();
+    ASSERT_EQ(g_mock_tx.transfers.size(), 2u);
+    EXPECT_FLOAT_EQ(frame_value(g_mock_tx.transfers[1]), 3.0f);
+
+    // Nothing fresh, link goes idle until the next update
+    ums_transfer_complete_callback();
+    EXPECT_EQ(g_mock_tx.transfers.size(), 2u);
+    var1 = 4.0f;
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    ASSERT_EQ(g_mock_tx.transfers.size(), 3u);
+    EXPECT_FLOAT_EQ(frame_value(g_mock_tx.transfers[2]), 4.0f);
+}
+
+TEST_F(CaptureTest, TripleBuffering) {
+    trace();
+
+    // First update - starts the transfer right away
+    var1 = 1.0f;
+    g_mock_timestamp = 1000;
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    EXPECT_FLOAT_EQ(frame_value(g_mock_tx.transfers[0]), 1.0f);
+
+    // Second update while transmitting - waits in the triple buffer
+    var1 = 2.0f;
+    g_mock_timestamp = 2500;
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    EXPECT_EQ(g_mock_tx.transfers.size(), 1u);
+
+    // Completing the transfer sends the second sample with its own timestamp
+    ums_transfer_complete_callback();
+    ASSERT_EQ(g_mock_tx.transfers.size(), 2u);
+    EXPECT_FLOAT_EQ(frame_value(g_mock_tx.transfers[1]), 2.0f);
+    uint32_t timestamp;
+    memcpy(&timestamp, g_mock_tx.transfers[1].data(), sizeof(timestamp));
+    EXPECT_EQ(timestamp, 2500u);
+}
+
+TEST_F(CaptureTest, EncodedUpdateKeepsPendingFrame) {
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_SUCCESS);
+    trace();
+
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    EXPECT_EQ(ums_update(), UMS_BUFFER_FULL);
+
+    ums_transfer_complete_callback();
+    EXPECT_EQ(g_mock_tx.transfers.size(), 2u);
+}
+
+TEST_F(CaptureTest, EncodedCaptureIsNotReplaced) {
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_SUCCESS);
+    trace();
+
+    EXPECT_EQ(ums_capture(), UMS_SUCCESS);
+    // The pending frame is the reference of the next delta, it must not be overwritten
+    EXPECT_EQ(ums_capture(), UMS_BUFFER_FULL);
+
+    ums_flush();
+    EXPECT_EQ(ums_capture(), UMS_SUCCESS);
+    EXPECT_EQ(g_mock_tx.transfers.size(), 1u);
+}
+
+TEST_F(CaptureTest, QueuedCapturesAreFlushedInOrder) {
+    sample_packet_t slots[4] = {};
+    ASSERT_EQ(ums_queue_setup(slots, 4, UMS_DROP_NEWEST), UMS_SUCCESS);
+    trace();
+
+    for (float v : {1.0f, 2.0f, 3.0f}) {
+        var1 = v;
+        EXPECT_EQ(ums_capture(), UMS_SUCCESS);
+    }
+    EXPECT_TRUE(g_mock_tx.transfers.empty());
+
+    ums_flush();
+    ums_transfer_complete_callback();
+    ums_transfer_complete_callback();
+    ASSERT_EQ(g_mock_tx.transfers.size(), 3u);
+    EXPECT_FLOAT_EQ(frame_value(g_mock_tx.transfers[0]), 1.0f);
+    EXPECT_FLOAT_EQ(frame_value(g_mock_tx.transfers[2]), 3.0f);
+}
+
+TEST_F(CaptureTest, SealedBatchWaitsForFlush) {
+    uint8_t buffer[2 * UMS_MAX_WIRE_FRAME_SIZE] = {};
+    ASSERT_EQ(ums_batch_setup(buffer, sizeof(buffer), 2, 0), UMS_SUCCESS);
+    trace();
+
+    EXPECT_EQ(ums_capture(), UMS_SUCCESS);
+    EXPECT_EQ(ums_capture(), UMS_SUCCESS);
+    EXPECT_TRUE(g_mock_tx.transfers.empty());
+
+    ums_flush();
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    EXPECT_EQ(g_mock_tx.transfers[0].size(), 2 * (sizeof(uint32_t) + sizeof(float)));
+}
+
+TEST_F(CaptureTest, CaptureRequiresSetup) {
+    ums_destroy();
+    EXPECT_EQ(ums_capture(), UMS_NOT_INITIALIZED);
+    EXPECT_EQ(ums_flush(), UMS_NOT_INITIALIZED);
+}
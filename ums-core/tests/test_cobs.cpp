@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include <cstring>
+
+#include "mock_platform.h"
+#include "ums/host/cobs.h"
+#include "ums/host/handshake.h"
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+using ums::host::DecodeStatus;
+using ums::host::Deframer;
+using ums::host::Handshake;
+using ums::host::Sample;
+
+static std::vector<uint8_t> stuff(const std::vector<uint8_t> &payload) {
+    std::vector<uint8_t> frame(payload.size() + UMS_COBS_OVERHEAD);
+    std::copy(payload.begin(), payload.end(), frame.begin() + 1);
+    frame.resize(ums_cobs_stuff(frame.data(), static_cast<uint16_t>(payload.size())));
+    return frame;
+}
+
+TEST(CobsTest, StuffInPlaceRoundTrips) {
+    std::vector<uint8_t> full_run(UMS_COBS_MAX_RUN);
+    for (size_t i = 0; i < full_run.size(); i++) {
+        full_run[i] = static_cast<uint8_t>(i % 255 + 1);
+    }
+    const std::vector<std::vector<uint8_t>> payloads = {
+        {0x11, 0x22, 0x33},
+        {0x00},
+        {0x00, 0x00, 0x00},
+        {0x00, 0x11, 0x00, 0x00, 0x22},
+        {0x11, 0x22, 0x00},
+        full_run,
+    };
+    for (const auto &payload : payloads) {
+        const std::vector<uint8_t> frame = stuff(payload);
+        ASSERT_EQ(frame.size(), payload.size() + UMS_COBS_OVERHEAD);
+        EXPECT_EQ(frame.back(), UMS_COBS_DELIMITER);
+        EXPECT_EQ(std::count(frame.begin(), frame.end() - 1, 0), 0);
+
+        std::vector<uint8_t> decoded;
+        ASSERT_TRUE(ums::host::cobs_decode(frame.data(), frame.size() - 1, decoded));
+        EXPECT_EQ(decoded, payload);
+    }
+}
+
+TEST(CobsTest, EncodeSplitsLongRunsAndWorksInPlace) {
+    std::vector<uint8_t> packet(600);
+    for (size_t i = 0; i < packet.size(); i++) {
+        // Runs of 300 non-zero bytes around a few zeros
+        packet[i] = (i == 5 || i == 310 || i == 311) ? 0 : static_cast<uint8_t>(i % 250 + 1);
+    }
+    const auto length = static_cast<uint16_t>(packet.size());
+
+    std::vector<uint8_t> encoded(packet.size() + UMS_COBS_MAX_OVERHEAD(packet.size()));
+    encoded.resize(ums_cobs_encode(packet.data(), length, encoded.data()));
+    EXPECT_EQ(std::count(encoded.begin(), encoded.end() - 1, 0), 0);
+
+    // In place, the packet lies behind the room for the overhead like the handshake does
+    const size_t room = UMS_COBS_MAX_OVERHEAD(packet.size());
+    std::vector<uint8_t> buffer(room + packet.size());
+    std::copy(packet.begin(), packet.end(), buffer.begin() + room);
+    buffer.resize(ums_cobs_encode(&buffer[room], length, buffer.data()));
+    EXPECT_EQ(buffer, encoded);
+
+    std::vector<uint8_t> decoded;
+    ASSERT_TRUE(ums::host::cobs_decode(encoded.data(), encoded.size() - 1, decoded));
+    EXPECT_EQ(decoded, packet);
+}
+
+TEST(CobsTest, FindDelimiterAtEveryPositionAndAlignment) {
+    std::vector<uint8_t> data(100, 0x5A);
+    EXPECT_EQ(ums::host::find_delimiter(data.data(), data.size()), data.size());
+    for (size_t zero = 0; zero < data.size(); zero++) {
+        data[zero] = 0;
+        for (size_t start = 0; start <= zero; start += 7) {
+            EXPECT_EQ(ums::host::find_delimiter(&data[start], data.size() - start), zero - start);
+        }
+        data[zero] = 0x5A;
+    }
+}
+
+TEST(CobsTest, DeframerCompletesFramesAcrossChunks) {
+    std::vector<uint8_t> stream;
+    const std::vector<std::vector<uint8_t>> payloads = {{1, 0, 2}, {0, 0}, {7, 8, 9, 10}};
+    for (const auto &payload : payloads) {
+        const auto frame = stuff(payload);
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+    stream.push_back(UMS_COBS_DELIMITER);   // empty frames are skipped
+
+    Deframer deframer;
+    std::vector<std::vector<uint8_t>> frames;
+    for (uint8_t byte : stream) {
+        for (size_t i = 0; i < deframer.feed(&byte, 1); i++) {
+            size_t length = 0;
+            const uint8_t *frame = deframer.frame(i, length);
+            frames.emplace_back(frame, frame + length);
+        }
+    }
+    EXPECT_EQ(frames, payloads);
+    EXPECT_EQ(deframer.stats().frames, payloads.size());
+    EXPECT_EQ(deframer.stats().errors, 0u);
+    EXPECT_EQ(deframer.pending(), 0u);
+}
+
+class CobsStreamTest : public ::testing::Test {
+protected:
+    uint32_t counter = 0;
+    int16_t zero = 0;
+
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        g_mock_timestamp = 0;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&counter, (char*)"counter", UMS_UINT32), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&zero, (char*)"zero", UMS_INT16), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_destroy();
+    }
+};
+
+TEST_F(CobsStreamTest, LostByteCostsOneFrame) {
+    ASSERT_EQ(ums_set_framing(UMS_FRAMING_COBS), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+    ums_transfer_complete_callback();
+    const size_t handshake_size = g_mock_tx.stream.size();
+    const size_t frame_size = sizeof(uint32_t) + sizeof(uint32_t) + sizeof(int16_t) + UMS_COBS_OVERHEAD;
+    for (int i = 0; i < 10; i++) {
+        g_mock_timestamp++;
+        counter = static_cast<uint32_t>(i) * 3u;
+        ASSERT_EQ(ums_update(), UMS_SUCCESS);
+        ums_transfer_complete_callback();
+    }
+    ASSERT_EQ(g_mock_tx.stream.size(), handshake_size + 10 * frame_size);
+    EXPECT_EQ(std::count(g_mock_tx.stream.begin(), g_mock_tx.stream.end(), 0), 11);
+
+    // Drop a byte in the middle of the fourth frame
+    std::vector<uint8_t> stream = g_mock_tx.stream;
+    stream.erase(stream.begin() + static_cast<long>(handshake_size + 3 * frame_size + 4));
+
+    Deframer deframer;
+    // The damaged frame is either malformed or decodes to the wrong length
+    const size_t frames = deframer.feed(stream.data(), stream.size());
+    EXPECT_EQ(frames + deframer.stats().errors, 11u);
+    size_t length = 0;
+    const uint8_t *packet = deframer.frame(0, length);
+    Handshake handshake;
+    ASSERT_EQ(ums::host::parse_handshake(packet, length, handshake).status, DecodeStatus::ok);
+    auto decoder = handshake.make_decoder();
+
+    std::vector<uint32_t> counters;
+    for (size_t i = 1; i < deframer.frame_count(); i++) {
+        const uint8_t *frame = deframer.frame(i, length);
+        Sample sample;
+        const auto result = decoder.decode(frame, length, sample);
+        if (result.status == DecodeStatus::ok && result.consumed == length) {
+            counters.push_back(static_cast<uint32_t>(decoder.value(sample, 0)));
+        }
+    }
+    EXPECT_EQ(counters, (std::vector<uint32_t>{0, 3, 6, 12, 15, 18, 21, 24, 27}));
+}
+
+TEST_F(CobsStreamTest, NotCombinableWithGather) {
+    ASSERT_EQ(ums_set_framing(UMS_FRAMING_COBS), UMS_SUCCESS);
+    EXPECT_EQ(ums_gather_setup(mock_gather), UMS_INVALID_PARAMETER);
+    ASSERT_EQ(ums_set_framing(UMS_FRAMING_NONE), UMS_SUCCESS);
+    ASSERT_EQ(ums_gather_setup(mock_gather), UMS_SUCCESS);
+    EXPECT_EQ(ums_set_framing(UMS_FRAMING_COBS), UMS_INVALID_PARAMETER);
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+
+#include "mock_platform.h"
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+// One transfer log per link
+static std::vector<std::vector<uint8_t>> g_uart1_tx;
+static std::vector<std::vector<uint8_t>> g_uart2_tx;
+
+static void mock_uart1_transmit(void *data_ptr, uint16_t length) {
+    const uint8_t *bytes = static_cast<const uint8_t*>(data_ptr);
+    g_uart1_tx.emplace_back(bytes, bytes + length);
+}
+
+static void mock_uart2_transmit(void *data_ptr, uint16_t length) {
+    const uint8_t *bytes = static_cast<const uint8_t*>(data_ptr);
+    g_uart2_tx.emplace_back(bytes, bytes + length);
+}
+
+class ContextTest : public ::testing::Test {
+protected:
+    ums_context_t ctx1;
+    ums_context_t ctx2;
+    float current = 0.0f;
+    uint16_t speed = 0;
+
+    void SetUp() override {
+        g_uart1_tx.clear();
+        g_uart2_tx.clear();
+        g_mock_timestamp = 0;
+        // Caller-owned contexts start with garbage
+        memset(&ctx1, 0xA5, sizeof(ctx1));
+        memset(&ctx2, 0xA5, sizeof(ctx2));
+        ctx1.initialized = false;
+        ctx2.initialized = false;
+        ASSERT_EQ(ums_ctx_setup(&ctx1, mock_uart1_transmit), UMS_SUCCESS);
+        ASSERT_EQ(ums_ctx_setup(&ctx2, mock_uart2_transmit), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_ctx_destroy(&ctx1);
+        ums_ctx_destroy(&ctx2);
+    }
+};
+
+TEST_F(ContextTest, ContextsStreamIndependently) {
+    ASSERT_EQ(ums_ctx_trace(&ctx1, &current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    ASSERT_EQ(ums_ctx_trace(&ctx2, &speed, (char*)"speed", UMS_UINT16), UMS_SUCCESS);
+
+    current = 1.5f;
+    speed = 1200;
+    EXPECT_EQ(ums_ctx_update(&ctx1), UMS_SUCCESS);
+    EXPECT_EQ(ums_ctx_update(&ctx2), UMS_SUCCESS);
+
+    ASSERT_EQ(g_uart1_tx.size(), 1u);
+    ASSERT_EQ(g_uart2_tx.size(), 1u);
+    ASSERT_EQ(g_uart1_tx[0].size(), sizeof(uint32_t) + sizeof(float));
+    ASSERT_EQ(g_uart2_tx[0].size(), sizeof(uint32_t) + sizeof(uint16_t));
+
+    float current_out;
+    uint16_t speed_out;
+    memcpy(&current_out, &g_uart1_tx[0][sizeof(uint32_t)], sizeof(current_out));
+    memcpy(&speed_out, &g_uart2_tx[0][sizeof(uint32_t)], sizeof(speed_out));
+    EXPECT_FLOAT_EQ(current_out, 1.5f);
+    EXPECT_EQ(speed_out, 1200);
+}
+
+TEST_F(ContextTest, BusyLinkOnlyHoldsBackItsOwnContext) {
+    ASSERT_EQ(ums_ctx_trace(&ctx1, &current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    ASSERT_EQ(ums_ctx_trace(&ctx2, &speed, (char*)"speed", UMS_UINT16), UMS_SUCCESS);
+
+    // ctx1's first transfer never completes, later samples wait in its triple buffer
+    EXPECT_EQ(ums_ctx_update(&ctx1), UMS_SUCCESS);
+    EXPECT_EQ(ums_ctx_update(&ctx1), UMS_SUCCESS);
+
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(ums_ctx_update(&ctx2), UMS_SUCCESS);
+        ums_ctx_transfer_complete_callback(&ctx2);
+    }
+    EXPECT_EQ(g_uart1_tx.size(), 1u);
+    EXPECT_EQ(g_uart2_tx.size(), 3u);
+}
+
+TEST_F(ContextTest, DefaultContextIsSeparate) {
+    ums_destroy();
+    ASSERT_EQ(ums_setup(mock_uart2_transmit), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace(&speed, (char*)"speed", UMS_UINT16), UMS_SUCCESS);
+    ASSERT_EQ(ums_ctx_trace(&ctx1, &current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    ASSERT_EQ(g_uart2_tx.size(), 1u);
+    EXPECT_EQ(g_uart2_tx[0].size(), sizeof(uint32_t) + sizeof(uint16_t));
+    EXPECT_TRUE(g_uart1_tx.empty());
+
+    EXPECT_EQ(ums_destroy(), UMS_SUCCESS);
+    EXPECT_EQ(ums_ctx_update(&ctx1), UMS_SUCCESS);
+    EXPECT_EQ(g_uart1_tx.size(), 1u);
+}
+
+TEST_F(ContextTest, DestroyedContextNeedsSetup) {
+    EXPECT_EQ(ums_ctx_destroy(&ctx1), UMS_SUCCESS);
+    EXPECT_EQ(ums_ctx_trace(&ctx1, &current, (char*)"current", UMS_FLOAT32), UMS_NOT_INITIALIZED);
+    EXPECT_EQ(ums_ctx_update(&ctx1), UMS_NOT_INITIALIZED);
+    EXPECT_EQ(ums_ctx_setup(nullptr, mock_uart1_transmit), UMS_NULL_POINTER);
+}
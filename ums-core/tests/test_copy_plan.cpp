@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <cstring>
+
+extern "C" {
+#include "ums/copy_plan.h"
+}
+
+TEST(CopyPlanTest, SeparateVariablesGetOneOpEach) {
+    ums_copy_plan_t plan;
+    ums_copy_plan_reset(&plan);
+
+    struct { uint16_t a; uint16_t pad0; uint32_t b; uint32_t pad1; uint8_t c; } vars = {};
+
+    EXPECT_EQ(ums_copy_plan_append(&plan, &vars.a, sizeof(vars.a)), UMS_SUCCESS);
+    EXPECT_EQ(ums_copy_plan_append(&plan, &vars.b, sizeof(vars.b)), UMS_SUCCESS);
+    EXPECT_EQ(ums_copy_plan_append(&plan, &vars.c, sizeof(vars.c)), UMS_SUCCESS);
+
+    EXPECT_EQ(plan.op_count, 3);
+    EXPECT_EQ(plan.payload_size, 7);
+    EXPECT_EQ(plan.ops[0].kind, UMS_COPY_16BIT);
+    EXPECT_EQ(plan.ops[1].kind, UMS_COPY_32BIT);
+    EXPECT_EQ(plan.ops[1].dst_offset, 2);
+    EXPECT_EQ(plan.ops[2].kind, UMS_COPY_8BIT);
+    EXPECT_EQ(plan.ops[2].dst_offset, 6);
+}
+
+TEST(CopyPlanTest, AdjacentVariablesAreMerged) {
+    ums_copy_plan_t plan;
+    ums_copy_plan_reset(&plan);
+
+    float currents[3] = {1.0f, 2.0f, 3.0f};
+    for (float &current : currents) {
+        EXPECT_EQ(ums_copy_plan_append(&plan, &current, sizeof(float)), UMS_SUCCESS);
+    }
+
+    EXPECT_EQ(plan.op_count, 1);
+    EXPECT_EQ(plan.ops[0].length, sizeof(currents));
+    EXPECT_EQ(plan.ops[0].kind, UMS_COPY_BLOCK);
+
+    uint8_t payload[sizeof(currents)] = {};
+    ums_copy_plan_execute(&plan, payload);
+    EXPECT_EQ(memcmp(payload, currents, sizeof(currents)), 0);
+}
+
+TEST(CopyPlanTest, MergedNativeWidthUsesFixedCopy) {
+    ums_copy_plan_t plan;
+    ums_copy_plan_reset(&plan);
+
+    uint16_t pair[2] = {0x1234, 0x5678};
+    ums_copy_plan_append(&plan, &pair[0], sizeof(uint16_t));
+    ums_copy_plan_append(&plan, &pair[1], sizeof(uint16_t));
+
+    EXPECT_EQ(plan.op_count, 1);
+    EXPECT_EQ(plan.ops[0].kind, UMS_COPY_32BIT);
+}
+
+TEST(CopyPlanTest, ExecuteCopiesCurrentValues) {
+    ums_copy_plan_t plan;
+    ums_copy_plan_reset(&plan);
+
+    double d = 1.25;
+    int16_t s = -3;
+    ums_copy_plan_append(&plan, &d, sizeof(d));
+    ums_copy_plan_append(&plan, &s, sizeof(s));
+
+    d = 7.5;
+    s = 42;
+    uint8_t payload[sizeof(double) + sizeof(int16_t)] = {};
+    ums_copy_plan_execute(&plan, payload);
+
+    double d_out;
+    int16_t s_out;
+    memcpy(&d_out, &payload[0], sizeof(d_out));
+    memcpy(&s_out, &payload[sizeof(double)], sizeof(s_out));
+    EXPECT_DOUBLE_EQ(d_out, 7.5);
+    EXPECT_EQ(s_out, 42);
+}
+
+TEST(CopyPlanTest, RejectsInvalidArguments) {
+    ums_copy_plan_t plan;
+    ums_copy_plan_reset(&plan);
+    uint8_t var = 0;
+
+    EXPECT_EQ(ums_copy_plan_append(nullptr, &var, 1), UMS_NULL_POINTER);
+    EXPECT_EQ(ums_copy_plan_append(&plan, nullptr, 1), UMS_NULL_POINTER);
+    EXPECT_EQ(ums_copy_plan_append(&plan, &var, 0), UMS_RANGE_ERROR);
+    EXPECT_EQ(ums_copy_plan_append(&plan, &var, UMS_MAX_PAYLOAD_SIZE + 1), UMS_RANGE_ERROR);
+    EXPECT_EQ(plan.op_count, 0);
+}
+
+TEST(CopyPlanTest, GroupsAreLaidOutBackToBack) {
+    ums_copy_plan_t plan;
+    ums_copy_plan_reset(&plan);
+
+    uint32_t fast = 0x11111111;
+    uint16_t slow = 0x2222;
+    uint8_t fast_flag = 0x33;
+    ums_copy_plan_append_group(&plan, 0, &fast, sizeof(fast));
+    ums_copy_plan_append_group(&plan, 1, &slow, sizeof(slow));
+    // Inserted in front of group 1, which moves back
+    ums_copy_plan_append_group(&plan, 0, &fast_flag, sizeof(fast_flag));
+
+    EXPECT_EQ(plan.op_count, 3);
+    EXPECT_EQ(plan.groups[0].op_count, 2);
+    EXPECT_EQ(plan.groups[0].payload_size, 5);
+    EXPECT_EQ(plan.groups[1].first_op, 2);
+    EXPECT_EQ(plan.groups[1].payload_offset, 5);
+    EXPECT_EQ(plan.ops[2].dst_offset, 5);
+
+    uint8_t payload[7] = {};
+    ums_copy_plan_execute(&plan, payload);
+    EXPECT_EQ(payload[4], 0x33);
+    EXPECT_EQ(payload[5], 0x22);
+
+    uint8_t block[2] = {};
+    ums_copy_plan_execute_group(&plan, 1, block);
+    EXPECT_EQ(block[0], 0x22);
+    EXPECT_EQ(block[1], 0x22);
+
+    EXPECT_EQ(ums_copy_plan_append_group(&plan, UMS_MAX_GROUPS, &slow, sizeof(slow)), UMS_INVALID_PARAMETER);
+}
@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+
+#include "mock_platform.h"
+#include "ums/host/cobs.h"
+#include "ums/host/crc.h"
+#include "ums/host/handshake.h"
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+using ums::host::DecodeStatus;
+using ums::host::FrameDecoder;
+using ums::host::Handshake;
+using ums::host::Sample;
+
+static const uint8_t kCheckInput[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+class CrcTest : public ::testing::Test {
+protected:
+    int32_t position = 0;
+    int16_t velocity = 0;
+
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        g_mock_timestamp = 0;
+        g_mock_crc_unit = false;
+        g_mock_crc_calls = 0;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&position, (char*)"position", UMS_INT32), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&velocity, (char*)"velocity", UMS_INT16), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        g_mock_crc_unit = false;
+        ums_destroy();
+    }
+
+    void run(int frames) {
+        for (int i = 0; i < frames; i++) {
+            g_mock_timestamp++;
+            position += 1000;
+            velocity = static_cast<int16_t>(-i);
+            ums_update();
+            mock_drain();
+        }
+    }
+
+    // Offset of frame i in the stream
+    size_t offset_of(size_t i) const {
+        size_t offset = 0;
+        for (size_t t = 0; t < i; t++) {
+            offset += g_mock_tx.transfers[t].size();
+        }
+        return offset;
+    }
+};
+
+TEST(CrcAlgorithmTest, MatchesCatalogueCheckValues) {
+    EXPECT_EQ(ums_crc16(kCheckInput, sizeof(kCheckInput)), 0x4B37);
+    EXPECT_EQ(ums_crc32(kCheckInput, sizeof(kCheckInput)), 0xCBF43926u);
+    EXPECT_EQ(ums_crc32(nullptr, 0), 0u);
+    EXPECT_EQ(ums_crc_size(UMS_CRC_NONE), 0);
+    EXPECT_EQ(ums_crc_size(UMS_CRC_16), 2);
+    EXPECT_EQ(ums_crc_size(UMS_CRC_32), 4);
+}
+
+TEST(CrcAlgorithmTest, HostMatchesDeviceAtEveryLength) {
+    std::vector<uint8_t> data(300);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<uint8_t>(i * 31u + 7u);
+    }
+    for (uint32_t length = 0; length <= data.size(); length++) {
+        ASSERT_EQ(ums::host::crc32(data.data(), length), ums_crc32(data.data(), length)) << length;
+        ASSERT_EQ(ums::host::crc16(data.data(), length), ums_crc16(data.data(), length)) << length;
+    }
+}
+
+TEST_F(CrcTest, TrailerFollowsEveryFrame) {
+    ASSERT_EQ(ums_set_crc(UMS_CRC_32), UMS_SUCCESS);
+    run(3);
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 3u);
+    const size_t frame_size = sizeof(uint32_t) + sizeof(int32_t) + sizeof(int16_t);
+    for (const auto &transfer : g_mock_tx.transfers) {
+        ASSERT_EQ(transfer.size(), frame_size + 4u);
+        uint32_t trailer;
+        memcpy(&trailer, &transfer[frame_size], sizeof(trailer));
+        EXPECT_EQ(trailer, ums_crc32(transfer.data(), frame_size));
+        EXPECT_TRUE(ums::host::check_crc(UMS_CRC_32, transfer.data(), transfer.size()));
+    }
+}
+
+TEST_F(CrcTest, PlatformHookReplacesSoftwareCrc) {
+    ASSERT_EQ(ums_set_crc(UMS_CRC_32), UMS_SUCCESS);
+    g_mock_crc_unit = true;
+    run(4);
+
+    EXPECT_EQ(g_mock_crc_calls, 4u);
+    for (const auto &transfer : g_mock_tx.transfers) {
+        EXPECT_TRUE(ums::host::check_crc(UMS_CRC_32, transfer.data(), transfer.size()));
+    }
+}
+
+TEST_F(CrcTest, CorruptFrameIsSkipped) {
+    ASSERT_EQ(ums_set_crc(UMS_CRC_16), UMS_SUCCESS);
+    run(5);
+
+    std::vector<uint8_t> stream = g_mock_tx.stream;
+    // A flipped bit in the position of frame 2
+    stream[offset_of(2) + sizeof(uint32_t)] ^= 0x10;
+
+    FrameDecoder decoder({UMS_INT32, UMS_INT16}, UMS_ENCODING_RAW);
+    ASSERT_TRUE(decoder.set_crc(UMS_CRC_16));
+    std::vector<Sample> samples;
+    EXPECT_EQ(decoder.decode_stream(stream.data(), stream.size(), samples), stream.size());
+
+    ASSERT_EQ(samples.size(), 4u);
+    EXPECT_EQ(samples[2].timestamp, 4u);
+    EXPECT_EQ(decoder.stats().crc_errors, 1u);
+    EXPECT_EQ(decoder.stats().errors, 1u);
+    EXPECT_EQ(decoder.stats().wire_bytes, 4u * g_mock_tx.transfers[0].size());
+}
+
+TEST_F(CrcTest, CorruptDeltaWaitsForKeyframe) {
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_crc(UMS_CRC_32), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_resync(4, 0), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+    mock_drain();
+    run(12);
+
+    std::vector<uint8_t> stream = g_mock_tx.stream;
+    // Last byte of the velocity delta of frame 1 (transfer 2): still a valid varint, but wrong
+    const size_t corrupt = offset_of(3) - 5u;
+    stream[corrupt] ^= 0x02;
+
+    Handshake handshake;
+    ASSERT_EQ(ums::host::parse_handshake(stream.data(), stream.size(), handshake).status, DecodeStatus::ok);
+    EXPECT_EQ(handshake.crc, UMS_CRC_32);
+    FrameDecoder decoder = handshake.make_decoder();
+    std::vector<Sample> samples;
+    decoder.decode_stream(stream.data() + handshake.length, stream.size() - handshake.length, samples);
+
+    // Frame 0, then frames 4..11 from the next marker on, none decoded against the corrupt frame
+    EXPECT_EQ(decoder.stats().crc_errors, 1u);
+    ASSERT_EQ(samples.size(), 9u);
+    EXPECT_EQ(samples[1].timestamp, 5u);
+    for (size_t i = 1; i < samples.size(); i++) {
+        EXPECT_DOUBLE_EQ(decoder.value(samples[i], 0), 1000.0 * samples[i].timestamp);
+        EXPECT_DOUBLE_EQ(decoder.value(samples[i], 1), 1.0 - samples[i].timestamp);
+    }
+}
+
+TEST_F(CrcTest, FrameCutInsideTrailerIsDecodedLater) {
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_crc(UMS_CRC_32), UMS_SUCCESS);
+    run(3);
+
+    FrameDecoder decoder({UMS_INT32, UMS_INT16}, UMS_ENCODING_DELTA);
+    decoder.set_crc(UMS_CRC_32);
+    const std::vector<uint8_t> &stream = g_mock_tx.stream;
+    Sample sample;
+    size_t offset = 0;
+    for (size_t i = 0; i < g_mock_tx.transfers.size(); i++) {
+        const size_t size = g_mock_tx.transfers[i].size();
+        EXPECT_EQ(decoder.decode(stream.data() + offset, size - 2u, sample).status, DecodeStatus::incomplete);
+        const auto result = decoder.decode(stream.data() + offset, size, sample);
+        ASSERT_EQ(result.status, DecodeStatus::ok);
+        EXPECT_EQ(result.consumed, size);
+        offset += size;
+    }
+    EXPECT_DOUBLE_EQ(decoder.value(sample, 0), 3000.0);
+    EXPECT_EQ(decoder.stats().keyframes, 1u);
+}
+
+TEST_F(CrcTest, HandshakeCarriesTrailer) {
+    ASSERT_EQ(ums_set_crc(UMS_CRC_16), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+    mock_drain();
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    std::vector<uint8_t> packet = g_mock_tx.transfers[0];
+    EXPECT_TRUE(ums::host::check_crc(UMS_CRC_16, packet.data(), packet.size()));
+
+    Handshake handshake;
+    ASSERT_EQ(ums::host::parse_handshake(packet.data(), packet.size(), handshake).status, DecodeStatus::ok);
+    EXPECT_EQ(handshake.length, packet.size());
+    EXPECT_EQ(ums::host::parse_handshake(packet.data(), packet.size() - 1u, handshake).status,
+              DecodeStatus::incomplete);
+
+    packet.back() ^= 0x01;
+    EXPECT_EQ(ums::host::parse_handshake(packet.data(), packet.size(), handshake).status, DecodeStatus::invalid);
+}
+
+TEST_F(CrcTest, CobsFramesAreCheckedAfterDeframing) {
+    ASSERT_EQ(ums_set_framing(UMS_FRAMING_COBS), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_crc(UMS_CRC_32), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+    mock_drain();
+    run(4);
+
+    ums::host::Deframer deframer;
+    ASSERT_EQ(deframer.feed(g_mock_tx.stream.data(), g_mock_tx.stream.size()), 5u);
+    size_t length = 0;
+    const uint8_t *packet = deframer.frame(0, length);
+    Handshake handshake;
+    ASSERT_EQ(ums::host::parse_handshake(packet, length, handshake).status, DecodeStatus::ok);
+    FrameDecoder decoder = handshake.make_decoder();
+    for (size_t i = 1; i < deframer.frame_count(); i++) {
+        const uint8_t *frame = deframer.frame(i, length);
+        Sample sample;
+        const auto result = decoder.decode(frame, length, sample);
+        ASSERT_EQ(result.status, DecodeStatus::ok);
+        EXPECT_EQ(result.consumed, length);
+        EXPECT_EQ(sample.timestamp, i);
+    }
+}
+
+TEST_F(CrcTest, RejectsUnsupportedCombinations) {
+    EXPECT_EQ(ums_set_crc(static_cast<ums_crc_t>(3)), UMS_INVALID_PARAMETER);
+
+    ASSERT_EQ(ums_gather_setup(mock_gather), UMS_SUCCESS);
+    EXPECT_EQ(ums_set_crc(UMS_CRC_16), UMS_INVALID_PARAMETER);
+    EXPECT_EQ(ums_set_crc(UMS_CRC_NONE), UMS_SUCCESS);
+}
+
+TEST_F(CrcTest, GatherRejectsCrcFramedContext) {
+    ASSERT_EQ(ums_set_crc(UMS_CRC_32), UMS_SUCCESS);
+    EXPECT_EQ(ums_gather_setup(mock_gather), UMS_INVALID_PARAMETER);
+}
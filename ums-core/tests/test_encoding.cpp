@@ -0,0 +1,265 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+
+#include "mock_platform.h"
+#include "ums/host/frame_decoder.h"
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+using ums::host::DecodeStatus;
+using ums::host::FrameDecoder;
+using ums::host::Sample;
+
+TEST(VarintTest, RoundTripsBoundaries) {
+    const uint64_t values[] = {0, 1, 127, 128, 16383, 16384, UINT32_MAX, UINT64_MAX};
+    for (uint64_t value : values) {
+        uint8_t buffer[UMS_VARINT_MAX_SIZE];
+        const uint8_t length = ums_varint_encode(value, buffer);
+        uint64_t decoded = 0;
+        EXPECT_EQ(ums_varint_decode(buffer, length, &decoded), length);
+        EXPECT_EQ(decoded, value);
+        // Truncated input is rejected
+        EXPECT_EQ(ums_varint_decode(buffer, length - 1, &decoded), 0);
+    }
+}
+
+TEST(VarintTest, ZigzagMapsSmallMagnitudesToSmallCodes) {
+    EXPECT_EQ(ums_zigzag_encode(0), 0u);
+    EXPECT_EQ(ums_zigzag_encode(-1), 1u);
+    EXPECT_EQ(ums_zigzag_encode(1), 2u);
+    EXPECT_EQ(ums_zigzag_decode(ums_zigzag_encode(INT64_MIN)), INT64_MIN);
+    EXPECT_EQ(ums_zigzag_decode(ums_zigzag_encode(INT64_MAX)), INT64_MAX);
+}
+
+TEST(DeltaEncoderTest, ResetDropsChannelsAndForcesKeyframe) {
+    static ums_delta_encoder_t encoder;
+    ums_delta_encoder_reset(&encoder);
+    ASSERT_EQ(ums_delta_encoder_add_channel(&encoder, UMS_INT32), UMS_SUCCESS);
+    memset(ums_delta_encoder_snapshot(&encoder), 0, sizeof(int32_t));
+    uint8_t frame[64];
+    ASSERT_GT(ums_delta_encode(&encoder, 1, frame), 0);
+    ASSERT_GT(ums_delta_encode(&encoder, 2, frame), 0);
+    EXPECT_EQ(frame[0] & UMS_FRAME_TAG_KEYFRAME, 0);
+
+    ums_delta_encoder_reset(&encoder);
+    EXPECT_EQ(encoder.channel_count, 0);
+    EXPECT_EQ(encoder.payload_size, 0);
+    EXPECT_EQ(encoder.max_frame_size, 1u + sizeof(uint32_t));
+    EXPECT_EQ(ums_delta_encode(&encoder, 3, frame), 1u + sizeof(uint32_t));
+    EXPECT_NE(frame[0] & UMS_FRAME_TAG_KEYFRAME, 0);
+}
+
+class DeltaEncodingTest : public ::testing::Test {
+protected:
+    float current = 0.0f;
+    uint8_t mode = 0;
+    int16_t position = 0;
+    uint64_t counter = 0;
+    double setpoint = 0.0;
+
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        g_mock_tx.complete_immediately = true;
+        g_mock_timestamp = 0;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&mode, (char*)"mode", UMS_UINT8), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&position, (char*)"position", UMS_INT16), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&counter, (char*)"counter", UMS_UINT64), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&setpoint, (char*)"setpoint", UMS_FLOAT64), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_destroy();
+    }
+
+    FrameDecoder make_decoder(ums_encoding_t encoding) {
+        return FrameDecoder({UMS_FLOAT32, UMS_UINT8, UMS_INT16, UMS_UINT64, UMS_FLOAT64}, encoding);
+    }
+
+    void step(int i) {
+        g_mock_timestamp += 100;
+        current = 1.5f + 0.001f * static_cast<float>(i);
+        mode = static_cast<uint8_t>(i / 10);
+        position = static_cast<int16_t>(i % 2 == 0 ? i : -i);
+        counter += 3;
+        setpoint = (i < 25) ? 10.0 : 12.5;
+        ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    }
+};
+
+TEST_F(DeltaEncodingTest, SetEncodingRequiresInitialization) {
+    ums_destroy();
+    EXPECT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_NOT_INITIALIZED);
+}
+
+TEST_F(DeltaEncodingTest, RejectsUnknownEncoding) {
+    EXPECT_EQ(ums_set_encoding(static_cast<ums_encoding_t>(7), 0), UMS_INVALID_PARAMETER);
+}
+
+TEST_F(DeltaEncodingTest, RejectsDropOldestQueue) {
+    sample_packet_t slots[2];
+    ASSERT_EQ(ums_queue_setup(slots, 2, UMS_DROP_OLDEST), UMS_SUCCESS);
+    EXPECT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_INVALID_PARAMETER);
+}
+
+TEST_F(DeltaEncodingTest, RoundTripsAllCodecs) {
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_SUCCESS);
+
+    std::vector<std::vector<double>> expected;
+    for (int i = 0; i < 50; i++) {
+        step(i);
+        expected.push_back({current, static_cast<double>(mode), static_cast<double>(position),
+                            static_cast<double>(counter), setpoint});
+    }
+
+    FrameDecoder decoder = make_decoder(UMS_ENCODING_DELTA);
+    std::vector<Sample> samples;
+    EXPECT_EQ(decoder.decode_stream(g_mock_tx.stream.data(), g_mock_tx.stream.size(), samples), g_mock_tx.stream.size());
+    ASSERT_EQ(samples.size(), expected.size());
+
+    for (size_t i = 0; i < samples.size(); i++) {
+        EXPECT_EQ(samples[i].timestamp, 100u * (i + 1));
+        for (size_t channel = 0; channel < expected[i].size(); channel++) {
+            EXPECT_DOUBLE_EQ(decoder.value(samples[i], channel), expected[i][channel]) << "frame " << i;
+        }
+    }
+    EXPECT_EQ(decoder.stats().keyframes, 1u);
+    EXPECT_GT(decoder.stats().compression_ratio(), 1.5);
+}
+
+TEST_F(DeltaEncodingTest, UnchangedValuesCostOneBytePerChannel) {
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_SUCCESS);
+
+    ums_update();
+    ums_update();
+    ASSERT_EQ(g_mock_tx.transfers.size(), 2u);
+    EXPECT_EQ(g_mock_tx.transfers[0].size(), 1u + 4u + 4u + 1u + 2u + 8u + 8u);
+    // tag + timestamp delta + one zero varint per channel
+    EXPECT_EQ(g_mock_tx.transfers[1].size(), 1u + 1u + 5u);
+}
+
+TEST_F(DeltaEncodingTest, PeriodicKeyframesAllowLateJoin) {
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 10), UMS_SUCCESS);
+
+    size_t late_join_offset = 0;
+    for (int i = 0; i < 30; i++) {
+        if (i == 3) {
+            late_join_offset = g_mock_tx.stream.size();
+        }
+        step(i);
+    }
+
+    // A host that attaches mid-stream skips delta frames until the next keyframe
+    FrameDecoder decoder = make_decoder(UMS_ENCODING_DELTA);
+    std::vector<Sample> samples;
+    decoder.decode_stream(&g_mock_tx.stream[late_join_offset], g_mock_tx.stream.size() - late_join_offset, samples);
+    ASSERT_EQ(samples.size(), 20u);
+    EXPECT_EQ(samples.front().timestamp, 1100u);
+    EXPECT_EQ(samples.back().timestamp, 3000u);
+    EXPECT_EQ(decoder.stats().keyframes, 2u);
+}
+
+TEST_F(DeltaEncodingTest, RawDecoderMatchesDefaultEncoding) {
+    step(1);
+    step(2);
+
+    FrameDecoder decoder = make_decoder(UMS_ENCODING_RAW);
+    std::vector<Sample> samples;
+    decoder.decode_stream(g_mock_tx.stream.data(), g_mock_tx.stream.size(), samples);
+    ASSERT_EQ(samples.size(), 2u);
+    EXPECT_EQ(samples[1].timestamp, 200u);
+    EXPECT_FLOAT_EQ(static_cast<float>(decoder.value(samples[1], 0)), 1.502f);
+    EXPECT_EQ(decoder.value(samples[1], 2), 2.0);
+    EXPECT_DOUBLE_EQ(decoder.stats().compression_ratio(), 1.0);
+}
+
+TEST_F(DeltaEncodingTest, DeltaFramesWorkWithBatching) {
+    ums_destroy();
+    // All eight frames go out in one batch, which is never completed
+    g_mock_tx.complete_immediately = false;
+    ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+    uint8_t buffer[4 * UMS_MAX_WIRE_FRAME_SIZE];
+    ASSERT_EQ(ums_batch_setup(buffer, sizeof(buffer), 8, 0), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace(&current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_SUCCESS);
+
+    for (int i = 0; i < 8; i++) {
+        current = static_cast<float>(i);
+        ums_update();
+    }
+
+    FrameDecoder decoder({UMS_FLOAT32}, UMS_ENCODING_DELTA);
+    std::vector<Sample> samples;
+    EXPECT_EQ(decoder.decode_stream(g_mock_tx.stream.data(), g_mock_tx.stream.size(), samples), g_mock_tx.stream.size());
+    ASSERT_EQ(samples.size(), 8u);
+    EXPECT_EQ(decoder.value(samples[7], 0), 7.0);
+}
+
+TEST_F(DeltaEncodingTest, ChangedFramesCarryOnlyChangedChannels) {
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_CHANGED, 0), UMS_SUCCESS);
+
+    ums_update();
+    ums_update();
+    mode = 3;
+    ums_update();
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 3u);
+    EXPECT_EQ(g_mock_tx.transfers[0].size(), 4u + UMS_PRESENCE_BITMAP_SIZE + 4u + 1u + 2u + 8u + 8u);
+    EXPECT_EQ(g_mock_tx.transfers[1].size(), 4u + UMS_PRESENCE_BITMAP_SIZE);
+    EXPECT_EQ(g_mock_tx.transfers[2].size(), 4u + UMS_PRESENCE_BITMAP_SIZE + 1u);
+
+    // Bitmap of the third frame only has channel 1 (mode) set
+    const size_t third = g_mock_tx.transfers[0].size() + g_mock_tx.transfers[1].size();
+    EXPECT_EQ(g_mock_tx.stream[third + 4], 0x02);
+    EXPECT_EQ(g_mock_tx.stream[third + 5], 0x00);
+    EXPECT_EQ(g_mock_tx.stream[third + 6], 3);
+}
+
+TEST_F(DeltaEncodingTest, ChangedFramesRoundTrip) {
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_CHANGED, 16), UMS_SUCCESS);
+
+    std::vector<std::vector<double>> expected;
+    for (int i = 0; i < 50; i++) {
+        step(i);
+        expected.push_back({current, static_cast<double>(mode), static_cast<double>(position),
+                            static_cast<double>(counter), setpoint});
+    }
+
+    FrameDecoder decoder = make_decoder(UMS_ENCODING_CHANGED);
+    std::vector<Sample> samples;
+    EXPECT_EQ(decoder.decode_stream(g_mock_tx.stream.data(), g_mock_tx.stream.size(), samples), g_mock_tx.stream.size());
+    ASSERT_EQ(samples.size(), expected.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        EXPECT_EQ(samples[i].timestamp, 100u * (i + 1));
+        for (size_t channel = 0; channel < expected[i].size(); channel++) {
+            EXPECT_DOUBLE_EQ(decoder.value(samples[i], channel), expected[i][channel]) << "frame " << i;
+        }
+    }
+    EXPECT_EQ(decoder.stats().keyframes, 4u);
+}
+
+TEST_F(DeltaEncodingTest, ChangedDecoderWaitsUntilEveryChannelIsKnown) {
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_CHANGED, 0), UMS_SUCCESS);
+
+    ums_update();
+    const size_t late_join_offset = g_mock_tx.stream.size();
+    current = 2.0f;
+    ums_update();
+    mode = 1;
+    position = 5;
+    counter = 9;
+    setpoint = 1.0;
+    ums_update();
+
+    FrameDecoder decoder = make_decoder(UMS_ENCODING_CHANGED);
+    std::vector<Sample> samples;
+    decoder.decode_stream(&g_mock_tx.stream[late_join_offset], g_mock_tx.stream.size() - late_join_offset, samples);
+    ASSERT_EQ(samples.size(), 1u);
+    EXPECT_EQ(decoder.value(samples[0], 0), 2.0);
+    EXPECT_EQ(decoder.value(samples[0], 4), 1.0);
+}
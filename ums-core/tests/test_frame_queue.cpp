@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+
+#include "mock_platform.h"
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+// Frame layout of these tests: [uint32 timestamp][float var1], returns var1 of every transfer
+static std::vector<float> sent_values() {
+    std::vector<float> values;
+    for (const auto &transfer : g_mock_tx.transfers) {
+        EXPECT_EQ(transfer.size(), sizeof(uint32_t) + sizeof(float));
+        float value;
+        memcpy(&value, &transfer[sizeof(uint32_t)], sizeof(value));
+        values.push_back(value);
+    }
+    return values;
+}
+
+class FrameQueueTest : public ::testing::Test {
+protected:
+    sample_packet_t slots[3] = {};
+    float var1 = 0.0f;
+
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_destroy();
+    }
+
+    void setup_queue(ums_overflow_policy_t policy) {
+        ASSERT_EQ(ums_queue_setup(slots, 3, policy), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&var1, (char*)"var1", UMS_FLOAT32), UMS_SUCCESS);
+    }
+};
+
+TEST_F(FrameQueueTest, SetupRequiresInitialization) {
+    ums_destroy();
+    EXPECT_EQ(ums_queue_setup(slots, 3, UMS_DROP_NEWEST), UMS_NOT_INITIALIZED);
+}
+
+TEST_F(FrameQueueTest, SetupRejectsInvalidParameters) {
+    EXPECT_EQ(ums_queue_setup(nullptr, 3, UMS_DROP_NEWEST), UMS_NULL_POINTER);
+    EXPECT_EQ(ums_queue_setup(slots, 1, UMS_DROP_NEWEST), UMS_RANGE_ERROR);
+    EXPECT_EQ(ums_queue_setup(slots, UMS_FRAME_QUEUE_MAX_SLOTS + 1, UMS_DROP_NEWEST), UMS_RANGE_ERROR);
+
+    ums_queue_stats_t stats;
+    EXPECT_EQ(ums_queue_get_stats(&stats), UMS_NOT_INITIALIZED);
+}
+
+TEST_F(FrameQueueTest, SamplesTakenWhileBusyAreQueued) {
+    setup_queue(UMS_DROP_NEWEST);
+
+    var1 = 1.0f;
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    var1 = 2.0f;
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    var1 = 3.0f;
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    EXPECT_EQ(g_mock_tx.transfers.size(), 1u);
+
+    // Each completion kicks the next pending frame in order
+    ums_transfer_complete_callback();
+    ums_transfer_complete_callback();
+    EXPECT_EQ(sent_values(), (std::vector<float>{1.0f, 2.0f, 3.0f}));
+
+    // Nothing pending, link goes idle
+    ums_transfer_complete_callback();
+    EXPECT_EQ(g_mock_tx.transfers.size(), 3u);
+
+    var1 = 4.0f;
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    EXPECT_EQ(g_mock_tx.transfers.size(), 4u);
+    EXPECT_FLOAT_EQ(sent_values().back(), 4.0f);
+}
+
+TEST_F(FrameQueueTest, DropNewestRejectsSampleWhenFull) {
+    setup_queue(UMS_DROP_NEWEST);
+
+    for (int i = 1; i <= 3; i++) {
+        var1 = static_cast<float>(i);
+        EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    }
+    var1 = 4.0f;
+    EXPECT_EQ(ums_update(), UMS_BUFFER_FULL);
+
+    ums_transfer_complete_callback();
+    ums_transfer_complete_callback();
+    ums_transfer_complete_callback();
+    EXPECT_EQ(sent_values(), (std::vector<float>{1.0f, 2.0f, 3.0f}));
+
+    ums_queue_stats_t stats;
+    ASSERT_EQ(ums_queue_get_stats(&stats), UMS_SUCCESS);
+    EXPECT_EQ(stats.captured, 3u);
+    EXPECT_EQ(stats.transmitted, 3u);
+    EXPECT_EQ(stats.dropped, 1u);
+    EXPECT_EQ(stats.high_water, 2);
+}
+
+TEST_F(FrameQueueTest, DropOldestKeepsLatestSamples) {
+    setup_queue(UMS_DROP_OLDEST);
+
+    for (int i = 1; i <= 5; i++) {
+        var1 = static_cast<float>(i);
+        EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    }
+
+    ums_transfer_complete_callback();
+    ums_transfer_complete_callback();
+    ums_transfer_complete_callback();
+    // Frame 1 was already in transmission, 2 and 3 were overwritten
+    EXPECT_EQ(sent_values(), (std::vector<float>{1.0f, 4.0f, 5.0f}));
+
+    ums_queue_stats_t stats;
+    ASSERT_EQ(ums_queue_get_stats(&stats), UMS_SUCCESS);
+    EXPECT_EQ(stats.captured, 5u);
+    EXPECT_EQ(stats.transmitted, 3u);
+    EXPECT_EQ(stats.dropped, 2u);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+
+#include "mock_platform.h"
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+class GatherTest : public ::testing::Test {
+protected:
+    float currents[3] = {1.0f, 2.0f, 3.0f};
+    uint32_t pad = 0;  // keeps speed from being coalesced with the currents
+    uint16_t speed = 0x1234;
+
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        g_mock_timestamp = 0;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_destroy();
+    }
+};
+
+TEST_F(GatherTest, GatheredFrameMatchesRawLayout) {
+    ASSERT_EQ(ums_gather_setup(mock_gather), UMS_SUCCESS);
+    for (float &current : currents) {
+        ASSERT_EQ(ums_trace(&current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    }
+    ASSERT_EQ(ums_trace(&speed, (char*)"speed", UMS_UINT16), UMS_SUCCESS);
+
+    g_mock_timestamp = 0xAABBCCDD;
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+
+    // Sent through the list only, as timestamp, the three adjacent currents as one element, speed
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    EXPECT_EQ(g_mock_tx.iov_counts, (std::vector<uint8_t>{3}));
+
+    std::vector<uint8_t> expected(sizeof(uint32_t) + sizeof(currents) + sizeof(speed));
+    memcpy(&expected[0], &g_mock_timestamp, sizeof(uint32_t));
+    memcpy(&expected[sizeof(uint32_t)], currents, sizeof(currents));
+    memcpy(&expected[sizeof(uint32_t) + sizeof(currents)], &speed, sizeof(speed));
+    EXPECT_EQ(g_mock_tx.transfers[0], expected);
+}
+
+TEST_F(GatherTest, SamplesWhileBusyAreDropped) {
+    ASSERT_EQ(ums_gather_setup(mock_gather), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace(&speed, (char*)"speed", UMS_UINT16), UMS_SUCCESS);
+
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    EXPECT_EQ(ums_update(), UMS_BUFFER_FULL);
+    EXPECT_EQ(g_mock_tx.transfers.size(), 1u);
+
+    ums_transfer_complete_callback();
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    EXPECT_EQ(g_mock_tx.transfers.size(), 2u);
+}
+
+TEST_F(GatherTest, ListIsNotRewrittenWhileBusy) {
+    ASSERT_EQ(ums_gather_setup(mock_gather), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace(&speed, (char*)"speed", UMS_UINT16), UMS_SUCCESS);
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+
+    // The transport still walks the list handed over by the update
+    EXPECT_EQ(ums_trace(&currents[0], (char*)"current", UMS_FLOAT32), UMS_BUFFER_FULL);
+    EXPECT_EQ(ums_set_sequence(1), UMS_BUFFER_FULL);
+    EXPECT_EQ(ums_set_sequence(0), UMS_SUCCESS);
+
+    ums_transfer_complete_callback();
+    EXPECT_EQ(ums_trace(&currents[0], (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    EXPECT_EQ(ums_set_sequence(1), UMS_SUCCESS);
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    ASSERT_EQ(g_mock_tx.transfers.size(), 2u);
+    EXPECT_EQ(g_mock_tx.transfers[1].size(), 1 + sizeof(uint32_t) + sizeof(uint16_t) + sizeof(float));
+}
+
+TEST_F(GatherTest, CaptureIsSentOnFlush) {
+    ASSERT_EQ(ums_gather_setup(mock_gather), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace(&speed, (char*)"speed", UMS_UINT16), UMS_SUCCESS);
+
+    EXPECT_EQ(ums_capture(), UMS_SUCCESS);
+    EXPECT_TRUE(g_mock_tx.transfers.empty());
+    EXPECT_EQ(ums_flush(), UMS_SUCCESS);
+    EXPECT_EQ(g_mock_tx.transfers.size(), 1u);
+}
+
+TEST_F(GatherTest, SetupRejectsIncompatibleModes) {
+    EXPECT_EQ(ums_gather_setup(nullptr), UMS_NULL_POINTER);
+
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_SUCCESS);
+    EXPECT_EQ(ums_gather_setup(mock_gather), UMS_INVALID_PARAMETER);
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_RAW, 0), UMS_SUCCESS);
+
+    ASSERT_EQ(ums_gather_setup(mock_gather), UMS_SUCCESS);
+    EXPECT_EQ(ums_set_encoding(UMS_ENCODING_CHANGED, 0), UMS_INVALID_PARAMETER);
+    EXPECT_EQ(ums_trace_divided(&speed, (char*)"speed", UMS_UINT16, 4), UMS_INVALID_PARAMETER);
+
+    sample_packet_t slots[2];
+    EXPECT_EQ(ums_queue_setup(slots, 2, UMS_DROP_NEWEST), UMS_INVALID_PARAMETER);
+}
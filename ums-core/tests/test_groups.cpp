@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+
+#include "mock_platform.h"
+#include "ums/host/frame_decoder.h"
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+using ums::host::DecodeStatus;
+using ums::host::FrameDecoder;
+using ums::host::Sample;
+
+class SampleGroupTest : public ::testing::Test {
+protected:
+    float current = 0.0f;
+    int16_t speed = 0;
+    float temperature = 0.0f;
+
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        g_mock_tx.complete_immediately = true;
+        g_mock_timestamp = 0;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_destroy();
+    }
+};
+
+TEST_F(SampleGroupTest, DividerOneBehavesLikeTrace) {
+    ASSERT_EQ(ums_trace_divided(&current, (char*)"current", UMS_FLOAT32, 1), UMS_SUCCESS);
+    ASSERT_EQ(ums_update(), UMS_SUCCESS);
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    EXPECT_EQ(g_mock_tx.transfers[0].size(), sizeof(uint32_t) + sizeof(float));
+}
+
+TEST_F(SampleGroupTest, RejectsInvalidDividers) {
+    EXPECT_EQ(ums_trace_divided(&current, (char*)"current", UMS_FLOAT32, 0), UMS_INVALID_PARAMETER);
+
+    static uint8_t vars[UMS_MAX_GROUPS];
+    for (uint16_t g = 1; g < UMS_MAX_GROUPS; g++) {
+        EXPECT_EQ(ums_trace_divided(&vars[g], (char*)"v", UMS_UINT8, g + 1), UMS_SUCCESS);
+    }
+    // All groups in use, a new divider does not fit but an existing one does
+    EXPECT_EQ(ums_trace_divided(&vars[0], (char*)"v", UMS_UINT8, 100), UMS_RANGE_ERROR);
+    EXPECT_EQ(ums_trace_divided(&vars[0], (char*)"v", UMS_UINT8, 2), UMS_SUCCESS);
+}
+
+TEST_F(SampleGroupTest, GroupsOnlyRequireRawEncoding) {
+    ASSERT_EQ(ums_trace_divided(&temperature, (char*)"temperature", UMS_FLOAT32, 10), UMS_SUCCESS);
+    EXPECT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_INVALID_PARAMETER);
+
+    ums_destroy();
+    ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_CHANGED, 0), UMS_SUCCESS);
+    EXPECT_EQ(ums_trace_divided(&temperature, (char*)"temperature", UMS_FLOAT32, 10), UMS_INVALID_PARAMETER);
+}
+
+TEST_F(SampleGroupTest, SlowGroupOnlyEveryNthTick) {
+    ASSERT_EQ(ums_trace(&current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace_divided(&temperature, (char*)"temperature", UMS_FLOAT32, 4), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace(&speed, (char*)"speed", UMS_INT16), UMS_SUCCESS);
+
+    for (int tick = 0; tick < 8; tick++) {
+        ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    }
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 8u);
+    const uint16_t fast = 1 + sizeof(uint32_t) + sizeof(float) + sizeof(int16_t);
+    for (size_t i = 0; i < g_mock_tx.transfers.size(); i++) {
+        EXPECT_EQ(g_mock_tx.transfers[i].size(), (i % 4 == 0) ? fast + sizeof(float) : fast) << "tick " << i;
+    }
+    EXPECT_EQ(g_mock_tx.stream[0], 0x03);
+    EXPECT_EQ(g_mock_tx.stream[fast + sizeof(float)], 0x01);
+}
+
+TEST_F(SampleGroupTest, TicksWithoutDueGroupEmitNothing) {
+    ASSERT_EQ(ums_trace_divided(&temperature, (char*)"temperature", UMS_FLOAT32, 3), UMS_SUCCESS);
+
+    for (int tick = 0; tick < 6; tick++) {
+        ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    }
+    EXPECT_EQ(g_mock_tx.transfers.size(), 2u);
+}
+
+TEST_F(SampleGroupTest, DecoderHoldsSlowChannels) {
+    ASSERT_EQ(ums_trace(&current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace_divided(&temperature, (char*)"temperature", UMS_FLOAT32, 5), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace(&speed, (char*)"speed", UMS_INT16), UMS_SUCCESS);
+
+    std::vector<float> currents;
+    std::vector<float> temperatures;
+    float held = 0.0f;
+    for (int tick = 0; tick < 12; tick++) {
+        g_mock_timestamp = tick * 10;
+        current = 0.5f * tick;
+        speed = static_cast<int16_t>(-tick);
+        temperature = 20.0f + tick;
+        if (tick % 5 == 0) {
+            held = temperature;
+        }
+        currents.push_back(current);
+        temperatures.push_back(held);
+        ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    }
+
+    FrameDecoder decoder({UMS_FLOAT32, UMS_FLOAT32, UMS_INT16}, UMS_ENCODING_RAW);
+    ASSERT_TRUE(decoder.set_groups({0, 1, 0}));
+    std::vector<Sample> samples;
+    EXPECT_EQ(decoder.decode_stream(g_mock_tx.stream.data(), g_mock_tx.stream.size(), samples), g_mock_tx.stream.size());
+
+    ASSERT_EQ(samples.size(), currents.size());
+    for (size_t i = 0; i < samples.size(); i++) {
+        EXPECT_EQ(samples[i].timestamp, i * 10);
+        EXPECT_EQ(samples[i].groups, (i % 5 == 0) ? 0x03 : 0x01);
+        EXPECT_FLOAT_EQ(decoder.value(samples[i], 0), currents[i]);
+        EXPECT_FLOAT_EQ(decoder.value(samples[i], 1), temperatures[i]);
+        EXPECT_EQ(decoder.value(samples[i], 2), -static_cast<double>(i));
+    }
+    // The wire carries far less than full frames would
+    EXPECT_GT(decoder.stats().compression_ratio(), 1.0);
+}
+
+TEST_F(SampleGroupTest, DecoderRejectsUnknownGroups) {
+    FrameDecoder decoder({UMS_FLOAT32, UMS_UINT8}, UMS_ENCODING_RAW);
+    EXPECT_FALSE(decoder.set_groups({0}));
+    EXPECT_FALSE(decoder.set_groups({0, UMS_MAX_GROUPS}));
+    ASSERT_TRUE(decoder.set_groups({0, 2}));
+
+    const uint8_t frame[] = {0x02, 0, 0, 0, 0, 0xAA};
+    Sample sample;
+    EXPECT_EQ(decoder.decode(frame, sizeof(frame), sample).status, DecodeStatus::invalid);
+}
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+
+#include "mock_platform.h"
+#include "ums/host/handshake.h"
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+using ums::host::DecodeStatus;
+using ums::host::FrameDecoder;
+using ums::host::Handshake;
+using ums::host::Sample;
+
+struct Pose {
+    float x;
+    uint8_t valid;
+    int16_t heading;
+};
+
+static const ums_field_t kPoseFields[] = {
+    {"heading", offsetof(Pose, heading), UMS_INT16},
+    {"x", offsetof(Pose, x), UMS_FLOAT32},
+};
+
+class HandshakeTest : public ::testing::Test {
+protected:
+    float current = 0.0f;
+    uint8_t phases[3] = {};
+    Pose pose = {};
+    int32_t slow = 0;
+
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        g_mock_timestamp = 0;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_destroy();
+    }
+
+    Handshake parse(const std::vector<uint8_t> &packet) {
+        Handshake handshake;
+        const auto result = ums::host::parse_handshake(packet.data(), packet.size(), handshake);
+        EXPECT_EQ(result.status, DecodeStatus::ok);
+        EXPECT_EQ(result.consumed, packet.size());
+        return handshake;
+    }
+};
+
+TEST_F(HandshakeTest, TypeBytePacksTypeAndSize) {
+    EXPECT_EQ(ums_handshake_type_byte(UMS_UINT8), UMS_UINT8);
+    EXPECT_EQ(ums_handshake_type_byte(UMS_INT16), (1u << 6) | UMS_INT16);
+    EXPECT_EQ(ums_handshake_type_byte(UMS_FLOAT32), (2u << 6) | UMS_FLOAT32);
+    EXPECT_EQ(ums_handshake_type_byte(UMS_FLOAT64), (3u << 6) | UMS_FLOAT64);
+    EXPECT_EQ(ums_handshake_type_byte(UMS_STRUCT), UMS_STRUCT);
+}
+
+TEST_F(HandshakeTest, RoundTripsScalarsBlocksAndStructs) {
+    ASSERT_EQ(ums_trace(&current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace_block(phases, (char*)"phase", UMS_UINT8, 3), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace_struct(&pose, (char*)"pose", kPoseFields, 2, sizeof(Pose)), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    const Handshake handshake = parse(g_mock_tx.transfers[0]);
+    EXPECT_EQ(handshake.encoding, UMS_ENCODING_RAW);
+    EXPECT_EQ(handshake.group_dividers, (std::vector<uint16_t>{1}));
+
+    // current, phase[0..2], pose.x, 2 padding bytes after valid's byte... in offset order
+    std::vector<std::string> names;
+    for (const auto &channel : handshake.channels) {
+        names.push_back(channel.name);
+    }
+    const std::vector<std::string> expected = {"current", "phase[0]", "phase[1]", "phase[2]",
+                                               "pose.x", "", "", "pose.heading"};
+    EXPECT_EQ(names, expected);
+    EXPECT_TRUE(handshake.channels[5].padding);
+    EXPECT_EQ(handshake.channels[7].type, UMS_INT16);
+    EXPECT_EQ(ums_handshake_layout_hash(g_mock_tx.transfers[0].data()), handshake.layout_hash);
+}
+
+TEST_F(HandshakeTest, HostDecodesFramesFromHandshakeAlone) {
+    ASSERT_EQ(ums_trace(&current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace_struct(&pose, (char*)"pose", kPoseFields, 2, sizeof(Pose)), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace_divided(&slow, (char*)"slow", UMS_INT32, 2), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+
+    current = 2.5f;
+    pose.x = -1.0f;
+    pose.heading = 900;
+    slow = 77;
+    // The frame waits until the handshake transfer completed
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    ums_transfer_complete_callback();
+    ASSERT_EQ(g_mock_tx.transfers.size(), 2u);
+
+    const Handshake handshake = parse(g_mock_tx.transfers[0]);
+    EXPECT_EQ(handshake.group_dividers, (std::vector<uint16_t>{1, 2}));
+    FrameDecoder decoder = handshake.make_decoder();
+
+    Sample sample;
+    const auto result = decoder.decode(g_mock_tx.transfers[1].data(), g_mock_tx.transfers[1].size(), sample);
+    ASSERT_EQ(result.status, DecodeStatus::ok);
+    EXPECT_DOUBLE_EQ(decoder.value(sample, 0), 2.5);
+    EXPECT_DOUBLE_EQ(decoder.value(sample, 1), -1.0);
+    EXPECT_DOUBLE_EQ(decoder.value(sample, handshake.channels.size() - 2), 900.0);
+    EXPECT_DOUBLE_EQ(decoder.value(sample, handshake.channels.size() - 1), 77.0);
+}
+
+TEST_F(HandshakeTest, HashFollowsLayout) {
+    ASSERT_EQ(ums_trace(&current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+    ums_transfer_complete_callback();
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+    ums_transfer_complete_callback();
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 3u);
+    const uint32_t first = ums_handshake_layout_hash(g_mock_tx.transfers[0].data());
+    EXPECT_EQ(ums_handshake_layout_hash(g_mock_tx.transfers[1].data()), first);
+    EXPECT_NE(ums_handshake_layout_hash(g_mock_tx.transfers[2].data()), first);
+    EXPECT_EQ(parse(g_mock_tx.transfers[2]).encoding, UMS_ENCODING_DELTA);
+}
+
+TEST_F(HandshakeTest, HostRejectsCorruptedPacket) {
+    ASSERT_EQ(ums_trace(&current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+    std::vector<uint8_t> packet = g_mock_tx.transfers[0];
+
+    Handshake handshake;
+    EXPECT_EQ(ums::host::parse_handshake(packet.data(), packet.size() - 1, handshake).status,
+              DecodeStatus::incomplete);
+    packet.back() ^= 0x20;  // last byte of the name
+    EXPECT_EQ(ums::host::parse_handshake(packet.data(), packet.size(), handshake).status, DecodeStatus::invalid);
+}
+
+TEST_F(HandshakeTest, WaitsForBusyLink) {
+    ASSERT_EQ(ums_trace(&current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+    // Frame still on the wire
+    EXPECT_EQ(g_mock_tx.transfers.size(), 1u);
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+
+    // Handshake goes ahead of the pending frame
+    ums_transfer_complete_callback();
+    ASSERT_EQ(g_mock_tx.transfers.size(), 2u);
+    EXPECT_EQ(g_mock_tx.transfers[1][0], UMS_HANDSHAKE_MAGIC_0);
+    EXPECT_EQ(ums_send_handshake(), UMS_BUFFER_FULL);
+
+    ums_transfer_complete_callback();
+    ASSERT_EQ(g_mock_tx.transfers.size(), 3u);
+    EXPECT_EQ(g_mock_tx.transfers[2].size(), sizeof(uint32_t) + sizeof(float));
+}
+
+TEST_F(HandshakeTest, QueueAndBatchWaitForHandshake) {
+    sample_packet_t slots[3] = {};
+    ASSERT_EQ(ums_queue_setup(slots, 3, UMS_DROP_NEWEST), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace(&current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+
+    EXPECT_EQ(ums_update(), UMS_SUCCESS);
+    EXPECT_EQ(g_mock_tx.transfers.size(), 1u);
+    ums_transfer_complete_callback();
+    ASSERT_EQ(g_mock_tx.transfers.size(), 2u);
+    EXPECT_EQ(g_mock_tx.transfers[1].size(), sizeof(uint32_t) + sizeof(float));
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+
+#include "mock_platform.h"
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+class InstrumentationTest : public ::testing::Test {
+protected:
+    int32_t position = 0;
+
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        g_mock_timestamp = 0;
+        g_mock_cycles = 0;
+        g_mock_cycle_step = 10;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&position, (char*)"position", UMS_INT32), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        g_mock_cycle_step = 0;
+        ums_destroy();
+    }
+
+    void tick() {
+        g_mock_timestamp++;
+        position += 1000;
+        ums_update();
+    }
+};
+
+TEST_F(InstrumentationTest, DisabledByDefault) {
+    tick();
+    mock_drain();
+
+    EXPECT_EQ(g_mock_cycles, 0u);
+    ums_instrumentation_t instrumentation;
+    ASSERT_EQ(ums_get_instrumentation(&instrumentation), UMS_SUCCESS);
+    EXPECT_FALSE(instrumentation.enabled);
+    EXPECT_EQ(instrumentation.update.count, 0u);
+    EXPECT_EQ(instrumentation.transfer.count, 0u);
+}
+
+TEST_F(InstrumentationTest, MeasuresUpdateSampleAndTransfer) {
+    ASSERT_EQ(ums_set_instrumentation(true), UMS_SUCCESS);
+    for (int i = 0; i < 3; i++) {
+        tick();
+        mock_drain();
+    }
+
+    // Each read of the mock counter advances it by 10: update start, packing start and end, transfer stamp,
+    // update end, then the completion.
+    ums_instrumentation_t instrumentation;
+    ASSERT_EQ(ums_get_instrumentation(&instrumentation), UMS_SUCCESS);
+    EXPECT_TRUE(instrumentation.enabled);
+    EXPECT_EQ(instrumentation.update.count, 3u);
+    EXPECT_EQ(instrumentation.update.min, 40u);
+    EXPECT_EQ(instrumentation.update.max, 40u);
+    EXPECT_EQ(ums_cycle_stats_mean(&instrumentation.update), 40u);
+    EXPECT_EQ(instrumentation.update.histogram[6], 3u);
+
+    EXPECT_EQ(instrumentation.create_sample.count, 3u);
+    EXPECT_EQ(instrumentation.create_sample.last, 10u);
+    EXPECT_EQ(instrumentation.create_sample.histogram[4], 3u);
+
+    EXPECT_EQ(instrumentation.transfer.count, 3u);
+    EXPECT_EQ(instrumentation.transfer.last, 20u);
+    EXPECT_EQ(instrumentation.transfer.total, 60u);
+}
+
+TEST_F(InstrumentationTest, TransferLatencyIncludesWaiting) {
+    ASSERT_EQ(ums_set_instrumentation(true), UMS_SUCCESS);
+    tick();
+    g_mock_cycles += 1000;      // the link takes its time
+    mock_drain();
+
+    ums_instrumentation_t instrumentation;
+    ASSERT_EQ(ums_get_instrumentation(&instrumentation), UMS_SUCCESS);
+    EXPECT_EQ(instrumentation.transfer.count, 1u);
+    EXPECT_EQ(instrumentation.transfer.last, 1020u);
+    EXPECT_EQ(instrumentation.transfer.histogram[ums_cycle_bucket(1020u)], 1u);
+}
+
+TEST_F(InstrumentationTest, GatheredTransfersAreTimed) {
+    ums_destroy();
+    ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+    ASSERT_EQ(ums_gather_setup(mock_gather), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace(&position, (char*)"position", UMS_INT32), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_instrumentation(true), UMS_SUCCESS);
+    tick();
+    mock_drain();
+
+    ums_instrumentation_t instrumentation;
+    ASSERT_EQ(ums_get_instrumentation(&instrumentation), UMS_SUCCESS);
+    EXPECT_EQ(instrumentation.update.last, 40u);
+    EXPECT_EQ(instrumentation.transfer.count, 1u);
+    EXPECT_EQ(instrumentation.transfer.last, 20u);
+}
+
+TEST_F(InstrumentationTest, EnablingAgainClearsStatistics) {
+    ASSERT_EQ(ums_set_instrumentation(true), UMS_SUCCESS);
+    tick();
+    mock_drain();
+    ASSERT_EQ(ums_set_instrumentation(true), UMS_SUCCESS);
+
+    ums_instrumentation_t instrumentation;
+    ASSERT_EQ(ums_get_instrumentation(&instrumentation), UMS_SUCCESS);
+    EXPECT_EQ(instrumentation.update.count, 0u);
+    EXPECT_EQ(instrumentation.update.min, UINT32_MAX);
+    EXPECT_EQ(instrumentation.transfer.count, 0u);
+
+    // Disabling stops the measurement, a transfer stamped before is not recorded either
+    tick();
+    ASSERT_EQ(ums_set_instrumentation(false), UMS_SUCCESS);
+    mock_drain();
+    ASSERT_EQ(ums_get_instrumentation(&instrumentation), UMS_SUCCESS);
+    EXPECT_EQ(instrumentation.transfer.count, 0u);
+}
+
+TEST_F(InstrumentationTest, TracedAsChannels) {
+    ASSERT_EQ(ums_set_instrumentation(true), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace_instrumentation(), UMS_SUCCESS);
+    tick();
+    mock_drain();
+    tick();
+    mock_drain();
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 2u);
+    const std::vector<uint8_t> &frame = g_mock_tx.transfers[1];
+    ASSERT_EQ(frame.size(), sizeof(uint32_t) + sizeof(int32_t) + 3 * sizeof(uint32_t));
+    uint32_t cycles[3];
+    memcpy(cycles, &frame[8], sizeof(cycles));
+    // Measured on the previous tick
+    EXPECT_EQ(cycles[0], 40u);
+    EXPECT_EQ(cycles[1], 10u);
+    EXPECT_EQ(cycles[2], 20u);
+}
+
+TEST_F(InstrumentationTest, CycleStatsHistogram) {
+    ums_cycle_stats_t stats;
+    ums_cycle_stats_reset(&stats);
+    EXPECT_EQ(ums_cycle_stats_mean(&stats), 0u);
+
+    for (uint32_t cycles : {0u, 1u, 3u, 4u, 1000u, UINT32_MAX}) {
+        ums_cycle_stats_record(&stats, cycles);
+    }
+    EXPECT_EQ(stats.count, 6u);
+    EXPECT_EQ(stats.min, 0u);
+    EXPECT_EQ(stats.max, UINT32_MAX);
+    EXPECT_EQ(stats.total, 1008ull + UINT32_MAX);
+    EXPECT_EQ(ums_cycle_stats_mean(&stats), static_cast<uint32_t>((1008ull + UINT32_MAX) / 6));
+    EXPECT_EQ(stats.histogram[0], 1u);
+    EXPECT_EQ(stats.histogram[1], 1u);
+    EXPECT_EQ(stats.histogram[2], 1u);
+    EXPECT_EQ(stats.histogram[3], 1u);
+    EXPECT_EQ(stats.histogram[10], 1u);
+    EXPECT_EQ(stats.histogram[UMS_CYCLE_HISTOGRAM_BUCKETS - 1], 1u);
+}
+
+TEST_F(InstrumentationTest, RequiresSetup) {
+    ums_instrumentation_t instrumentation;
+    EXPECT_EQ(ums_get_instrumentation(nullptr), UMS_NULL_POINTER);
+    ums_destroy();
+    EXPECT_EQ(ums_set_instrumentation(true), UMS_NOT_INITIALIZED);
+    EXPECT_EQ(ums_get_instrumentation(&instrumentation), UMS_NOT_INITIALIZED);
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+#include <csignal>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+extern "C" {
+#include "ums/platform/posix.h"
+#include "ums/ums_core.h"
+}
+
+// Runs against the real POSIX hooks, so it is built as its own test binary without mock_platform.cpp
+class PosixTest : public ::testing::Test {
+protected:
+    int pipe_fds[2] = {-1, -1};
+    int32_t counter = 0;
+    sample_packet_t slots[UMS_FRAME_QUEUE_MAX_SLOTS] = {};
+
+    void SetUp() override {
+        signal(SIGPIPE, SIG_IGN);
+        ASSERT_EQ(pipe(pipe_fds), 0);
+        ums_destroy();
+        ASSERT_EQ(ums_posix_open(nullptr, pipe_fds[1]), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_posix_close();
+        ums_destroy();
+        for (int fd : pipe_fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    // Everything written so far, the pipe buffer holds the few frames of a test
+    std::vector<uint8_t> read_pipe() {
+        std::vector<uint8_t> bytes;
+        fcntl(pipe_fds[0], F_SETFL, O_NONBLOCK);
+        uint8_t chunk[512];
+        ssize_t n;
+        while ((n = read(pipe_fds[0], chunk, sizeof(chunk))) > 0) {
+            bytes.insert(bytes.end(), chunk, chunk + n);
+        }
+        return bytes;
+    }
+};
+
+TEST_F(PosixTest, QueuedFramesAreWrittenInOrder) {
+    ASSERT_EQ(ums_setup(ums_posix_transmit), UMS_SUCCESS);
+    ASSERT_EQ(ums_queue_setup(slots, UMS_FRAME_QUEUE_MAX_SLOTS, UMS_DROP_NEWEST), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace(&counter, (char*)"counter", UMS_INT32), UMS_SUCCESS);
+    for (int i = 0; i < 20; i++) {
+        counter = i;
+        ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    }
+    ASSERT_EQ(ums_posix_drain(), UMS_SUCCESS);
+
+    ums_link_stats_t link;
+    ASSERT_EQ(ums_get_link_stats(&link), UMS_SUCCESS);
+    EXPECT_EQ(link.transmitted, 20u);
+    ums_posix_stats_t writer;
+    ASSERT_EQ(ums_posix_get_stats(&writer), UMS_SUCCESS);
+    EXPECT_EQ(writer.transfers, 20u);
+    EXPECT_EQ(writer.bytes, 20u * 8u);
+    EXPECT_EQ(writer.write_errors, 0u);
+
+    const std::vector<uint8_t> stream = read_pipe();
+    ASSERT_EQ(stream.size(), 20u * 8u);
+    uint32_t last_timestamp = 0;
+    for (int i = 0; i < 20; i++) {
+        uint32_t timestamp;
+        int32_t value;
+        memcpy(&timestamp, &stream[i * 8], sizeof(timestamp));
+        memcpy(&value, &stream[i * 8 + 4], sizeof(value));
+        EXPECT_EQ(value, i);
+        EXPECT_GE(timestamp, last_timestamp);
+        last_timestamp = timestamp;
+    }
+}
+
+TEST_F(PosixTest, GatheredFrameIsWrittenWhole) {
+    ASSERT_EQ(ums_setup(ums_posix_transmit), UMS_SUCCESS);
+    ASSERT_EQ(ums_gather_setup(ums_posix_gather_transmit), UMS_SUCCESS);
+    int16_t speed = -5;
+    counter = 0x11223344;
+    ASSERT_EQ(ums_trace(&counter, (char*)"counter", UMS_INT32), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace(&speed, (char*)"speed", UMS_INT16), UMS_SUCCESS);
+    ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    ASSERT_EQ(ums_posix_drain(), UMS_SUCCESS);
+
+    const std::vector<uint8_t> stream = read_pipe();
+    ASSERT_EQ(stream.size(), 10u);
+    int32_t value;
+    int16_t speed_value;
+    memcpy(&value, &stream[4], sizeof(value));
+    memcpy(&speed_value, &stream[8], sizeof(speed_value));
+    EXPECT_EQ(value, 0x11223344);
+    EXPECT_EQ(speed_value, -5);
+
+    // The completion released the gather list, the next sample goes out
+    ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    ASSERT_EQ(ums_posix_drain(), UMS_SUCCESS);
+    EXPECT_EQ(read_pipe().size(), 10u);
+}
+
+TEST_F(PosixTest, WriteErrorCompletesTransfer) {
+    close(pipe_fds[0]);
+    pipe_fds[0] = -1;
+    ASSERT_EQ(ums_setup(ums_posix_transmit), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace(&counter, (char*)"counter", UMS_INT32), UMS_SUCCESS);
+    ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    ASSERT_EQ(ums_posix_drain(), UMS_SUCCESS);
+
+    ums_posix_stats_t writer;
+    ASSERT_EQ(ums_posix_get_stats(&writer), UMS_SUCCESS);
+    EXPECT_EQ(writer.transfers, 1u);
+    EXPECT_EQ(writer.write_errors, 1u);
+    ums_link_stats_t link;
+    ASSERT_EQ(ums_get_link_stats(&link), UMS_SUCCESS);
+    EXPECT_EQ(link.transmitted, 1u);
+}
+
+TEST_F(PosixTest, CloseCompletesQueuedTransfers) {
+    ASSERT_EQ(ums_setup(ums_posix_transmit), UMS_SUCCESS);
+    ASSERT_EQ(ums_queue_setup(slots, UMS_FRAME_QUEUE_MAX_SLOTS, UMS_DROP_NEWEST), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace(&counter, (char*)"counter", UMS_INT32), UMS_SUCCESS);
+    for (int i = 0; i < 20; i++) {
+        counter = i;
+        ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    }
+    // Closed while frames are still queued, they are dropped without leaving the link busy
+    ASSERT_EQ(ums_posix_close(), UMS_SUCCESS);
+    read_pipe();
+
+    ASSERT_EQ(ums_posix_open(nullptr, pipe_fds[1]), UMS_SUCCESS);
+    counter = 99;
+    ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    ASSERT_EQ(ums_posix_drain(), UMS_SUCCESS);
+
+    const std::vector<uint8_t> stream = read_pipe();
+    ASSERT_EQ(stream.size(), sizeof(uint32_t) + sizeof(int32_t));
+    int32_t value;
+    memcpy(&value, &stream[sizeof(uint32_t)], sizeof(value));
+    EXPECT_EQ(value, 99);
+}
+
+TEST_F(PosixTest, TimestampCountsMicroseconds) {
+    const uint32_t start = ums_platform_get_timestamp();
+    const timespec pause = {0, 2000000};
+    nanosleep(&pause, nullptr);
+    const uint32_t elapsed = ums_platform_get_timestamp() - start;
+    EXPECT_GE(elapsed, 2000u);
+    EXPECT_LT(elapsed, 1000000u);
+}
+
+TEST_F(PosixTest, CriticalSectionNests) {
+    ums_platform_enter_critical();
+    ums_platform_enter_critical();
+    ums_platform_exit_critical();
+    ums_platform_exit_critical();
+    SUCCEED();
+}
+
+TEST_F(PosixTest, SingleLink) {
+    EXPECT_EQ(ums_posix_open(nullptr, pipe_fds[1]), UMS_INVALID_PARAMETER);
+    ASSERT_EQ(ums_posix_close(), UMS_SUCCESS);
+    EXPECT_EQ(ums_posix_drain(), UMS_NOT_INITIALIZED);
+    EXPECT_EQ(ums_posix_close(), UMS_NOT_INITIALIZED);
+    EXPECT_EQ(ums_posix_open(nullptr, -1), UMS_INVALID_PARAMETER);
+}
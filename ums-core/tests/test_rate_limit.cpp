@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+
+#include "mock_platform.h"
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+class RateLimitTest : public ::testing::Test {
+protected:
+    float currents[4] = {};
+
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        g_mock_timestamp = 0;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+        for (float &current : currents) {
+            ASSERT_EQ(ums_trace(&current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+        }
+    }
+
+    void TearDown() override {
+        ums_destroy();
+    }
+
+    void tick() {
+        g_mock_timestamp++;
+        for (float &current : currents) {
+            current += 0.5f;
+        }
+        ums_update();
+    }
+
+    // The "ums.decimation" channel behind the four currents
+    static uint16_t decimation_of(const std::vector<uint8_t> &transfer) {
+        uint16_t decimation;
+        memcpy(&decimation, &transfer[sizeof(uint32_t) + 4 * sizeof(float)], sizeof(decimation));
+        return decimation;
+    }
+};
+
+TEST_F(RateLimitTest, LinkBudgetCountsWireSize) {
+    uint32_t max_frame_rate = 0;
+    // Timestamp and four floats
+    ASSERT_EQ(ums_link_budget(2000, &max_frame_rate), UMS_SUCCESS);
+    EXPECT_EQ(max_frame_rate, 100u);
+
+    ASSERT_EQ(ums_set_sequence(2), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_crc(UMS_CRC_32), UMS_SUCCESS);
+    ASSERT_EQ(ums_link_budget(2000, &max_frame_rate), UMS_SUCCESS);
+    EXPECT_EQ(max_frame_rate, 2000u / 26u);
+
+    // Delta frames are budgeted at their worst case, never below the raw frame
+    ums_destroy();
+    ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace(&currents[0], (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 10), UMS_SUCCESS);
+    ASSERT_EQ(ums_link_budget(800, &max_frame_rate), UMS_SUCCESS);
+    EXPECT_LE(max_frame_rate, 100u);
+}
+
+TEST_F(RateLimitTest, LinkBudgetNeedsChannels) {
+    uint32_t max_frame_rate = 0;
+    EXPECT_EQ(ums_link_budget(1000, nullptr), UMS_NULL_POINTER);
+    ums_destroy();
+    EXPECT_EQ(ums_link_budget(1000, &max_frame_rate), UMS_NOT_INITIALIZED);
+    ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+    EXPECT_EQ(ums_link_budget(1000, &max_frame_rate), UMS_RANGE_ERROR);
+}
+
+TEST_F(RateLimitTest, DecimatesToFitBudget) {
+    // 22 byte frames (decimation channel included) at 1000 updates/s need 22000 bytes/s, 5500 allow every 4th
+    ASSERT_EQ(ums_set_rate_limit(5500, 1000), UMS_SUCCESS);
+    uint16_t factor = 0;
+    ASSERT_EQ(ums_get_decimation(&factor), UMS_SUCCESS);
+    EXPECT_EQ(factor, 4u);
+
+    for (int i = 0; i < 20; i++) {
+        tick();
+        mock_drain();
+    }
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 5u);
+    for (const auto &transfer : g_mock_tx.transfers) {
+        ASSERT_EQ(transfer.size(), 22u);
+        EXPECT_EQ(decimation_of(transfer), 4u);
+    }
+    ums_link_stats_t stats;
+    ASSERT_EQ(ums_get_link_stats(&stats), UMS_SUCCESS);
+    EXPECT_EQ(stats.captured, 5u);
+    EXPECT_EQ(stats.dropped, 0u);
+    // The 4th update of every group captures, with the values of that update
+    uint32_t timestamp;
+    memcpy(&timestamp, g_mock_tx.transfers[1].data(), sizeof(timestamp));
+    EXPECT_EQ(timestamp, 8u);
+}
+
+TEST_F(RateLimitTest, AggregatesCoverSkippedUpdates) {
+    ums_destroy();
+    ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+    ASSERT_EQ(ums_trace_aggregated(&currents[0], (char*)"current_max", UMS_FLOAT32, 1, UMS_AGGREGATE_MAX),
+              UMS_SUCCESS);
+    // 10 byte frames at 1000 updates/s, every 4th fits into 2500 bytes/s
+    ASSERT_EQ(ums_set_rate_limit(2500, 1000), UMS_SUCCESS);
+
+    const float trace[] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 9.0f, 1.0f, 1.0f};
+    for (float value : trace) {
+        currents[0] = value;
+        ums_update();
+        mock_drain();
+    }
+
+    // The spike on a skipped update is reported by the frame standing for it
+    ASSERT_EQ(g_mock_tx.transfers.size(), 2u);
+    float max;
+    memcpy(&max, &g_mock_tx.transfers[0][sizeof(uint32_t)], sizeof(max));
+    EXPECT_FLOAT_EQ(max, 1.0f);
+    memcpy(&max, &g_mock_tx.transfers[1][sizeof(uint32_t)], sizeof(max));
+    EXPECT_FLOAT_EQ(max, 9.0f);
+}
+
+TEST_F(RateLimitTest, BacksOffWhenDroppedAnyway) {
+    // The budget allows every update, but the link is slower than declared
+    ASSERT_EQ(ums_set_rate_limit(1000000, 1000), UMS_SUCCESS);
+    for (int i = 0; i < 6; i++) {
+        tick();
+    }
+    uint16_t factor = 0;
+    ASSERT_EQ(ums_get_decimation(&factor), UMS_SUCCESS);
+    EXPECT_GT(factor, 1u);
+
+    // Once the link keeps up, the factor recovers step by step
+    for (int i = 0; i < 64 * 8 * 4; i++) {
+        mock_drain();
+        tick();
+    }
+    mock_drain();
+    ASSERT_EQ(ums_get_decimation(&factor), UMS_SUCCESS);
+    EXPECT_EQ(factor, 1u);
+
+    // Every frame reports the updates since the previous capture, so they add up to all updates until the last one
+    uint32_t updates = 0;
+    for (const auto &transfer : g_mock_tx.transfers) {
+        updates += decimation_of(transfer);
+    }
+    uint32_t last_timestamp;
+    memcpy(&last_timestamp, g_mock_tx.transfers.back().data(), sizeof(last_timestamp));
+    ums_link_stats_t stats;
+    ASSERT_EQ(ums_get_link_stats(&stats), UMS_SUCCESS);
+    EXPECT_LT(stats.dropped, 6u);
+    EXPECT_LE(updates, last_timestamp);
+}
+
+TEST_F(RateLimitTest, DisablingCapturesEveryUpdate) {
+    ASSERT_EQ(ums_set_rate_limit(0, 0), UMS_SUCCESS);
+    tick();
+    mock_drain();
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    EXPECT_EQ(g_mock_tx.transfers[0].size(), sizeof(uint32_t) + 4 * sizeof(float));
+
+    ASSERT_EQ(ums_set_rate_limit(100, 1000), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_rate_limit(0, 0), UMS_SUCCESS);
+    tick();
+    mock_drain();
+    ASSERT_EQ(g_mock_tx.transfers.size(), 2u);
+    EXPECT_EQ(decimation_of(g_mock_tx.transfers[1]), 1u);
+    uint16_t factor = 0;
+    ASSERT_EQ(ums_get_decimation(&factor), UMS_SUCCESS);
+    EXPECT_EQ(factor, 1u);
+}
+
+TEST_F(RateLimitTest, RejectsZeroUpdateRate) {
+    EXPECT_EQ(ums_set_rate_limit(1000, 0), UMS_INVALID_PARAMETER);
+    EXPECT_EQ(ums_get_decimation(nullptr), UMS_NULL_POINTER);
+    ums_destroy();
+    EXPECT_EQ(ums_set_rate_limit(1000, 1000), UMS_NOT_INITIALIZED);
+}
@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+
+#include "mock_platform.h"
+#include "ums/host/handshake.h"
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+using ums::host::DecodeStatus;
+using ums::host::FrameDecoder;
+using ums::host::Handshake;
+using ums::host::Sample;
+
+class ResyncTest : public ::testing::Test {
+protected:
+    int32_t position = 0;
+    int16_t velocity = 0;
+
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        g_mock_timestamp = 0;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&position, (char*)"position", UMS_INT32), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&velocity, (char*)"velocity", UMS_INT16), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_destroy();
+    }
+
+    void run(int frames) {
+        for (int i = 0; i < frames; i++) {
+            g_mock_timestamp++;
+            position += 1000;
+            velocity = static_cast<int16_t>(-i);
+            ums_update();
+            mock_drain();
+        }
+    }
+
+    static bool has_marker(const std::vector<uint8_t> &transfer) {
+        return transfer.size() > UMS_SYNC_MARKER_SIZE && transfer[0] == UMS_SYNC_MAGIC_0
+               && transfer[1] == UMS_SYNC_MAGIC_1;
+    }
+};
+
+TEST_F(ResyncTest, MarkerEveryNthFrame) {
+    ASSERT_EQ(ums_set_resync(3, 0), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+    mock_drain();
+    run(7);
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 8u);
+    const uint32_t hash = ums_handshake_layout_hash(g_mock_tx.transfers[0].data());
+    const size_t frame_size = sizeof(uint32_t) + sizeof(int32_t) + sizeof(int16_t);
+    for (size_t i = 1; i < g_mock_tx.transfers.size(); i++) {
+        const auto &transfer = g_mock_tx.transfers[i];
+        const bool marker = ((i - 1) % 3) == 0;
+        EXPECT_EQ(has_marker(transfer), marker) << "frame " << i - 1;
+        EXPECT_EQ(transfer.size(), frame_size + (marker ? UMS_SYNC_MARKER_SIZE : 0));
+        if (marker) {
+            uint32_t marker_hash;
+            memcpy(&marker_hash, &transfer[2], sizeof(marker_hash));
+            EXPECT_EQ(marker_hash, hash);
+        }
+    }
+}
+
+TEST_F(ResyncTest, ReplacedMarkerFrameHandsMarkerOn) {
+    ASSERT_EQ(ums_set_resync(2, 0), UMS_SUCCESS);
+
+    ums_update();   // marker, on the wire
+    ums_update();   // pending
+    ums_update();   // marker, replaces the pending frame
+    ums_update();   // replaces the marker frame, takes the marker over
+    mock_drain();
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 2u);
+    EXPECT_TRUE(has_marker(g_mock_tx.transfers[0]));
+    EXPECT_TRUE(has_marker(g_mock_tx.transfers[1]));
+}
+
+TEST_F(ResyncTest, FrameBehindMarkerIsKeyframe) {
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_resync(4, 0), UMS_SUCCESS);
+    run(9);
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 9u);
+    for (size_t i = 0; i < g_mock_tx.transfers.size(); i++) {
+        const auto &transfer = g_mock_tx.transfers[i];
+        const bool marker = (i % 4) == 0;
+        ASSERT_EQ(has_marker(transfer), marker) << "frame " << i;
+        const uint8_t tag = transfer[marker ? UMS_SYNC_MARKER_SIZE : 0];
+        EXPECT_EQ((tag & UMS_FRAME_TAG_KEYFRAME) != 0, marker) << "frame " << i;
+    }
+}
+
+TEST_F(ResyncTest, HandshakeIsResentPeriodically) {
+    ASSERT_EQ(ums_set_resync(0, 5), UMS_SUCCESS);
+    run(12);
+
+    size_t handshakes = 0;
+    for (const auto &transfer : g_mock_tx.transfers) {
+        handshakes += (transfer[0] == UMS_HANDSHAKE_MAGIC_0 && transfer[1] == UMS_HANDSHAKE_MAGIC_1) ? 1u : 0u;
+    }
+    // Built at timestamp 0, due again at 5 and 10
+    EXPECT_EQ(handshakes, 2u);
+    EXPECT_EQ(g_mock_tx.transfers.size(), 14u);
+}
+
+TEST_F(ResyncTest, PendingHandshakeOvertakesBackToBackFrames) {
+    sample_packet_t slots[4] = {};
+    ASSERT_EQ(ums_queue_setup(slots, 4, UMS_DROP_NEWEST), UMS_SUCCESS);
+    ums_update();
+    ums_update();
+    ums_update();
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+    mock_drain();
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 4u);
+    EXPECT_EQ(g_mock_tx.transfers[1][0], UMS_HANDSHAKE_MAGIC_0);
+    ums_queue_stats_t stats;
+    ASSERT_EQ(ums_queue_get_stats(&stats), UMS_SUCCESS);
+    EXPECT_EQ(stats.transmitted, 3u);
+}
+
+TEST_F(ResyncTest, HostAttachesMidStream) {
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_resync(4, 10), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+    mock_drain();
+    run(40);
+
+    // Join in the middle of the first few frames, the initial handshake is lost
+    const std::vector<uint8_t> &stream = g_mock_tx.stream;
+    const size_t join = g_mock_tx.transfers[0].size() + 7u;
+    Handshake handshake;
+    const size_t offset = ums::host::find_handshake(stream.data() + join, stream.size() - join, handshake);
+    ASSERT_LT(offset, stream.size() - join);
+
+    FrameDecoder decoder = handshake.make_decoder();
+    std::vector<Sample> samples;
+    const size_t start = join + offset + handshake.length;
+    const size_t consumed = decoder.decode_stream(stream.data() + start, stream.size() - start, samples);
+    EXPECT_EQ(start + consumed, stream.size());
+
+    // Frames between the handshake and the next marker are deltas without a reference
+    ASSERT_FALSE(samples.empty());
+    const Sample &last = samples.back();
+    EXPECT_EQ(last.timestamp, 40u);
+    EXPECT_DOUBLE_EQ(decoder.value(last, 0), 40000.0);
+    EXPECT_DOUBLE_EQ(decoder.value(last, 1), -39.0);
+    EXPECT_GT(decoder.stats().sync_markers, 0u);
+    EXPECT_GT(decoder.stats().sync_bytes, decoder.stats().sync_markers * UMS_SYNC_MARKER_SIZE);
+}
+
+TEST_F(ResyncTest, DecoderRecoversAtNextMarker) {
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_resync(4, 0), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+    mock_drain();
+    run(12);
+
+    std::vector<uint8_t> stream = g_mock_tx.stream;
+    // Tag of the second frame, no valid tag has bit 7 set
+    const size_t corrupt = g_mock_tx.transfers[0].size() + g_mock_tx.transfers[1].size();
+    stream[corrupt] = 0x80;
+
+    Handshake handshake;
+    ASSERT_EQ(ums::host::parse_handshake(stream.data(), stream.size(), handshake).status, DecodeStatus::ok);
+    FrameDecoder decoder = handshake.make_decoder();
+    std::vector<Sample> samples;
+    const size_t consumed = decoder.decode_stream(stream.data() + handshake.length, stream.size() - handshake.length,
+                                                  samples);
+
+    EXPECT_EQ(handshake.length + consumed, stream.size());
+    EXPECT_EQ(decoder.stats().errors, 1u);
+    // Frame 0 before the damage, frames 4..11 from the next marker on
+    ASSERT_EQ(samples.size(), 9u);
+    EXPECT_EQ(samples[1].timestamp, 5u);
+    EXPECT_DOUBLE_EQ(decoder.value(samples.back(), 0), 12000.0);
+}
+
+TEST_F(ResyncTest, GatherSendsMarkerElement) {
+    ASSERT_EQ(ums_gather_setup(mock_gather), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_resync(2, 0), UMS_SUCCESS);
+    run(3);
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 3u);
+    EXPECT_TRUE(has_marker(g_mock_tx.transfers[0]));
+    EXPECT_FALSE(has_marker(g_mock_tx.transfers[1]));
+    EXPECT_TRUE(has_marker(g_mock_tx.transfers[2]));
+
+    int32_t sent_position;
+    memcpy(&sent_position, &g_mock_tx.transfers[2][UMS_SYNC_MARKER_SIZE + sizeof(uint32_t)], sizeof(sent_position));
+    EXPECT_EQ(sent_position, position);
+}
+
+TEST_F(ResyncTest, MarkersNeedScopeRingSizedForThem) {
+    uint8_t buffer[1024] = {};
+    ASSERT_EQ(ums_scope_setup(buffer, sizeof(buffer), 4), UMS_SUCCESS);
+    EXPECT_EQ(ums_set_resync(8, 0), UMS_INVALID_PARAMETER);
+    EXPECT_EQ(ums_set_resync(0, 100), UMS_SUCCESS);
+}
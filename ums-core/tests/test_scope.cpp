@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+
+#include "mock_platform.h"
+
+extern "C" {
+#include "ums/scope_ring.h"
+#include "ums/ums_core.h"
+}
+
+// Records one uint32 "frame" per value
+static void record(ums_scope_ring_t &ring, uint32_t value, bool *frozen = nullptr) {
+    uint8_t *slot = ums_scope_ring_reserve(&ring);
+    ASSERT_NE(slot, nullptr);
+    memcpy(slot, &value, sizeof(value));
+    const bool froze = ums_scope_ring_commit(&ring, sizeof(value));
+    if (frozen) {
+        *frozen = froze;
+    }
+}
+
+static std::vector<uint32_t> drain(ums_scope_ring_t &ring) {
+    std::vector<uint32_t> values;
+    uint16_t length = 0;
+    while (uint8_t *frame = ums_scope_ring_next(&ring, &length)) {
+        EXPECT_EQ(length, sizeof(uint32_t));
+        uint32_t value;
+        memcpy(&value, frame, sizeof(value));
+        values.push_back(value);
+    }
+    return values;
+}
+
+TEST(ScopeRingTest, WindowHoldsPreAndPostTriggerFrames) {
+    uint8_t buffer[8 * (UMS_SCOPE_SLOT_HEADER + sizeof(uint32_t))];
+    ums_scope_ring_t ring;
+    ASSERT_EQ(ums_scope_ring_init(&ring, buffer, sizeof(buffer), sizeof(uint32_t), 3), UMS_SUCCESS);
+    EXPECT_EQ(ring.slot_count, 8u);
+
+    for (uint32_t i = 0; i < 20; i++) {
+        record(ring, i);
+    }
+    ums_scope_ring_trigger(&ring);
+    EXPECT_EQ(ring.state, UMS_SCOPE_TRIGGERED);
+
+    bool frozen = false;
+    record(ring, 20, &frozen);
+    EXPECT_FALSE(frozen);
+    record(ring, 21, &frozen);
+    record(ring, 22, &frozen);
+    EXPECT_TRUE(frozen);
+    EXPECT_EQ(ring.state, UMS_SCOPE_FROZEN);
+    EXPECT_EQ(ums_scope_ring_reserve(&ring), nullptr);
+
+    // 5 pre-trigger + 3 post-trigger frames, oldest first
+    EXPECT_EQ(drain(ring), (std::vector<uint32_t>{15, 16, 17, 18, 19, 20, 21, 22}));
+    EXPECT_EQ(ring.state, UMS_SCOPE_DONE);
+}
+
+TEST(ScopeRingTest, EarlyTriggerDrainsPartialWindow) {
+    uint8_t buffer[8 * (UMS_SCOPE_SLOT_HEADER + sizeof(uint32_t))];
+    ums_scope_ring_t ring;
+    ASSERT_EQ(ums_scope_ring_init(&ring, buffer, sizeof(buffer), sizeof(uint32_t), 0), UMS_SUCCESS);
+
+    record(ring, 1);
+    record(ring, 2);
+    ums_scope_ring_trigger(&ring);
+    EXPECT_EQ(ring.state, UMS_SCOPE_FROZEN);
+    EXPECT_EQ(drain(ring), (std::vector<uint32_t>{1, 2}));
+
+    // Triggers are ignored until armed again
+    ums_scope_ring_trigger(&ring);
+    EXPECT_EQ(ring.state, UMS_SCOPE_DONE);
+    ums_scope_ring_arm(&ring);
+    EXPECT_EQ(ring.state, UMS_SCOPE_ARMED);
+    EXPECT_EQ(ring.filled, 0u);
+}
+
+TEST(ScopeRingTest, RejectsInvalidSizes) {
+    uint8_t buffer[64];
+    ums_scope_ring_t ring;
+    EXPECT_EQ(ums_scope_ring_init(&ring, nullptr, sizeof(buffer), 4, 0), UMS_NULL_POINTER);
+    EXPECT_EQ(ums_scope_ring_init(&ring, buffer, sizeof(buffer), 0, 0), UMS_RANGE_ERROR);
+    EXPECT_EQ(ums_scope_ring_init(&ring, buffer, sizeof(buffer), 40, 0), UMS_RANGE_ERROR);
+    // 10 slots of 6 bytes, post-trigger must leave room for history
+    EXPECT_EQ(ums_scope_ring_init(&ring, buffer, sizeof(buffer), 4, 10), UMS_RANGE_ERROR);
+    EXPECT_EQ(ums_scope_ring_init(&ring, buffer, sizeof(buffer), 4, 9), UMS_SUCCESS);
+}
+
+class ScopeCaptureTest : public ::testing::Test {
+protected:
+    uint16_t value = 0;
+    uint8_t buffer[16 * (UMS_SCOPE_SLOT_HEADER + sizeof(uint32_t) + sizeof(uint16_t))];
+
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        g_mock_tx.complete_immediately = true;
+        g_mock_timestamp = 0;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&value, (char*)"value", UMS_UINT16), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_destroy();
+    }
+
+    void tick(uint16_t v) {
+        value = v;
+        g_mock_timestamp = v;
+        ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    }
+};
+
+TEST_F(ScopeCaptureTest, RecordsWithoutTransmittingUntilTriggered) {
+    ASSERT_EQ(ums_scope_setup(buffer, sizeof(buffer), 4), UMS_SUCCESS);
+    EXPECT_EQ(ums_scope_get_state(), UMS_SCOPE_ARMED);
+
+    for (uint16_t i = 0; i < 100; i++) {
+        tick(i);
+    }
+    EXPECT_TRUE(g_mock_tx.transfers.empty());
+
+    ASSERT_EQ(ums_scope_trigger(), UMS_SUCCESS);
+    for (uint16_t i = 100; i < 104; i++) {
+        tick(i);
+    }
+
+    // Drained back-to-back through the completion callback, in the streamed frame format
+    ASSERT_EQ(g_mock_tx.transfers.size(), 16u);
+    EXPECT_EQ(ums_scope_get_state(), UMS_SCOPE_DONE);
+    for (size_t i = 0; i < g_mock_tx.transfers.size(); i++) {
+        ASSERT_EQ(g_mock_tx.transfers[i].size(), sizeof(uint32_t) + sizeof(uint16_t));
+        uint32_t timestamp;
+        uint16_t v;
+        memcpy(&timestamp, g_mock_tx.transfers[i].data(), sizeof(timestamp));
+        memcpy(&v, &g_mock_tx.transfers[i][sizeof(uint32_t)], sizeof(v));
+        EXPECT_EQ(timestamp, 88 + i);
+        EXPECT_EQ(v, 88 + i);
+    }
+
+    // Nothing is recorded until re-armed
+    tick(200);
+    EXPECT_EQ(g_mock_tx.transfers.size(), 16u);
+    EXPECT_EQ(ums_scope_arm(), UMS_SUCCESS);
+    EXPECT_EQ(ums_scope_get_state(), UMS_SCOPE_ARMED);
+}
+
+TEST_F(ScopeCaptureTest, CannotRearmWhileDraining) {
+    g_mock_tx.complete_immediately = false;
+    ASSERT_EQ(ums_scope_setup(buffer, sizeof(buffer), 1), UMS_SUCCESS);
+
+    tick(1);
+    ASSERT_EQ(ums_scope_trigger(), UMS_SUCCESS);
+    tick(2);
+    ASSERT_EQ(g_mock_tx.transfers.size(), 1u);
+    EXPECT_EQ(ums_scope_get_state(), UMS_SCOPE_DRAINING);
+    EXPECT_EQ(ums_scope_arm(), UMS_BUFFER_FULL);
+
+    ums_transfer_complete_callback();
+    ums_transfer_complete_callback();
+    EXPECT_EQ(g_mock_tx.transfers.size(), 2u);
+    EXPECT_EQ(ums_scope_get_state(), UMS_SCOPE_DONE);
+    EXPECT_EQ(ums_scope_arm(), UMS_SUCCESS);
+}
+
+TEST_F(ScopeCaptureTest, TriggerWithoutPostFramesDrainsOnNextUpdate) {
+    ASSERT_EQ(ums_scope_setup(buffer, sizeof(buffer), 0), UMS_SUCCESS);
+    tick(1);
+    tick(2);
+    ASSERT_EQ(ums_scope_trigger(), UMS_SUCCESS);
+    EXPECT_EQ(ums_scope_get_state(), UMS_SCOPE_FROZEN);
+    EXPECT_TRUE(g_mock_tx.transfers.empty());
+
+    tick(3);
+    EXPECT_EQ(g_mock_tx.transfers.size(), 2u);
+}
+
+TEST_F(ScopeCaptureTest, RejectsIncompatibleConfiguration) {
+    EXPECT_EQ(ums_scope_trigger(), UMS_NOT_INITIALIZED);
+    EXPECT_EQ(ums_scope_get_state(), UMS_SCOPE_IDLE);
+
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_DELTA, 0), UMS_SUCCESS);
+    EXPECT_EQ(ums_scope_setup(buffer, sizeof(buffer), 4), UMS_INVALID_PARAMETER);
+    ASSERT_EQ(ums_set_encoding(UMS_ENCODING_RAW, 0), UMS_SUCCESS);
+
+    ASSERT_EQ(ums_scope_setup(buffer, sizeof(buffer), 4), UMS_SUCCESS);
+    EXPECT_EQ(ums_set_encoding(UMS_ENCODING_CHANGED, 0), UMS_INVALID_PARAMETER);
+    static uint8_t late = 0;
+    EXPECT_EQ(ums_trace(&late, (char*)"late", UMS_UINT8), UMS_INVALID_PARAMETER);
+}
+
+TEST_F(ScopeCaptureTest, FramesNotInTheWindowCountAsDropped) {
+    ASSERT_EQ(ums_scope_setup(buffer, sizeof(buffer), 4), UMS_SUCCESS);
+    for (uint16_t i = 0; i < 100; i++) {
+        tick(i);
+    }
+    ASSERT_EQ(ums_scope_trigger(), UMS_SUCCESS);
+    for (uint16_t i = 100; i < 104; i++) {
+        tick(i);
+    }
+    // Ignored, the window was already sent
+    tick(104);
+
+    ums_link_stats_t stats;
+    ASSERT_EQ(ums_get_link_stats(&stats), UMS_SUCCESS);
+    EXPECT_EQ(stats.captured, 105u);
+    EXPECT_EQ(stats.transmitted, 16u);
+    EXPECT_EQ(stats.dropped, 89u);
+
+    // Re-arming a recorded but never drained window discards it
+    ASSERT_EQ(ums_scope_arm(), UMS_SUCCESS);
+    for (uint16_t i = 0; i < 3; i++) {
+        tick(i);
+    }
+    ASSERT_EQ(ums_scope_arm(), UMS_SUCCESS);
+    ASSERT_EQ(ums_get_link_stats(&stats), UMS_SUCCESS);
+    EXPECT_EQ(stats.captured, 108u);
+    EXPECT_EQ(stats.dropped, 92u);
+}
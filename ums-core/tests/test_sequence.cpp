@@ -0,0 +1,250 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstring>
+
+#include "mock_platform.h"
+#include "ums/host/handshake.h"
+
+extern "C" {
+#include "ums/ums_core.h"
+}
+
+using ums::host::DecodeStatus;
+using ums::host::FrameDecoder;
+using ums::host::Handshake;
+using ums::host::Sample;
+
+class SequenceTest : public ::testing::Test {
+protected:
+    int32_t position = 0;
+    int16_t velocity = 0;
+
+    void SetUp() override {
+        g_mock_tx = MockTransmissionData();
+        g_mock_timestamp = 0;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_transmit), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&position, (char*)"position", UMS_INT32), UMS_SUCCESS);
+        ASSERT_EQ(ums_trace(&velocity, (char*)"velocity", UMS_INT16), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_destroy();
+    }
+
+    void tick() {
+        g_mock_timestamp++;
+        position += 1000;
+        velocity--;
+        ums_update();
+    }
+
+    static uint16_t sequence_of(const std::vector<uint8_t> &transfer) {
+        uint16_t sequence;
+        memcpy(&sequence, transfer.data(), sizeof(sequence));
+        return sequence;
+    }
+};
+
+TEST_F(SequenceTest, FramesAreNumbered) {
+    ASSERT_EQ(ums_set_sequence(2), UMS_SUCCESS);
+    for (int i = 0; i < 5; i++) {
+        tick();
+        mock_drain();
+    }
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 5u);
+    const size_t frame_size = sizeof(uint16_t) + sizeof(uint32_t) + sizeof(int32_t) + sizeof(int16_t);
+    for (size_t i = 0; i < g_mock_tx.transfers.size(); i++) {
+        EXPECT_EQ(g_mock_tx.transfers[i].size(), frame_size);
+        EXPECT_EQ(sequence_of(g_mock_tx.transfers[i]), i);
+    }
+
+    ums_link_stats_t stats;
+    ASSERT_EQ(ums_get_link_stats(&stats), UMS_SUCCESS);
+    EXPECT_EQ(stats.captured, 5u);
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stats.transmitted, 5u);
+}
+
+TEST_F(SequenceTest, ReplacedFramesShowUpAsGaps) {
+    ASSERT_EQ(ums_set_sequence(1), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+    mock_drain();
+
+    tick();     // 0 on the wire
+    tick();     // 1 pending
+    tick();     // 2 replaces 1
+    tick();     // 3 replaces 2
+    mock_drain();    // 0, 3
+    tick();     // 4
+    mock_drain();
+
+    ums_link_stats_t stats;
+    ASSERT_EQ(ums_get_link_stats(&stats), UMS_SUCCESS);
+    EXPECT_EQ(stats.captured, 5u);
+    EXPECT_EQ(stats.dropped, 2u);
+    EXPECT_EQ(stats.transmitted, 3u);
+
+    Handshake handshake;
+    ASSERT_EQ(ums::host::parse_handshake(g_mock_tx.stream.data(), g_mock_tx.stream.size(), handshake).status,
+              DecodeStatus::ok);
+    EXPECT_EQ(handshake.sequence_size, 1u);
+    FrameDecoder decoder = handshake.make_decoder();
+    std::vector<Sample> samples;
+    decoder.decode_stream(g_mock_tx.stream.data() + handshake.length,
+                          g_mock_tx.stream.size() - handshake.length, samples);
+
+    ASSERT_EQ(samples.size(), 3u);
+    EXPECT_EQ(samples[1].sequence, 3u);
+    EXPECT_DOUBLE_EQ(decoder.value(samples[1], 0), 4000.0);
+    EXPECT_EQ(decoder.stats().lost, 2u);
+    EXPECT_EQ(decoder.stats().gaps, 1u);
+    EXPECT_EQ(decoder.stats().max_gap, 2u);
+    EXPECT_DOUBLE_EQ(decoder.stats().loss_ratio(), 0.4);
+}
+
+TEST_F(SequenceTest, ShortSequenceWrapsAround) {
+    ASSERT_EQ(ums_set_sequence(1), UMS_SUCCESS);
+    for (int i = 0; i < 300; i++) {
+        tick();
+        mock_drain();
+    }
+
+    FrameDecoder decoder({UMS_INT32, UMS_INT16}, UMS_ENCODING_RAW);
+    ASSERT_TRUE(decoder.set_sequence(1));
+    std::vector<Sample> samples;
+    EXPECT_EQ(decoder.decode_stream(g_mock_tx.stream.data(), g_mock_tx.stream.size(), samples),
+              g_mock_tx.stream.size());
+    ASSERT_EQ(samples.size(), 300u);
+    EXPECT_EQ(samples.back().sequence, 299u & 0xFFu);
+    EXPECT_EQ(decoder.stats().lost, 0u);
+}
+
+TEST_F(SequenceTest, QueueOverflowIsCountedAsDropped) {
+    sample_packet_t slots[2] = {};
+    ASSERT_EQ(ums_queue_setup(slots, 2, UMS_DROP_NEWEST), UMS_SUCCESS);
+    for (int i = 0; i < 5; i++) {
+        tick();
+    }
+    mock_drain();
+
+    ums_link_stats_t stats;
+    ASSERT_EQ(ums_get_link_stats(&stats), UMS_SUCCESS);
+    EXPECT_EQ(stats.captured, 5u);
+    EXPECT_EQ(stats.dropped + stats.transmitted, stats.captured);
+    ums_queue_stats_t queue;
+    ASSERT_EQ(ums_queue_get_stats(&queue), UMS_SUCCESS);
+    EXPECT_EQ(stats.dropped, queue.dropped);
+}
+
+TEST_F(SequenceTest, DropOldestEvictionsAreCounted) {
+    sample_packet_t slots[2] = {};
+    ASSERT_EQ(ums_queue_setup(slots, 2, UMS_DROP_OLDEST), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_sequence(2), UMS_SUCCESS);
+    for (int i = 0; i < 6; i++) {
+        tick();
+    }
+    mock_drain();
+
+    ums_link_stats_t stats;
+    ASSERT_EQ(ums_get_link_stats(&stats), UMS_SUCCESS);
+    EXPECT_GT(stats.dropped, 0u);
+    EXPECT_EQ(stats.dropped + stats.transmitted, stats.captured);
+    // The newest frames survive
+    EXPECT_EQ(sequence_of(g_mock_tx.transfers.back()), 5u);
+}
+
+TEST_F(SequenceTest, BatchCountsFramesNotTransfers) {
+    uint8_t buffer[2 * UMS_MAX_WIRE_FRAME_SIZE] = {};
+    ASSERT_EQ(ums_batch_setup(buffer, sizeof(buffer), 4, 0), UMS_SUCCESS);
+    for (int i = 0; i < 8; i++) {
+        tick();
+    }
+    mock_drain();
+
+    ums_link_stats_t stats;
+    ASSERT_EQ(ums_get_link_stats(&stats), UMS_SUCCESS);
+    EXPECT_EQ(g_mock_tx.transfers.size(), 2u);
+    EXPECT_EQ(stats.transmitted, 8u);
+    EXPECT_EQ(stats.dropped, 0u);
+}
+
+TEST_F(SequenceTest, HandshakeIsNotCountedAsTransmitted) {
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+    mock_drain();
+    tick();
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);   // waits for the frame on the wire
+    mock_drain();
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 3u);
+    ums_link_stats_t stats;
+    ASSERT_EQ(ums_get_link_stats(&stats), UMS_SUCCESS);
+    EXPECT_EQ(stats.transmitted, 1u);
+}
+
+TEST_F(SequenceTest, LinkStatsAreTracedAsChannels) {
+    ASSERT_EQ(ums_trace_link_stats(), UMS_SUCCESS);
+    ASSERT_EQ(ums_send_handshake(), UMS_SUCCESS);
+    mock_drain();
+    for (int i = 0; i < 3; i++) {
+        tick();
+        mock_drain();
+    }
+
+    Handshake handshake;
+    ASSERT_EQ(ums::host::parse_handshake(g_mock_tx.stream.data(), g_mock_tx.stream.size(), handshake).status,
+              DecodeStatus::ok);
+    ASSERT_EQ(handshake.channels.size(), 5u);
+    EXPECT_EQ(handshake.channels[2].name, "ums.captured");
+    EXPECT_EQ(handshake.channels[3].name, "ums.dropped");
+    EXPECT_EQ(handshake.channels[4].name, "ums.transmitted");
+
+    FrameDecoder decoder = handshake.make_decoder();
+    std::vector<Sample> samples;
+    decoder.decode_stream(g_mock_tx.stream.data() + handshake.length,
+                          g_mock_tx.stream.size() - handshake.length, samples);
+    ASSERT_EQ(samples.size(), 3u);
+    EXPECT_DOUBLE_EQ(decoder.value(samples[2], 2), 3.0);
+    EXPECT_DOUBLE_EQ(decoder.value(samples[2], 3), 0.0);
+    EXPECT_DOUBLE_EQ(decoder.value(samples[2], 4), 2.0);
+}
+
+TEST_F(SequenceTest, GatherSendsSequenceElement) {
+    ASSERT_EQ(ums_gather_setup(mock_gather), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_sequence(2), UMS_SUCCESS);
+    ASSERT_EQ(ums_set_resync(2, 0), UMS_SUCCESS);
+    for (int i = 0; i < 3; i++) {
+        tick();
+        mock_drain();
+    }
+
+    ASSERT_EQ(g_mock_tx.transfers.size(), 3u);
+    uint32_t hash;
+    memcpy(&hash, &g_mock_tx.transfers[0][2], sizeof(hash));
+    FrameDecoder decoder({UMS_INT32, UMS_INT16}, UMS_ENCODING_RAW);
+    decoder.set_sync(hash, 0);
+    ASSERT_TRUE(decoder.set_sequence(2));
+    std::vector<Sample> samples;
+    EXPECT_EQ(decoder.decode_stream(g_mock_tx.stream.data(), g_mock_tx.stream.size(), samples),
+              g_mock_tx.stream.size());
+
+    // Marker, sequence number, timestamp, payload
+    ASSERT_EQ(samples.size(), 3u);
+    EXPECT_EQ(decoder.stats().sync_markers, 2u);
+    for (size_t i = 0; i < samples.size(); i++) {
+        EXPECT_EQ(samples[i].sequence, i);
+        EXPECT_EQ(samples[i].timestamp, i + 1);
+    }
+    EXPECT_DOUBLE_EQ(decoder.value(samples[2], 0), 3000.0);
+}
+
+TEST_F(SequenceTest, RejectsInvalidSizes) {
+    EXPECT_EQ(ums_set_sequence(3), UMS_INVALID_PARAMETER);
+    EXPECT_EQ(ums_get_link_stats(nullptr), UMS_NULL_POINTER);
+
+    uint8_t buffer[1024] = {};
+    ASSERT_EQ(ums_scope_setup(buffer, sizeof(buffer), 4), UMS_SUCCESS);
+    EXPECT_EQ(ums_set_sequence(1), UMS_INVALID_PARAMETER);
+    EXPECT_EQ(ums_set_sequence(0), UMS_SUCCESS);
+}
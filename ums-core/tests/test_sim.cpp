@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include "ums/sim/link_sim.h"
+
+using ums::sim::LinkModel;
+using ums::sim::SimConfig;
+using ums::sim::SimResult;
+
+// Runs on the virtual clock of ums::sim, so it is built as its own test binary without mock_platform.cpp
+
+TEST(SimTest, UartModelCountsLineBits) {
+    const LinkModel link = LinkModel::uart(115200, 20.0);
+    EXPECT_DOUBLE_EQ(link.bytes_per_second, 11520.0);
+    EXPECT_DOUBLE_EQ(link.transfer_overhead_us, 20.0);
+    EXPECT_DOUBLE_EQ(LinkModel::uart(1000000, 0.0, 8).bytes_per_second, 125000.0);
+}
+
+TEST(SimTest, FastLinkLosesNothing) {
+    SimConfig config;
+    config.link = LinkModel::uart(1000000, 10.0);   // 100 kB/s
+    config.channels = 4;                            // 20 byte frames
+    SimResult result;
+    ASSERT_TRUE(ums::sim::simulate(config, result));
+
+    EXPECT_EQ(result.updates, 1000u);
+    EXPECT_EQ(result.link.captured, 1000u);
+    EXPECT_EQ(result.link.dropped, 0u);
+    EXPECT_EQ(result.link.transmitted, 1000u);
+    EXPECT_DOUBLE_EQ(result.frame_bytes(), 20.0);
+    EXPECT_DOUBLE_EQ(result.achieved_rate_hz, 1000.0);
+    EXPECT_DOUBLE_EQ(result.drop_ratio, 0.0);
+    EXPECT_NEAR(result.link_utilisation, 0.21, 1e-9);
+    // Sent right at capture: overhead plus 200 us on the wire
+    EXPECT_EQ(result.latency.count, 1000u);
+    EXPECT_DOUBLE_EQ(result.latency.min_us, 210.0);
+    EXPECT_DOUBLE_EQ(result.latency.max_us, 210.0);
+}
+
+TEST(SimTest, SlowLinkDropsTheExcess) {
+    SimConfig config;
+    config.link = LinkModel::uart(115200);
+    config.channels = UMS_MAX_CHANNELS;
+    SimResult result;
+    ASSERT_TRUE(ums::sim::simulate(config, result));
+
+    // The link is saturated: every transfer starts when the previous one completes
+    const double frame_bytes = sizeof(uint32_t) + UMS_MAX_CHANNELS * sizeof(float);
+    EXPECT_DOUBLE_EQ(result.frame_bytes(), frame_bytes);
+    EXPECT_NEAR(result.achieved_rate_hz, 11520.0 / frame_bytes, 2.0);
+    EXPECT_GT(result.link_utilisation, 0.99);
+    EXPECT_EQ(result.link.captured, result.updates);
+    EXPECT_NEAR(result.drop_ratio, 1.0 - result.achieved_rate_hz / 1000.0, 0.01);
+    // Latest value wins: a frame waits for at most one transfer before its own
+    EXPECT_LE(result.latency.max_us, 2.0 * frame_bytes / 11520.0 * 1e6 + 1.0);
+}
+
+TEST(SimTest, QueueTradesLatencyForNothing) {
+    SimConfig config;
+    config.link = LinkModel::uart(115200);
+    config.channels = UMS_MAX_CHANNELS;
+    SimResult triple;
+    ASSERT_TRUE(ums::sim::simulate(config, triple));
+    config.queue_slots = 8;
+    SimResult queued;
+    ASSERT_TRUE(ums::sim::simulate(config, queued));
+
+    // Same throughput on a saturated link, the queued frames are older when they arrive
+    EXPECT_NEAR(queued.achieved_rate_hz, triple.achieved_rate_hz, 2.0);
+    EXPECT_GT(queued.latency.p50_us, 4.0 * triple.latency.p50_us);
+}
+
+TEST(SimTest, FramingAndTrailerCountOnTheWire) {
+    SimConfig config;
+    config.link = LinkModel::uart(2000000);
+    config.channels = 4;
+    config.framing = UMS_FRAMING_COBS;
+    config.crc = UMS_CRC_32;
+    config.sequence_size = 2;
+    SimResult result;
+    ASSERT_TRUE(ums::sim::simulate(config, result));
+
+    EXPECT_EQ(result.link.dropped, 0u);
+    // Sequence, timestamp, payload, CRC, COBS code byte and delimiter
+    EXPECT_GE(result.frame_bytes(), 2.0 + 4.0 + 16.0 + 4.0 + 2.0);
+    EXPECT_EQ(result.latency.count, result.link.transmitted);
+    EXPECT_NEAR(result.latency.p50_us, result.frame_bytes() / 200000.0 * 1e6, 1.0);
+}
+
+TEST(SimTest, Deterministic) {
+    SimConfig config;
+    config.link = LinkModel::uart(230400, 15.0);
+    config.channels = 7;
+    config.update_rate_hz = 3333.0;
+    SimResult first;
+    SimResult second;
+    ASSERT_TRUE(ums::sim::simulate(config, first));
+    ASSERT_TRUE(ums::sim::simulate(config, second));
+
+    EXPECT_EQ(first.link.transmitted, second.link.transmitted);
+    EXPECT_EQ(first.link.dropped, second.link.dropped);
+    EXPECT_EQ(first.wire_bytes, second.wire_bytes);
+    EXPECT_DOUBLE_EQ(first.latency.p99_us, second.latency.p99_us);
+}
+
+TEST(SimTest, RejectsInvalidConfigurations) {
+    SimConfig config;
+    SimResult result;
+    config.channels = 0;
+    EXPECT_FALSE(ums::sim::simulate(config, result));
+    config.channels = UMS_MAX_CHANNELS + 1;
+    EXPECT_FALSE(ums::sim::simulate(config, result));
+    config.channels = 4;
+    config.update_rate_hz = 0.0;
+    EXPECT_FALSE(ums::sim::simulate(config, result));
+}
+
+TEST(SimTest, RateLimitAvoidsDrops) {
+    SimConfig config;
+    config.link = LinkModel::uart(115200);
+    config.channels = UMS_MAX_CHANNELS - 1;
+    SimResult unlimited;
+    ASSERT_TRUE(ums::sim::simulate(config, unlimited));
+    config.rate_limit = true;
+    SimResult limited;
+    ASSERT_TRUE(ums::sim::simulate(config, limited));
+
+    EXPECT_GT(unlimited.drop_ratio, 0.5);
+    EXPECT_EQ(limited.link.dropped, 0u);
+    // 66 byte frames take 5.7 ms at 11520 bytes/s, so every 6th update is captured
+    EXPECT_DOUBLE_EQ(limited.frame_bytes(), 66.0);
+    EXPECT_NEAR(limited.achieved_rate_hz, 1000.0 / 6.0, 2.0);
+    EXPECT_LT(limited.link_utilisation, 1.0);
+}
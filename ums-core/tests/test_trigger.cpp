@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+extern "C" {
+#include "ums/trigger.h"
+#include "ums/ums_core.h"
+}
+
+class TriggerTest : public ::testing::Test {
+protected:
+    float current = 0.0f;
+    int16_t speed = 0;
+    uint8_t fault = 0;
+    data_channel_t channels[3] = {
+        {&current, UMS_FLOAT32, (char*)"current", 0, 1, sizeof(float), nullptr},
+        {&speed, UMS_INT16, (char*)"speed", 0, 1, sizeof(int16_t), nullptr},
+        {&fault, UMS_UINT8, (char*)"fault", 0, 1, sizeof(uint8_t), nullptr},
+    };
+    ums_trigger_t trigger{};
+
+    void compile(std::vector<ums_trigger_condition_t> conditions, uint16_t hold_off = 0) {
+        ASSERT_EQ(ums_trigger_compile(&trigger, conditions.data(), static_cast<uint8_t>(conditions.size()),
+                                      channels, 3, hold_off), UMS_SUCCESS);
+    }
+};
+
+TEST_F(TriggerTest, LevelConditions) {
+    compile({{0, UMS_TRIGGER_ABOVE, UMS_TRIGGER_AND, 10.0, 0.0}});
+    current = 10.0f;
+    EXPECT_FALSE(ums_trigger_evaluate(&trigger));
+    current = 10.5f;
+    EXPECT_TRUE(ums_trigger_evaluate(&trigger));
+
+    compile({{1, UMS_TRIGGER_BELOW, UMS_TRIGGER_AND, -100.0, 0.0}});
+    speed = -101;
+    EXPECT_TRUE(ums_trigger_evaluate(&trigger));
+    speed = -100;
+    EXPECT_FALSE(ums_trigger_evaluate(&trigger));
+}
+
+TEST_F(TriggerTest, EdgesFireOnceAndNotOnArm) {
+    fault = 1;
+    compile({{2, UMS_TRIGGER_RISING, UMS_TRIGGER_AND, 0.0, 0.0}});
+    EXPECT_FALSE(ums_trigger_evaluate(&trigger));
+
+    fault = 0;
+    EXPECT_FALSE(ums_trigger_evaluate(&trigger));
+    fault = 1;
+    EXPECT_TRUE(ums_trigger_evaluate(&trigger));
+    EXPECT_FALSE(ums_trigger_evaluate(&trigger));
+
+    compile({{1, UMS_TRIGGER_FALLING, UMS_TRIGGER_AND, 0.0, 0.0}});
+    speed = -5;
+    EXPECT_TRUE(ums_trigger_evaluate(&trigger));
+    speed = -6;
+    EXPECT_FALSE(ums_trigger_evaluate(&trigger));
+}
+
+TEST_F(TriggerTest, WindowConditions) {
+    compile({{0, UMS_TRIGGER_OUTSIDE, UMS_TRIGGER_AND, -1.0, 1.0}});
+    current = 0.5f;
+    EXPECT_FALSE(ums_trigger_evaluate(&trigger));
+    current = -1.5f;
+    EXPECT_TRUE(ums_trigger_evaluate(&trigger));
+
+    compile({{1, UMS_TRIGGER_INSIDE, UMS_TRIGGER_AND, 10.0, 20.0}});
+    speed = 20;
+    EXPECT_TRUE(ums_trigger_evaluate(&trigger));
+    speed = 21;
+    EXPECT_FALSE(ums_trigger_evaluate(&trigger));
+}
+
+TEST_F(TriggerTest, CombinesLeftToRight) {
+    // (fault OR current > 5) AND speed > 0
+    compile({{2, UMS_TRIGGER_ABOVE, UMS_TRIGGER_AND, 0.0, 0.0},
+             {0, UMS_TRIGGER_ABOVE, UMS_TRIGGER_OR, 5.0, 0.0},
+             {1, UMS_TRIGGER_ABOVE, UMS_TRIGGER_AND, 0.0, 0.0}});
+    speed = 1;
+    EXPECT_FALSE(ums_trigger_evaluate(&trigger));
+    current = 6.0f;
+    EXPECT_TRUE(ums_trigger_evaluate(&trigger));
+    speed = 0;
+    EXPECT_FALSE(ums_trigger_evaluate(&trigger));
+    fault = 1;
+    speed = 3;
+    current = 0.0f;
+    EXPECT_TRUE(ums_trigger_evaluate(&trigger));
+}
+
+TEST_F(TriggerTest, HoldOffKeepsGateOpen) {
+    compile({{2, UMS_TRIGGER_ABOVE, UMS_TRIGGER_AND, 0.0, 0.0}}, 2);
+    EXPECT_FALSE(ums_trigger_gate(&trigger));
+    fault = 1;
+    EXPECT_TRUE(ums_trigger_gate(&trigger));
+    fault = 0;
+    EXPECT_TRUE(ums_trigger_gate(&trigger));
+    EXPECT_TRUE(ums_trigger_gate(&trigger));
+    EXPECT_FALSE(ums_trigger_gate(&trigger));
+}
+
+TEST_F(TriggerTest, RejectsInvalidConditions) {
+    ums_trigger_condition_t condition{3, UMS_TRIGGER_ABOVE, UMS_TRIGGER_AND, 0.0, 0.0};
+    EXPECT_EQ(ums_trigger_compile(&trigger, &condition, 1, channels, 3, 0), UMS_RANGE_ERROR);
+    condition = {0, 9, UMS_TRIGGER_AND, 0.0, 0.0};
+    EXPECT_EQ(ums_trigger_compile(&trigger, &condition, 1, channels, 3, 0), UMS_INVALID_PARAMETER);
+    EXPECT_EQ(ums_trigger_compile(&trigger, &condition, 0, channels, 3, 0), UMS_RANGE_ERROR);
+    EXPECT_EQ(ums_trigger_compile(&trigger, nullptr, 1, channels, 3, 0), UMS_NULL_POINTER);
+}
+
+TEST_F(TriggerTest, RejectsNonFiniteThresholds) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    // Every domain: float, signed and unsigned channel
+    for (uint8_t channel = 0; channel < 3; channel++) {
+        for (double threshold : {nan, inf, -inf}) {
+            ums_trigger_condition_t condition{channel, UMS_TRIGGER_ABOVE, UMS_TRIGGER_AND, threshold, 0.0};
+            EXPECT_EQ(ums_trigger_compile(&trigger, &condition, 1, channels, 3, 0), UMS_INVALID_PARAMETER);
+            condition = {channel, UMS_TRIGGER_INSIDE, UMS_TRIGGER_AND, 0.0, threshold};
+            EXPECT_EQ(ums_trigger_compile(&trigger, &condition, 1, channels, 3, 0), UMS_INVALID_PARAMETER);
+        }
+    }
+
+    // Finite thresholds beyond the integer range are clamped
+    compile({{1, UMS_TRIGGER_ABOVE, UMS_TRIGGER_AND, -1e300, 0.0},
+             {2, UMS_TRIGGER_BELOW, UMS_TRIGGER_AND, 1e300, 0.0}});
+    EXPECT_TRUE(ums_trigger_evaluate(&trigger));
+}
+
+static int g_trigger_transmits = 0;
+
+static void mock_trigger_transmit(void *, uint16_t) {
+    g_trigger_transmits++;
+    ums_transfer_complete_callback();
+}
+
+class TriggerGateTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        g_trigger_transmits = 0;
+        ums_destroy();
+        ASSERT_EQ(ums_setup(mock_trigger_transmit), UMS_SUCCESS);
+    }
+
+    void TearDown() override {
+        ums_destroy();
+    }
+};
+
+TEST_F(TriggerGateTest, StreamsOnlyWhileConditionHolds) {
+    static float current = 0.0f;
+    ASSERT_EQ(ums_trace(&current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    const ums_trigger_condition_t condition{0, UMS_TRIGGER_ABOVE, UMS_TRIGGER_AND, 3.0, 0.0};
+    ASSERT_EQ(ums_trigger_setup(&condition, 1, 1), UMS_SUCCESS);
+
+    const float trace[] = {0, 1, 4, 5, 1, 1, 1, 6, 0, 0};
+    for (float value : trace) {
+        current = value;
+        ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    }
+    // 4, 5 + one held, 6 + one held
+    EXPECT_EQ(g_trigger_transmits, 5);
+
+    ASSERT_EQ(ums_trigger_setup(nullptr, 0, 0), UMS_SUCCESS);
+    ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    EXPECT_EQ(g_trigger_transmits, 6);
+}
+
+TEST_F(TriggerGateTest, FailedRearmKeepsArmedTrigger) {
+    static float current = 0.0f;
+    ASSERT_EQ(ums_trace(&current, (char*)"current", UMS_FLOAT32), UMS_SUCCESS);
+    const ums_trigger_condition_t condition{0, UMS_TRIGGER_ABOVE, UMS_TRIGGER_AND, 3.0, 0.0};
+    ASSERT_EQ(ums_trigger_setup(&condition, 1, 0), UMS_SUCCESS);
+
+    const ums_trigger_condition_t bad_channel{5, UMS_TRIGGER_ABOVE, UMS_TRIGGER_AND, 0.0, 0.0};
+    EXPECT_EQ(ums_trigger_setup(&bad_channel, 1, 0), UMS_RANGE_ERROR);
+    const ums_trigger_condition_t nan_threshold{0, UMS_TRIGGER_BELOW, UMS_TRIGGER_AND, NAN, 0.0};
+    EXPECT_EQ(ums_trigger_setup(&nan_threshold, 1, 0), UMS_INVALID_PARAMETER);
+
+    // Still gated on current > 3
+    current = 1.0f;
+    ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    EXPECT_EQ(g_trigger_transmits, 0);
+    current = 4.0f;
+    ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    EXPECT_EQ(g_trigger_transmits, 1);
+}
+
+TEST_F(TriggerGateTest, TriggersDeepCapture) {
+    static uint8_t fault = 0;
+    static uint8_t buffer[8 * (UMS_SCOPE_SLOT_HEADER + sizeof(uint32_t) + 1)];
+    ASSERT_EQ(ums_trace(&fault, (char*)"fault", UMS_UINT8), UMS_SUCCESS);
+    ASSERT_EQ(ums_scope_setup(buffer, sizeof(buffer), 2), UMS_SUCCESS);
+    const ums_trigger_condition_t condition{0, UMS_TRIGGER_RISING, UMS_TRIGGER_AND, 0.0, 0.0};
+    ASSERT_EQ(ums_trigger_setup(&condition, 1, 0), UMS_SUCCESS);
+
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    }
+    EXPECT_EQ(ums_scope_get_state(), UMS_SCOPE_ARMED);
+
+    fault = 1;
+    ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    EXPECT_EQ(ums_scope_get_state(), UMS_SCOPE_TRIGGERED);
+    ASSERT_EQ(ums_update(), UMS_SUCCESS);
+    EXPECT_EQ(ums_scope_get_state(), UMS_SCOPE_DONE);
+    EXPECT_EQ(g_trigger_transmits, 8);
+}